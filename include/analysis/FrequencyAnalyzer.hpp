@@ -9,6 +9,8 @@
 #include <vector>
 
 #include "core/LogEntry.hpp"
+#include "core/Span.hpp"
+#include "core/StateCodec.hpp"
 #include "utils/TimeUtils.hpp"
 
 namespace LogTool
@@ -49,13 +51,17 @@ namespace LogTool
             // Correct type: core::LogEntry
             void addEntry(const core::LogEntry &entry);
 
+            // Add a batch of entries under a single lock acquisition.
+            void addBatch(core::Span<const core::LogEntry> entries);
+
             FrequencyStats getStats() const;
             std::vector<std::string> detectAnomalies() const;
 
             void reset();
 
-            std::size_t messageHashLength() const noexcept { return m_messageHashLength; }
-            void setMessageHashLength(std::size_t length) noexcept;
+            // Checkpoint state: all counters and histories (configuration is not included).
+            void saveState(core::StateWriter &out) const;
+            void loadState(core::StateReader &in);
 
             double spikeMultiplier() const noexcept { return m_spikeMultiplier; }
             void setSpikeMultiplier(double multiplier) noexcept;
@@ -64,24 +70,25 @@ namespace LogTool
             void setMinOccurrences(std::size_t count) noexcept;
 
         private:
-            std::string hashMessage(const std::string &message) const;
+            /// Report name of a template ("EMPTY" for empty messages).
+            static std::string templateName(core::TemplateId id);
 
             // Correct type: core::LogEntry
             void updateUnlocked(const core::LogEntry &entry);
 
-            void updateMovingAverage(const std::string &source);
+            void updateMovingAverage(core::SourceId source);
 
         private:
             mutable std::mutex m_mutex;
 
-            std::unordered_map<std::string, std::size_t> m_sourceCounts;
+            // Per-source state, indexed by core::SourceId (slot 0: entries without a source)
+            std::vector<std::size_t> m_sourceCounts;
             std::unordered_map<core::LogLevel, std::size_t, LogLevelHash> m_levelCounts;
-            std::unordered_map<std::string, std::size_t> m_messageCounts;
+            std::vector<std::size_t> m_templateCounts; // by core::TemplateId (see TemplateMiner)
 
-            std::unordered_map<std::string, std::vector<std::size_t>> m_sourceHistory;
-            std::unordered_map<std::string, double> m_sourceMovingAvg;
+            std::vector<std::vector<std::size_t>> m_sourceHistory;
+            std::vector<double> m_sourceMovingAvg;
 
-            std::size_t m_messageHashLength = 3;
             double m_spikeMultiplier = 3.0;
             std::size_t m_minOccurrences = 2;
         };
@@ -1,11 +1,18 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <unordered_map>
 #include <deque>
 #include <mutex>
+#include <optional>
 #include <string>
 #include "core/LogEntry.hpp"
+#include "core/Span.hpp"
+#include "core/StateCodec.hpp"
+#include "utils/CountMinSketch.hpp"
+#include "utils/FifoTable.hpp"
+#include "utils/SpaceSaving.hpp"
 #include "utils/TimeUtils.hpp"
 
 namespace LogTool
@@ -25,7 +32,34 @@ namespace LogTool
          *  - Uses n-gram style analysis for message sequences
          *  - Maintains sliding window of recent events for pattern detection
          *  - Thread-safe for concurrent log processing
-         *  - Efficient hash-based pattern storage
+         *  - An event is its (source, level, message template) triple (see
+         *    TemplateMiner); its 64-bit fingerprint mixes the three IDs once,
+         *    when it enters the window. A new event only updates the n-grams
+         *    ending at it (O(W) per entry), keyed by a hash chained over the
+         *    fingerprints. Events are interned (one small ID per distinct
+         *    triple) and a pattern keeps the IDs of its events; its signature
+         *    string ("source:level:template->...") is only built for results.
+         *  - Frequencies are window-weighted: an n-gram of length L counts
+         *    once for every window position that contains it (W - L + 1),
+         *    credited when it completes. The part not yet earned by events
+         *    still in the window is subtracted when results are read.
+         *  - Memory is bounded by maxPatterns(), in two tables. Full-window
+         *    n-grams (weight 1) seen once are the rare-pattern candidates; they
+         *    wait in a table of their own and age out oldest first, so a flood
+         *    of one-off sequences cannot push each other out by count. Their
+         *    second sighting moves them to a Space-Saving heavy-hitter table,
+         *    which holds every other n-gram (exact until it fills up, then the
+         *    rarest one makes room).
+         *  - Counts are exact until the first eviction or ageing. From then on
+         *    repeated and aged-out n-grams are also counted in a count-min
+         *    sketch of 2 * maxPatterns() counters a row, seeded from the table
+         *    counts when it is created; inputs that fit never allocate it.
+         *  - Rare-pattern results are exact until then. Afterwards an unknown
+         *    full-window n-gram is only a new candidate if the sketch has never
+         *    counted it, so results never include a repeated pattern; sketch
+         *    collisions may hide a few new ones.
+         *  - Examples are entry IDs (position of the entry in the analysed
+         *    stream, i.e. its row in entries.csv), not copies of the entries.
          */
         class PatternAnalyzer
         {
@@ -34,7 +68,7 @@ namespace LogTool
             {
                 std::string signature;        // Hashed pattern identifier
                 std::size_t frequency = 0;    // How often this pattern occurs
-                std::vector<core::LogEntry> examples;  // Sample instances
+                std::vector<std::uint64_t> exampleIds;  // Sample instances (entry IDs, latest last)
                 Utils::TimePoint firstSeen;
                 Utils::TimePoint lastSeen;
             };
@@ -48,6 +82,9 @@ namespace LogTool
                 std::vector<Pattern> suspiciousPatterns;  // Low frequency, high severity
             };
 
+            /// Default bound on the patterns tracked individually
+            static constexpr std::size_t kDefaultMaxPatterns = 1u << 20;
+
             /// Default: 10-event sliding window for sequence analysis
             PatternAnalyzer();
 
@@ -64,6 +101,12 @@ namespace LogTool
              */
             void addEntry(const core::LogEntry& entry);
 
+            /**
+             * Add a batch of entries in order under a single lock acquisition.
+             * Thread-safe.
+             */
+            void addBatch(core::Span<const core::LogEntry> entries);
+
             /**
              * Get comprehensive pattern analysis statistics.
              * Thread-safe read access.
@@ -83,6 +126,14 @@ namespace LogTool
              */
             void reset();
 
+            /**
+             * Write / restore the event window and pattern tables (for checkpoints).
+             * Configuration is not part of the state.
+             * Thread-safe.
+             */
+            void saveState(core::StateWriter& out) const;
+            void loadState(core::StateReader& in);
+
             // Configuration
             std::size_t sequenceWindowSize() const noexcept { return m_sequenceWindowSize; }
             void setSequenceWindowSize(std::size_t size) noexcept;
@@ -90,36 +141,93 @@ namespace LogTool
             std::size_t maxPatternExamples() const noexcept { return m_maxPatternExamples; }
             void setMaxPatternExamples(std::size_t count) noexcept;
 
+            /// Patterns tracked individually, per table (rare candidates, heavy hitters).
+            /// Set it before adding entries.
+            std::size_t maxPatterns() const noexcept { return m_patterns.capacity(); }
+            void setMaxPatterns(std::size_t count);
+
             Utils::seconds patternTimeout() const noexcept { return m_patternTimeout; }
             void setPatternTimeout(Utils::seconds timeout) noexcept;
 
         private:
-            /// Compact event signature for pattern matching (source+level+first_words)
-            struct EventSignature
+            /// Distinct (source, level, template) triple, by interned event ID
+            struct EventInfo
             {
-                std::string source;
-                core::LogLevel level;  // Use core::LogLevel (correct namespace)
-                std::string messagePrefix;  // First 3 words of message
+                core::SourceId sourceId = core::kNoSource;
+                core::LogLevel level = core::LogLevel::Unknown;
+                core::TemplateId templateId = core::kNoTemplate;
+            };
 
-                bool operator==(const EventSignature& other) const;
-                struct Hash;
+            /// Window event with the fingerprint and interned ID of its triple
+            struct WindowEvent
+            {
+                core::LogEntry entry;
+                std::uint64_t fingerprint = 0;
+                std::uint32_t eventId = 0;
             };
 
-            /// Sequence of N consecutive events (n-gram)
-            using EventSequence = std::vector<EventSignature>;
+            /// Value of a tracked pattern (its count is kept by the store)
+            struct TrackedPattern
+            {
+                std::vector<std::uint32_t> events; // event IDs, oldest first
+                std::vector<std::uint64_t> exampleIds;
+                Utils::TimePoint firstSeen;
+                Utils::TimePoint lastSeen;
+            };
 
-            /// Extract signature from LogEntry (hashable identifier)
-            EventSignature createSignature(const core::LogEntry& entry) const;
+            /// Full-window n-gram seen once so far
+            struct RarePattern
+            {
+                std::vector<std::uint32_t> events;
+                std::uint64_t exampleId = 0;
+                Utils::TimePoint seen;
+            };
+
+            using PatternStore = Utils::SpaceSaving<std::uint64_t, TrackedPattern>;
+            using RareStore = Utils::FifoTable<std::uint64_t, RarePattern>;
+
+            /// Window/pattern update for one entry; caller holds m_mutex
+            void addEntryUnlocked(const core::LogEntry& entry);
+
+            /// Fingerprint and event ID of an entry (interns its triple); caller holds m_mutex
+            WindowEvent createEventUnlocked(const core::LogEntry& entry);
+
+            /// Intern a triple; caller holds m_mutex
+            std::uint32_t internUnlocked(const EventInfo& info);
+
+            /// Key of an n-gram from its event IDs (checkpoints); caller holds m_mutex
+            std::uint64_t keyOfUnlocked(const std::vector<std::uint32_t>& events) const;
+
+            /// Event IDs of the n-gram m_recentEvents[first..back]
+            std::vector<std::uint32_t> windowEvents(std::size_t first) const;
 
-            /// Create unique identifier for event sequence
-            std::string sequenceToSignature(const EventSequence& sequence) const;
+            /// "source:level:template" of every event, template text cut to 20 chars; caller holds m_mutex
+            std::vector<std::string> eventTextsUnlocked() const;
 
-            /// Update pattern frequency and examples under lock
-            void updatePatternUnlocked(const EventSequence& sequence, 
-                                     const core::LogEntry& latestEntry);
+            /// "src:lvl:template->src:lvl:template->..." of a pattern, from eventTextsUnlocked()
+            static std::string signature(const std::vector<std::uint32_t>& events,
+                                         const std::vector<std::string>& texts);
+
+            /// Create the sketch from the heavy-hitter counts (first eviction or ageing); caller holds m_mutex
+            void createSketchUnlocked();
+
+            /// Sketch width for a table capacity
+            static std::size_t sketchWidth(std::size_t maxPatterns) noexcept { return 2 * maxPatterns; }
+
+            /// Key of an n-gram extended by one event at its front
+            static std::uint64_t extendKey(std::uint64_t key, std::uint64_t fingerprint) noexcept;
+
+            /// Credit the n-gram m_recentEvents[first..back] (key 'key') with 'weight' occurrences
+            void updatePatternUnlocked(std::uint64_t key, std::size_t first, std::size_t weight,
+                                       const core::LogEntry& latestEntry);
+
+            /// Weight credited to n-grams in the window but not earned yet, by key; caller holds m_mutex
+            std::unordered_map<std::uint64_t, std::size_t> pendingWeightsUnlocked() const;
+
+            /// Upper bound of a tracked pattern's frequency; caller holds m_mutex
+            std::uint64_t frequencyUnlocked(const PatternStore::Slot& slot,
+                                            const std::unordered_map<std::uint64_t, std::size_t>& pending) const;
 
-            /// Check if sequence represents an error chain
-            bool isErrorChain(const EventSequence& sequence) const;
             bool isErrorChainFromSignature(const std::string& sig) const;
 
             /// Check if pattern is high severity
@@ -129,11 +237,17 @@ namespace LogTool
             mutable std::mutex m_mutex;
 
             // Recent events for sequence analysis (sliding window)
-            std::deque<core::LogEntry> m_recentEvents;
+            std::deque<WindowEvent> m_recentEvents;
+
+            // Interned events: triples by ID, and IDs by fingerprint
+            std::vector<EventInfo> m_events;
+            std::unordered_map<std::uint64_t, std::uint32_t> m_eventIds;
 
-            // Pattern frequency tracking
-            std::unordered_map<std::string, Pattern> m_patterns;
-            std::unordered_map<std::string, std::size_t> m_sequenceCounts;
+            // Pattern frequency tracking, by n-gram key (see extendKey())
+            PatternStore m_patterns{kDefaultMaxPatterns};
+            RareStore m_rare{kDefaultMaxPatterns};                   // full-window n-grams seen once
+            std::optional<Utils::CountMinSketch> m_sketch;           // repeated n-grams, once needed
+            std::uint64_t m_entryCount = 0;     // ID of the next entry
 
             // Configuration parameters
             std::size_t m_sequenceWindowSize = 10;        // Analyze 10-event sequences
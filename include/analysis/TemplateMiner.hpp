@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "core/EntryBatch.hpp"
+#include "core/LogEntry.hpp"
+#include "core/StateCodec.hpp"
+
+namespace LogTool
+{
+    namespace Analysis
+    {
+        /**
+         * TemplateMiner
+         *
+         * Responsibilities:
+         *  - Group messages into templates ("Connection from <*> closed") with a
+         *    fixed-depth parse tree in the style of Drain (He et al., ICWS 2017),
+         *    and give every template a dense, stable ID (core::TemplateId).
+         *  - Extract the variable tokens of a message (its template's wildcards).
+         *  - One process-wide miner (global()) is shared by the frequency and
+         *    pattern analyzers and the burst detector, so they all agree on what
+         *    "the same message" is.
+         *
+         * Design notes:
+         *  - Messages are split on whitespace (the tokens of the batch's
+         *    core::Enrichment in assign()); tokens containing a digit
+         *    (numbers, addresses, IDs, durations) are variables from the start.
+         *  - Tree: token count -> first (depth - 2) tokens -> leaf with a list of
+         *    templates. A node with maxChildren children sends further new tokens
+         *    to its "<*>" child. A message is only compared with the templates
+         *    of its leaf, so mining is O(depth) lookups plus a short scan.
+         *  - In the leaf, the most similar template wins if at least 'similarity'
+         *    of the compared tokens are equal (positions variable on both sides
+         *    are not compared); the positions that differ become wildcards.
+         *    Otherwise the message starts a new template.
+         *  - IDs are 1, 2, 3, ... in creation order and never change, but a
+         *    template can gain wildcards later: read text() at report time.
+         *  - Templates depend on the order messages arrive in. The run mines on
+         *    one thread in file order (assign(), before the detectors see a
+         *    batch) and checkpoints the miner, so IDs are reproducible.
+         *  - Thread-safe: mining takes an exclusive lock, lookups a shared one.
+         */
+        class TemplateMiner
+        {
+        public:
+            static constexpr std::size_t kDefaultDepth       = 4;
+            static constexpr std::size_t kDefaultMaxChildren = 100;
+            static constexpr double      kDefaultSimilarity  = 0.7;
+
+            /// Token standing for a variable in template text.
+            static constexpr std::string_view kWildcard = "<*>";
+
+            explicit TemplateMiner(std::size_t depth = kDefaultDepth,
+                                   double similarity = kDefaultSimilarity,
+                                   std::size_t maxChildren = kDefaultMaxChildren);
+
+            TemplateMiner(const TemplateMiner&)            = delete;
+            TemplateMiner& operator=(const TemplateMiner&) = delete;
+
+            /// The miner shared by the ingest loop, analyzers and detectors.
+            static TemplateMiner& global();
+
+            /// Template ID of 'message', creating or widening a template as needed.
+            core::TemplateId add(std::string_view message);
+
+            /// Mine every entry of 'batch' that has no template ID yet, in order
+            /// (enriches the batch first and reuses its tokens).
+            void assign(core::EntryBatch& batch);
+
+            /// The entry's template ID; entries that skipped assign() are mined now.
+            core::TemplateId idOf(const core::LogEntry& entry);
+
+            /// Template text, tokens joined by single spaces ("" for unknown IDs).
+            std::string text(core::TemplateId id) const;
+
+            /// Tokens of 'message' at the wildcard positions of template 'id'.
+            std::vector<std::string_view> variables(core::TemplateId id, std::string_view message) const;
+
+            /// Number of IDs handed out so far, including kNoTemplate (IDs are < size()).
+            std::size_t size() const;
+
+            void clear();
+
+            // Checkpoint state: templates and tree (configuration is not included).
+            void saveState(core::StateWriter& out) const;
+            void loadState(core::StateReader& in);
+
+        private:
+            struct Node
+            {
+                std::unordered_map<std::string_view, std::uint32_t> children; // token -> node; views into m_keys
+                std::vector<core::TemplateId> templates;                     // leaves only
+            };
+
+            /// Split 'message' on whitespace into 'tokens'.
+            static void tokenize(std::string_view message, std::vector<std::string_view>& tokens);
+
+            /// Mine the message split into m_tokens.
+            core::TemplateId addUnlocked();
+
+            /// Child of 'node' for 'token', created unless the node is full.
+            std::uint32_t childFor(std::uint32_t node, std::string_view token);
+
+            std::uint32_t newNode();
+            std::string_view keep(std::string_view key);
+
+            static bool isVariable(std::string_view token) noexcept;
+
+            std::size_t m_depth;
+            double      m_similarity;
+            std::size_t m_maxChildren;
+
+            mutable std::shared_mutex                        m_mutex;
+            std::unordered_map<std::size_t, std::uint32_t>   m_byLength;  // token count -> node
+            std::vector<Node>                                m_nodes;
+            std::deque<std::string>                          m_keys;      // child keys (stable storage)
+            std::vector<std::vector<std::string>>            m_templates; // by TemplateId; [0] unused
+            std::vector<std::string_view>                    m_tokens;    // scratch for add()
+            std::vector<bool>                                m_variable;  // scratch: m_tokens[i] is a variable
+        };
+
+    } // namespace Analysis
+} // namespace LogTool
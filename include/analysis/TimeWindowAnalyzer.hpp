@@ -7,6 +7,8 @@
 #include <vector>
 #include <string>
 #include "../core/LogEntry.hpp"   // Ensure correct path to LogEntry.hpp
+#include "../core/Span.hpp"
+#include "../core/StateCodec.hpp"
 #include "../utils/TimeUtils.hpp"
 
 namespace LogTool
@@ -44,6 +46,9 @@ namespace LogTool
             // Add LogEntry to current time window.
             void addEntry(const core::LogEntry& entry);
 
+            // Add a batch of entries under a single lock acquisition.
+            void addBatch(core::Span<const core::LogEntry> entries);
+
             // Get statistics for the most recent complete window.
             WindowStats currentWindowStats() const;
 
@@ -56,6 +61,10 @@ namespace LogTool
             // Reset analysis (clear all windows and history).
             void reset();
 
+            // Checkpoint state: current window and history (configuration is not included).
+            void saveState(core::StateWriter& out) const;
+            void loadState(core::StateReader& in);
+
             // Configuration accessors
             Utils::seconds windowSize() const noexcept { return m_windowSize; }
             void setWindowSize(Utils::seconds size) noexcept;
@@ -74,7 +83,7 @@ namespace LogTool
             {
                 Utils::TimePoint timestamp;
                 core::LogLevel level;  // Fixed: add level here
-                std::string source;
+                core::SourceId source;
             };
 
             struct TimeBucket
@@ -82,13 +91,16 @@ namespace LogTool
                 Utils::TimePoint start;
                 Utils::TimePoint end;
                 std::deque<TimedEvent> events;
-                std::unordered_map<std::string, std::size_t> sourceCounts;
+                std::vector<std::size_t> sourceCounts;  // indexed by core::SourceId
             };
 
             void addEventUnlocked(const core::LogEntry& entry);
 
             void evictOldEvents(TimeBucket& bucket);
 
+            static void saveBucket(core::StateWriter& out, const TimeBucket& bucket);
+            static void loadBucket(core::StateReader& in, TimeBucket& bucket);
+
             WindowStats calculateStats(const TimeBucket& bucket) const;
 
             Anomaly checkErrorSpike(const TimeBucket& bucket) const;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <deque>
 #include <string>
 #include <unordered_map>
@@ -8,6 +9,9 @@
 
 #include "core/LogEntry.hpp"
 #include "core/Anomaly.hpp"
+#include "core/ResultSink.hpp"
+#include "core/Span.hpp"
+#include "core/StateCodec.hpp"
 #include "utils/TimeUtils.hpp"
 
 namespace LogTool
@@ -16,12 +20,13 @@ namespace Anomaly
 {
     // Detects bursty repetition of the *same* normalized message within a short time window.
     // This directly covers the "Burst pattern recognition" requirement.
+    // "Same message" means same source, level and message template (see Analysis::TemplateMiner).
     class BurstPatternDetector
     {
     public:
         struct Burst
         {
-            std::string key;           // normalized signature
+            std::string key;           // "source|level|template"
             std::string description;
             double score = 0.0;        // repeats per window
             core::LogLevel level = core::LogLevel::Unknown;
@@ -31,12 +36,20 @@ namespace Anomaly
             std::vector<core::LogEntry> samples;
         };
 
-        BurstPatternDetector();
+        // 'announce' logs the settings at INFO (off for the extra shards of a sharded run).
+        explicit BurstPatternDetector(bool announce = true);
 
         std::vector<Burst> processEntry(const core::LogEntry& entry);
 
+        // Batch form: one lock per batch; bursts are appended to 'out' tagged with the entry index.
+        void processBatch(core::Span<const core::LogEntry> entries, core::ResultSink<Burst>& out);
+
         void reset();
 
+        // Checkpoint state: the open signature windows (configuration is not included).
+        void saveState(core::StateWriter& out) const;
+        void loadState(core::StateReader& in);
+
         // Configuration
         Utils::seconds window() const noexcept { return m_window; }
         void setWindow(Utils::seconds w) noexcept { m_window = w; }
@@ -53,14 +66,38 @@ namespace Anomaly
             std::deque<std::pair<Utils::TimePoint, core::LogEntry>> events;
         };
 
-        static std::string normalizeMessage(std::string_view msg);
-        static std::string signature(const core::LogEntry& e);
+        struct Key
+        {
+            core::TemplateId templateId = core::kNoTemplate;
+            core::SourceId   sourceId = core::kNoSource;
+            core::LogLevel   level = core::LogLevel::Unknown;
+
+            bool operator==(const Key& other) const noexcept
+            {
+                return templateId == other.templateId && sourceId == other.sourceId && level == other.level;
+            }
+        };
+
+        struct KeyHash
+        {
+            std::size_t operator()(const Key& k) const noexcept
+            {
+                return std::hash<std::uint64_t>{}((static_cast<std::uint64_t>(k.templateId) << 32) ^
+                                                  (static_cast<std::uint64_t>(k.sourceId) << 8) ^
+                                                  static_cast<std::uint64_t>(k.level));
+            }
+        };
+
+        static std::string signature(const Key& key);
 
         void evictOld(State& st, Utils::TimePoint now) const;
 
+        // Per-entry detection; caller holds m_mutex.
+        void processEntryUnlocked(const core::LogEntry& entry, std::size_t index, core::ResultSink<Burst>& out);
+
     private:
         mutable std::mutex m_mutex;
-        std::unordered_map<std::string, State> m_states;
+        std::unordered_map<Key, State, KeyHash> m_states;
 
         Utils::seconds m_window = std::chrono::seconds(60);
         std::size_t m_minRepeats = 20;
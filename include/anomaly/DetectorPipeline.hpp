@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "anomaly/DetectorRegistry.hpp"
+#include "anomaly/IDetector.hpp"
+#include "utils/ThreadPool.hpp"
+
+namespace LogTool
+{
+    namespace Anomaly
+    {
+        /**
+         * DetectorPipeline
+         *
+         * Responsibilities:
+         *  - Build the detection stages from configuration: only the enabled
+         *    detectors are instantiated (from a DetectorRegistry), sharded by
+         *    source when requested and supported.
+         *  - Run the stages of one batch, independent detectors in parallel,
+         *    and hand back each entry's anomalies in canonical detector order.
+         *  - Collect the summary anomalies once the input is exhausted.
+         *
+         * Design notes:
+         *  - Every detector writes to its own result sink, so parallel stages
+         *    share nothing; results are read back per entry by index.
+         *  - Streaming and summary stages can be driven from two different
+         *    threads (the --pipeline analyzer stage); each stage set is still
+         *    driven by one thread at a time.
+         */
+        class DetectorPipeline
+        {
+        public:
+            struct Options
+            {
+                std::vector<std::string> detectors;   ///< Names to enable; empty = all registered.
+                std::size_t              shards  = 1; ///< Source shards for shardable detectors.
+                std::size_t              threads = 1; ///< Workers running independent detectors.
+                DetectorSettings         settings;    ///< Passed to every detector factory.
+            };
+
+            /// Which stages processBatch() runs.
+            enum class Stages
+            {
+                Streaming,
+                Summary,
+                All
+            };
+
+            /**
+             * Throws std::invalid_argument for names the registry does not know.
+             */
+            explicit DetectorPipeline(const Options& options,
+                                      const DetectorRegistry& registry = DetectorRegistry::builtin());
+
+            DetectorPipeline(const DetectorPipeline&) = delete;
+            DetectorPipeline& operator=(const DetectorPipeline&) = delete;
+
+            ~DetectorPipeline();
+
+            bool hasStreaming() const noexcept { return !m_streaming.empty(); }
+            bool hasSummary() const noexcept { return !m_summary.empty(); }
+
+            /// Enabled detector names: streaming ones first, each group in canonical order.
+            std::vector<std::string> names() const;
+
+            /**
+             * Run the selected stages over one batch, which must be enriched
+             * (core::EntryBatch::enrich()). Streaming results are kept until the
+             * next call with streaming stages and read via drainEntry().
+             */
+            void processBatch(const core::EntryBatch& batch, Stages stages = Stages::All);
+
+            /**
+             * Hand the anomalies of entry 'index' of the last batch to
+             * emit(core::Anomaly&&, bool flagsEntry), in detector order.
+             * Call with ascending indices.
+             */
+            template <typename Emit>
+            void drainEntry(std::size_t index, Emit&& emit)
+            {
+                for (auto& slot : m_streaming)
+                {
+                    for (; slot.next < slot.sink.size() && slot.sink[slot.next].index == index; ++slot.next)
+                    {
+                        emit(std::move(slot.sink[slot.next].value), slot.flagsEntries);
+                    }
+                }
+            }
+
+            /// Summary anomalies of all detectors, in detector order.
+            std::vector<core::Anomaly> summarize(const IDetector::SummaryContext& context);
+
+            /// True when every enabled detector supports saveState()/loadState().
+            bool checkpointable() const;
+
+            /**
+             * Detector names in order, with shard counts ("spike/4"). A saved
+             * state only restores into a pipeline with the same layout.
+             */
+            std::string layout() const;
+
+            /**
+             * Write the state of every detector, tagged with its name. Call
+             * between batches, before summarize().
+             */
+            void saveState(core::StateWriter& out) const;
+
+            /**
+             * Restore a state written by saveState(). Throws std::runtime_error
+             * when it was saved with a different detector selection or sharding;
+             * the pipeline must then be discarded.
+             */
+            void loadState(core::StateReader& in);
+
+        private:
+            struct Slot
+            {
+                std::unique_ptr<IDetector>      detector;
+                core::ResultSink<core::Anomaly> sink;
+                std::size_t                     next = 0;
+                bool                            flagsEntries = false;
+            };
+
+            void runSlots(const std::vector<Slot*>& slots, const core::EntryBatch& batch);
+
+            std::vector<Slot>                  m_streaming;
+            std::vector<Slot>                  m_summary;
+            std::unique_ptr<Utils::ThreadPool> m_pool; // null when running serially
+        };
+
+    } // namespace Anomaly
+} // namespace LogTool
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "anomaly/IDetector.hpp"
+
+namespace LogTool
+{
+    namespace Anomaly
+    {
+        /**
+         * DetectorRegistry
+         *
+         * Responsibilities:
+         *  - Map detector names to factories, so configuration (the
+         *    "detectors" key or --detectors) decides what gets instantiated.
+         *  - Define the canonical detector order: anomalies of one entry are
+         *    reported in registration order, whatever order the user lists.
+         *
+         * Design notes:
+         *  - builtin() holds the stock detectors and analyzers:
+         *    rules, spike, stats, burst, ip, frequency, pattern, timewindow.
+         *  - Nothing is constructed until create() is called, so disabled
+         *    detectors cost nothing.
+         *  - Factories receive the DetectorSettings; a detector reads the
+         *    fields meant for it and ignores the rest.
+         */
+
+        /// Tunables of individual detectors (from the command line or config).
+        struct DetectorSettings
+        {
+            std::size_t maxPatterns = 0; ///< "pattern": n-grams tracked per table; 0 = analyzer default.
+            bool        shardInstance = false; ///< Extra shard of a sharded detector: skip the startup log line.
+        };
+
+        class DetectorRegistry
+        {
+        public:
+            using Factory = std::function<std::unique_ptr<IDetector>(const DetectorSettings&)>;
+
+            struct Entry
+            {
+                std::string name;
+                std::string description;
+                Factory     factory;
+            };
+
+            /// Register (or replace) a detector factory.
+            void add(std::string name, std::string description, Factory factory);
+
+            /// Instantiate a detector; returns nullptr for unknown names.
+            std::unique_ptr<IDetector> create(std::string_view name, const DetectorSettings& settings = {}) const;
+
+            bool contains(std::string_view name) const;
+
+            /// Position in registration order (size() for unknown names).
+            std::size_t rank(std::string_view name) const;
+
+            std::size_t size() const noexcept { return m_entries.size(); }
+
+            /// Registered detectors, in registration order.
+            const std::vector<Entry>& entries() const noexcept { return m_entries; }
+
+            /// Registry of the built-in detectors and analyzers.
+            static const DetectorRegistry& builtin();
+
+        private:
+            std::vector<Entry> m_entries;
+        };
+
+    } // namespace Anomaly
+} // namespace LogTool
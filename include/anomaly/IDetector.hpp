@@ -0,0 +1,110 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "core/Anomaly.hpp"
+#include "core/EntryBatch.hpp"
+#include "core/LogEntry.hpp"
+#include "core/ResultSink.hpp"
+#include "core/StateCodec.hpp"
+
+namespace LogTool
+{
+    namespace Anomaly
+    {
+        /**
+         * IDetector
+         *
+         * Responsibilities:
+         *  - Common interface for every analysis stage (real-time detectors and
+         *    whole-file analyzers), so the pipeline can be assembled from
+         *    configuration instead of being wired by hand.
+         *  - Report findings directly as core::Anomaly objects; each
+         *    implementation owns its own severity/type mapping.
+         *
+         * Design notes:
+         *  - Streaming detectors report anomalies per entry while the batch is
+         *    processed (tagged with the entry index, see core::ResultSink).
+         *  - Summary detectors only accumulate during ingestion and report in
+         *    summarize() once the whole input has been seen. They never feed the
+         *    per-entry report, so they can run on a separate stage.
+         *  - Batches arrive enriched (core::EntryBatch::enrich()): derived
+         *    message facts such as the upper-cased text, tokens and addresses
+         *    are computed once and read through core::EnrichedEntry.
+         *  - Implementations are not shared between threads by the pipeline:
+         *    one instance only ever sees one call at a time.
+         *  - Detectors that can be checkpointed serialize everything that
+         *    influences later results in saveState(), so a run resumed with
+         *    loadState() reports exactly what an uninterrupted run would.
+         */
+        class IDetector
+        {
+        public:
+            enum class Kind
+            {
+                Streaming, ///< Emits anomalies per entry during ingestion.
+                Summary    ///< Accumulates; emits in summarize().
+            };
+
+            /// Time range of the analysed input, for summary anomalies.
+            struct SummaryContext
+            {
+                core::LogEntry::TimePoint start;
+                core::LogEntry::TimePoint end;
+            };
+
+            virtual ~IDetector() = default;
+
+            /// Registry name (e.g. "spike").
+            virtual std::string name() const = 0;
+
+            virtual Kind kind() const = 0;
+
+            /**
+             * True when all state is keyed by entry source, so independent
+             * instances may each process a disjoint subset of sources
+             * (see ShardedDetector, which hands each instance a batch of only
+             * its own sources' entries).
+             */
+            virtual bool shardableBySource() const { return false; }
+
+            /**
+             * True when this detector's anomalies also mark their entry as
+             * anomalous in the per-level report statistics.
+             */
+            virtual bool flagsEntries() const { return false; }
+
+            /**
+             * Process one enriched batch in order (message facts via
+             * batch.enriched(i)). Anomalies go to 'out' tagged with the entry's
+             * index in the batch, in non-decreasing index order.
+             */
+            virtual void processBatch(const core::EntryBatch& batch,
+                                      core::ResultSink<core::Anomaly>& out) = 0;
+
+            /// True when saveState()/loadState() are implemented.
+            virtual bool checkpointable() const { return false; }
+
+            /// Write the accumulated state (not the configuration) to 'out'.
+            virtual void saveState(core::StateWriter& /*out*/) const
+            {
+                throw std::logic_error("Detector '" + name() + "' cannot be checkpointed");
+            }
+
+            /// Replace the accumulated state with one written by saveState().
+            virtual void loadState(core::StateReader& /*in*/)
+            {
+                throw std::logic_error("Detector '" + name() + "' cannot be checkpointed");
+            }
+
+            /// Append whole-input anomalies (summary detectors) to 'out'.
+            virtual void summarize(const SummaryContext& /*context*/,
+                                   std::vector<core::Anomaly>& /*out*/)
+            {
+            }
+        };
+
+    } // namespace Anomaly
+} // namespace LogTool
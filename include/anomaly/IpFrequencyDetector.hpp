@@ -1,20 +1,27 @@
 #pragma once
 
-#include <regex>
+#include <cstdint>
 #include <string>
-#include <unordered_map>
 #include <vector>
 #include <mutex>
-#include <optional>
 
+#include "core/EnrichedEntry.hpp"
+#include "core/EntryBatch.hpp"
+#include "core/IpAddress.hpp"
 #include "core/LogEntry.hpp"
+#include "core/ResultSink.hpp"
+#include "core/Span.hpp"
+#include "core/StateCodec.hpp"
+#include "utils/FlatCounter.hpp"
 
 namespace LogTool
 {
 namespace Anomaly
 {
-    // Extracts IPv4 addresses from messages and flags rare IPs.
+    // Takes the first IPv4/IPv6 address of each line and flags rare IPs.
     // Covers the "Rare IP detection" requirement even though core::LogEntry does not have a dedicated IP field.
+    // Addresses come from the enrichment stage (core::IpScanner, no regex); counts are kept in flat
+    // open-addressing tables keyed by the address value (32-bit IPv4, 128-bit IPv6), not by its text.
     class IpFrequencyDetector
     {
     public:
@@ -30,19 +37,29 @@ namespace Anomaly
         // Returns IpHit anomalies when an IP is considered rare under the current definition.
         std::vector<IpHit> processEntry(const core::LogEntry& entry);
 
+        // Batch form over an enriched batch: one lock per batch; hits are appended to 'out'
+        // tagged with the entry index.
+        void processBatch(const core::EntryBatch& batch, core::ResultSink<IpHit>& out);
+
         void reset();
 
+        // Checkpoint state: the per-address counts (configuration is not included).
+        void saveState(core::StateWriter& out) const;
+        void loadState(core::StateReader& in);
+
         // Configuration
         // "Rare" is defined as count <= maxCount (default 5). For large datasets, consider raising this.
         std::size_t maxCountForRare() const noexcept { return m_maxCountForRare; }
         void setMaxCountForRare(std::size_t v) noexcept { m_maxCountForRare = v; }
 
     private:
-        static std::optional<std::string> extractIp(std::string_view message);
+        // Per-entry detection; caller holds m_mutex.
+        void processEntryUnlocked(const core::EnrichedEntry& entry, std::size_t index, core::ResultSink<IpHit>& out);
 
     private:
         mutable std::mutex m_mutex;
-        std::unordered_map<std::string, std::size_t> m_counts;
+        Utils::FlatCounter<std::uint32_t> m_v4Counts;                     // IPv4 address -> count
+        Utils::FlatCounter<core::Ipv6Address, core::Ipv6Hash> m_v6Counts; // IPv6 address -> count
         std::size_t m_maxCountForRare = 5;
     };
 
@@ -13,6 +13,11 @@
 #include <optional>
 #include "core/LogEntry.hpp"
 #include "core/Anomaly.hpp"
+#include "core/EnrichedEntry.hpp"
+#include "core/EntryBatch.hpp"
+#include "core/ResultSink.hpp"
+#include "core/Span.hpp"
+#include "core/StateCodec.hpp"
 #include "utils/ConfigLoader.hpp"
 
 namespace LogTool
@@ -26,6 +31,8 @@ namespace LogTool
          *  - Shared mutex for concurrent read access
          *  - Lock-free atomic operations where possible
          *  - Rule caching and lazy compilation
+         *  - Keyword rules match the batch's shared upper-cased message view
+         *    (core::EnrichedEntry); the cache is keyed by message fingerprint
          *  - Memory pool for frequent allocations
          *  - Time-window optimization with circular buffers
          *  - Plugin-based rule system for dynamic extensibility
@@ -132,7 +139,15 @@ namespace LogTool
              * Processes multiple entries with shared lock acquisition.
              */
             std::vector<std::vector<RuleMatch>> checkEntries(
-                const std::vector<core::LogEntry>& entries);
+                core::Span<const core::LogEntry> entries);
+
+            /**
+             * Batch processing into a caller-owned buffer: the rule set is
+             * locked once for the whole (enriched) batch and every match is
+             * appended to 'out', tagged with the entry's index in the batch.
+             */
+            void processBatch(const core::EntryBatch& batch,
+                              core::ResultSink<RuleMatch>& out);
 
             /**
              * Load rules from configuration with hot-reload support.
@@ -215,6 +230,14 @@ namespace LogTool
              */
             void clearCaches();
 
+            /**
+             * Write / restore the THRESHOLD rule event windows (for checkpoints).
+             * Rules, plugins and the match cache are not part of the state:
+             * the rules come from configuration and the cache is only a memo.
+             */
+            void saveState(core::StateWriter& out) const;
+            void loadState(core::StateReader& in);
+
             /**
              * Enable/disable adaptive thresholds globally.
              */
@@ -222,7 +245,7 @@ namespace LogTool
 
         private:
             /// Rule execution function signature
-            using RuleFunction = std::function<bool(const core::LogEntry&, RuleMatch&)>;
+            using RuleFunction = std::function<bool(const core::EnrichedEntry&, RuleMatch&)>;
 
             /// Compiled rule with metadata
             struct CompiledRule
@@ -256,7 +279,8 @@ namespace LogTool
             RuleFunction compileRule(const RuleConfig& rule);
 
             /// Individual rule implementations (optimized)
-            bool checkKeywordRule(const core::LogEntry& entry, 
+            bool checkKeywordRule(const core::EnrichedEntry& entry,
+                                const std::string& keywordsUpper,
                                 const std::string& keywords,
                                 RuleMatch& match) const;
             
@@ -291,14 +315,19 @@ namespace LogTool
             /// Cache management
             struct CacheEntry
             {
+                core::SourceId source = core::kNoSource; // key verification:
+                std::string message;                     // fingerprints may collide
                 std::vector<RuleMatch> matches;
                 std::chrono::system_clock::time_point timestamp;
             };
 
             std::optional<std::vector<RuleMatch>> checkCache(
-                const core::LogEntry& entry) const;
+                const core::EnrichedEntry& entry) const;
+
+            /// Evaluate all rules for one entry; caller holds m_rulesMutex (shared)
+            std::vector<RuleMatch> checkEntryLocked(const core::EnrichedEntry& entry);
             
-            void updateCache(const core::LogEntry& entry, 
+            void updateCache(const core::EnrichedEntry& entry, 
                            const std::vector<RuleMatch>& matches);
 
             /// Adaptive threshold calculation
@@ -328,7 +357,7 @@ namespace LogTool
             // Cache system
             bool m_cachingEnabled;
             std::size_t m_maxCacheSize;
-            mutable std::unordered_map<std::string, CacheEntry> m_cache;
+            mutable std::unordered_map<std::uint64_t, CacheEntry> m_cache; // keyed by makeCacheKey()
             mutable std::shared_mutex m_cacheMutex;
 
             // Statistics (atomic for lock-free updates)
@@ -352,4 +381,4 @@ namespace LogTool
         };
 
     } // namespace Anomaly
-} // namespace LogTool
\ No newline at end of file
+} // namespace LogTool
\ No newline at end of file
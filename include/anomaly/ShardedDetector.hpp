@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "anomaly/IDetector.hpp"
+#include "core/SourceTable.hpp"
+#include "utils/ThreadPool.hpp"
+
+namespace LogTool
+{
+    namespace Anomaly
+    {
+        /**
+         * ShardedDetector
+         *
+         * Responsibilities:
+         *  - Run one source-keyed detector (IDetector::shardableBySource()) as
+         *    N private instances on N worker threads, hashing each entry's
+         *    source to a shard.
+         *  - Merge the per-shard results back in entry order, exactly as a
+         *    single instance would produce them.
+         *
+         * Design notes:
+         *  - Every shard instance only ever sees its own sources, so detector
+         *    state is never shared between threads.
+         *  - All entries of one source go to the same shard in file order, so
+         *    single-source ordering semantics are unchanged.
+         *  - Each shard gets an ordinary EntryBatch holding only its rows (with
+         *    their enrichment), so detectors need no sharding-specific entry
+         *    point; anomaly indices are mapped back to the original rows.
+         *  - Results are merged once per batch (the batch is the streaming
+         *    window boundary), so anomalies stay interleaved with the other
+         *    detectors and with malformed lines.
+         */
+        class ShardedDetector final : public IDetector
+        {
+        public:
+            /// 'shards' must be non-empty and all of the same detector type.
+            explicit ShardedDetector(std::vector<std::unique_ptr<IDetector>> shards);
+
+            ~ShardedDetector() override;
+
+            std::string name() const override { return m_shards.front()->name(); }
+            Kind kind() const override { return m_shards.front()->kind(); }
+            bool shardableBySource() const override { return false; }
+            bool flagsEntries() const override { return m_shards.front()->flagsEntries(); }
+
+            std::size_t shardCount() const noexcept { return m_shards.size(); }
+
+            /// Shard owning all entries of 'source'.
+            std::size_t shardOf(core::SourceId source) const noexcept
+            {
+                return static_cast<std::size_t>(source) % m_shards.size();
+            }
+
+            void processBatch(const core::EntryBatch& batch,
+                              core::ResultSink<core::Anomaly>& out) override;
+
+            void summarize(const SummaryContext& context, std::vector<core::Anomaly>& out) override;
+
+            /// Shard states in shard order; restoring requires the same shard count.
+            bool checkpointable() const override { return m_shards.front()->checkpointable(); }
+            void saveState(core::StateWriter& out) const override;
+            void loadState(core::StateReader& in) override;
+
+        private:
+            std::vector<std::unique_ptr<IDetector>>      m_shards;
+            std::vector<std::vector<std::uint32_t>>      m_rows;    // per shard: indices in the current batch
+            std::vector<core::EntryBatch>                m_batches; // per shard: those rows as a batch
+            std::vector<core::ResultSink<core::Anomaly>> m_parts; // per shard results, merged by index
+
+            std::unique_ptr<Utils::ThreadPool> m_pool; // null with a single shard
+        };
+
+    } // namespace Anomaly
+} // namespace LogTool
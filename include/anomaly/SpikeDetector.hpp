@@ -1,12 +1,14 @@
 #pragma once
 
 #include <deque>
-#include <unordered_map>
 #include <mutex>
 #include <vector>
 #include <string>
 #include "core/LogEntry.hpp"
 #include "core/Anomaly.hpp"
+#include "core/ResultSink.hpp"
+#include "core/Span.hpp"
+#include "core/StateCodec.hpp"
 #include "utils/TimeUtils.hpp"
 
 namespace LogTool
@@ -27,6 +29,7 @@ namespace LogTool
          *  - Computes spike ratio (current / historical average)
          *  - Thread-safe for concurrent log processing
          *  - Per-source spike detection prevents cross-service false positives
+         *  - Per-source state is a flat array indexed by core::SourceId
          */
         class SpikeDetector
         {
@@ -50,8 +53,8 @@ namespace LogTool
                 std::vector<core::LogEntry> sampleEvents;
             };
 
-            /// Default: detects 5x spikes over 60s baseline
-            SpikeDetector();
+            /// Default: detects 5x spikes over 60s baseline; 'announce' logs the settings at INFO.
+            explicit SpikeDetector(bool announce = true);
 
             // Thread-safe but non-copyable due to window state
             SpikeDetector(const SpikeDetector&) = delete;
@@ -66,6 +69,14 @@ namespace LogTool
              */
             std::vector<SpikeAnomaly> processEntry(const core::LogEntry& entry);
 
+            /**
+             * Process a batch of entries under a single lock acquisition.
+             * Spikes are appended to 'out', tagged with the entry's index in 'entries'.
+             * Thread-safe.
+             */
+            void processBatch(core::Span<const core::LogEntry> entries,
+                              core::ResultSink<SpikeAnomaly>& out);
+
             /**
              * Get spike statistics for specific source.
              * Thread-safe read access.
@@ -82,6 +93,14 @@ namespace LogTool
              */
             void reset();
 
+            /**
+             * Write / restore the per-source windows (for checkpoints).
+             * Configuration is not part of the state.
+             * Thread-safe.
+             */
+            void saveState(core::StateWriter& out) const;
+            void loadState(core::StateReader& in);
+
             // Configuration
             double spikeThreshold() const noexcept { return m_spikeThreshold; }
             void setSpikeThreshold(double ratio) noexcept;
@@ -99,6 +118,8 @@ namespace LogTool
             /// Per-source spike tracking state
             struct SourceState
             {
+                bool active = false;   // slot has seen at least one event
+
                 // Short-term window (current spike detection)
                 std::deque<Utils::TimePoint> recentEvents;
                 std::size_t currentCount = 0;
@@ -116,12 +137,16 @@ namespace LogTool
                 Utils::TimePoint lastWindowAdvance;
             };
 
+            /// Per-entry detection; caller holds m_mutex
+            void processEntryUnlocked(const core::LogEntry& entry,
+                                      std::size_t index,
+                                      core::ResultSink<SpikeAnomaly>& out);
+
             /// Advance time windows and update counts
             void advanceWindows(SourceState& state, Utils::TimePoint now);
 
-            /// Calculate spike ratio and rate of change
+            /// Calculate spike ratio and rate of change (stats.source is left empty)
             SpikeStats calculateStats(const SourceState& state, 
-                                    const std::string& source,
                                     Utils::TimePoint now) const;
 
             /// Determine if current activity represents a spike
@@ -134,8 +159,8 @@ namespace LogTool
         private:
             mutable std::mutex m_mutex;
 
-            // Per-source spike detection state
-            std::unordered_map<std::string, SourceState> m_sourceStates;
+            // Per-source spike detection state, indexed by core::SourceId
+            std::vector<SourceState> m_sourceStates;
 
             // Configuration parameters
             // Default tuned for this project's synthetic/anomalous logs.
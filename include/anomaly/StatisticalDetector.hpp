@@ -7,6 +7,9 @@
 #include <cmath>
 #include "../core/LogEntry.hpp"
 #include "../core/Anomaly.hpp"
+#include "../core/ResultSink.hpp"
+#include "../core/Span.hpp"
+#include "../core/StateCodec.hpp"
 #include "../utils/TimeUtils.hpp"
 
 namespace LogTool
@@ -27,7 +30,8 @@ namespace LogTool
          * Design notes:
          *  - Uses Welford's algorithm for online mean/variance calculation
          *  - Thread-safe for concurrent log processing
-         *  - Maintains per-source statistics for accurate detection
+         *  - Maintains per-source statistics for accurate detection, in flat
+         *    arrays indexed by core::SourceId (slot 0 collects "<unknown>")
          *  - Configurable Z-score thresholds and window sizes
          */
         class StatisticalDetector
@@ -52,8 +56,8 @@ namespace LogTool
                 core::LogEntry entry;
             };
 
-            /// Default: 3-sigma detection, 100-event window
-            StatisticalDetector();
+            /// Default: 3-sigma detection, 100-event window; 'announce' logs the settings at INFO.
+            explicit StatisticalDetector(bool announce = true);
 
             // Thread-safe but non-copyable due to statistical state
             StatisticalDetector(const StatisticalDetector&) = delete;
@@ -68,6 +72,14 @@ namespace LogTool
              */
             std::vector<Anomaly> processEntry(const core::LogEntry& entry);
 
+            /**
+             * Process a batch of entries under a single lock acquisition.
+             * Anomalies are appended to 'out', tagged with the entry's index in 'entries'.
+             * Thread-safe.
+             */
+            void processBatch(core::Span<const core::LogEntry> entries,
+                              core::ResultSink<Anomaly>& out);
+
             /**
              * Get statistical summary for specific source.
              * Thread-safe read access.
@@ -89,6 +101,14 @@ namespace LogTool
              */
             void reset();
 
+            /**
+             * Write / restore the statistical models and rate windows (for checkpoints).
+             * Configuration is not part of the state.
+             * Thread-safe.
+             */
+            void saveState(core::StateWriter& out) const;
+            void loadState(core::StateReader& in);
+
             // Configuration
             double zScoreThreshold() const noexcept { return m_zScoreThreshold; }
             void setZScoreThreshold(double threshold) noexcept;
@@ -113,10 +133,15 @@ namespace LogTool
                 double stddev() const;
             };
 
+            /// Per-entry detection; caller holds m_mutex
+            void processEntryUnlocked(const core::LogEntry& entry,
+                                      std::size_t index,
+                                      core::ResultSink<Anomaly>& out);
+
             /// Calculate Z-score for value against statistical model
             double calculateZScore(double value, const OnlineStats& stats) const;
             /// Calculate event rate (events per minute) using the *log timestamps*.
-            double calculateEventRate(const std::string& source, Utils::TimePoint ts);
+            double calculateEventRate(core::SourceId source, Utils::TimePoint ts);
 
 
             /// Update exponentially weighted moving average
@@ -132,8 +157,8 @@ namespace LogTool
         private:
             mutable std::mutex m_mutex;
 
-            // Per-source event rate statistics (events per minute)
-            std::unordered_map<std::string, OnlineStats> m_sourceStats;
+            // Per-source event rate statistics (events per minute), indexed by SourceId
+            std::vector<OnlineStats> m_sourceStats;
             
             // Global event statistics
             OnlineStats m_globalStats;
@@ -144,7 +169,7 @@ namespace LogTool
             double m_smoothingFactor = 0.1;       // EWMA alpha (10% weight to new data)
             
             // Track recent timestamps for rate calculation
-            std::unordered_map<std::string, std::deque<Utils::TimePoint>> m_recentBySource;
+            std::vector<std::deque<Utils::TimePoint>> m_recentBySource;
 
             // Rate window for per-source event-rate calculation
             Utils::seconds m_rateWindow = std::chrono::minutes(10);
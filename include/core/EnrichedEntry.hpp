@@ -0,0 +1,347 @@
+// File: C:\Project\include\core\EnrichedEntry.hpp
+//
+// Facts derived from an entry's message once, right after parsing: an
+// upper-cased copy, token offsets, a fingerprint, IP addresses and numeric
+// fields. Detectors read them through EnrichedEntry instead of each one
+// re-scanning the message text.
+
+#ifndef CORE_ENRICHED_ENTRY_HPP
+#define CORE_ENRICHED_ENTRY_HPP
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/IpAddress.hpp"
+#include "core/LogEntry.hpp"
+#include "core/SourceTable.hpp"
+#include "core/Span.hpp"
+
+namespace core
+{
+
+/// Byte range [offset, offset + length) of an entry's message.
+struct TextRange
+{
+    std::uint32_t offset = 0;
+    std::uint32_t length = 0;
+};
+
+class Enrichment;
+
+/**
+ * @brief Read-only view of one entry together with its derived facts.
+ *
+ * Cheap to copy (two pointers and a row number); valid as long as the entry
+ * and the Enrichment it was taken from are unchanged.
+ */
+class EnrichedEntry
+{
+public:
+    /// View of 'entry', whose facts are row 'row' of 'facts'.
+    EnrichedEntry(const LogEntry& entry, const Enrichment& facts, std::size_t row) noexcept
+        : m_entry(&entry), m_facts(&facts), m_row(row)
+    {
+    }
+
+    const LogEntry&  entry() const noexcept { return *m_entry; }
+    std::string_view message() const noexcept { return m_entry->message(); }
+
+    /// The message with ASCII letters upper-cased (same length and offsets).
+    std::string_view upper() const noexcept;
+
+    /// 64-bit FNV-1a hash of the message bytes.
+    std::uint64_t fingerprint() const noexcept;
+
+    /// Whitespace-separated tokens of the message.
+    std::size_t      tokenCount() const noexcept;
+    std::string_view token(std::size_t i) const noexcept;
+
+    /// IPv4/IPv6 addresses anywhere in the line, in order of appearance.
+    std::size_t      ipCount() const noexcept;
+    const IpAddress& ip(std::size_t i) const noexcept;
+
+    /// Numeric fields: tokens, or the value of "key=value" / "key:value"
+    /// tokens, that are plain decimal numbers ("42", "-3", "0.25").
+    Span<const double> numbers() const noexcept;
+
+private:
+    std::string_view text(TextRange range) const noexcept
+    {
+        return message().substr(range.offset, range.length);
+    }
+
+    const LogEntry*   m_entry;
+    const Enrichment* m_facts;
+    std::size_t       m_row;
+};
+
+/**
+ * @brief Per-entry facts of a run of entries, stored column-wise.
+ *
+ * Responsibilities:
+ *  - Derive everything the detectors want to know about a message in one
+ *    pass over its bytes (plus a short look at the tokens that can hold an
+ *    address or a number), once per entry for all detectors.
+ *
+ * Design notes:
+ *  - Row i describes entries[i] of the last compute(). Variable-length
+ *    facts are flat arrays shared by all rows (each row keeps index
+ *    ranges), so a batch costs a handful of allocations, reused across
+ *    batches by the owning EntryBatch.
+ *  - Offsets refer to message(); the upper-cased copy is the only text
+ *    stored, everything else is a range of the entry's own message.
+ *  - Addresses (core::IpScanner) come from the whole line: the raw line
+ *    when the parser kept it, otherwise the source name followed by the
+ *    message, which is everything of a line but its timestamp and level.
+ *    Source names are scanned once per source, not once per entry.
+ */
+class Enrichment
+{
+public:
+    /// Derive the facts of 'entries' (replaces the previous contents).
+    void compute(Span<const LogEntry> entries)
+    {
+        clear();
+        m_rows.reserve(entries.size());
+        for (const auto& entry : entries)
+            add(entry);
+    }
+
+    void clear() noexcept
+    {
+        m_rows.clear();
+        m_upper.clear();
+        m_tokens.clear();
+        m_ips.clear();
+        m_numbers.clear();
+    }
+
+    /// Number of rows (entries) computed.
+    std::size_t size() const noexcept { return m_rows.size(); }
+
+    /// Append a copy of row 'row' of 'from', whose message is 'messageSize' bytes.
+    void append(const Enrichment& from, std::size_t row, std::size_t messageSize)
+    {
+        const Row& source = from.m_rows[row];
+        Row copy = source;
+        copy.upper   = m_upper.size();
+        copy.tokens  = static_cast<std::uint32_t>(m_tokens.size());
+        copy.ips     = static_cast<std::uint32_t>(m_ips.size());
+        copy.numbers = static_cast<std::uint32_t>(m_numbers.size());
+
+        m_upper.append(from.m_upper, source.upper, messageSize);
+        m_tokens.insert(m_tokens.end(), from.m_tokens.begin() + source.tokens,
+                        from.m_tokens.begin() + source.tokens + source.tokenCount);
+        m_ips.insert(m_ips.end(), from.m_ips.begin() + source.ips,
+                     from.m_ips.begin() + source.ips + source.ipCount);
+        m_numbers.insert(m_numbers.end(), from.m_numbers.begin() + source.numbers,
+                         from.m_numbers.begin() + source.numbers + source.numberCount);
+        m_rows.push_back(copy);
+    }
+
+private:
+    friend class EnrichedEntry;
+
+    struct Row
+    {
+        std::uint64_t fingerprint = 0;
+        std::size_t   upper       = 0; ///< Offset of the row's text in m_upper.
+        std::uint32_t tokens      = 0; ///< First token in m_tokens.
+        std::uint32_t tokenCount  = 0;
+        std::uint32_t ips         = 0; ///< First address in m_ips.
+        std::uint32_t ipCount     = 0;
+        std::uint32_t numbers     = 0; ///< First value in m_numbers.
+        std::uint32_t numberCount = 0;
+    };
+
+    static bool isSpace(char c) noexcept
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    static bool isDigit(char c) noexcept { return c >= '0' && c <= '9'; }
+
+    static bool isWord(char c) noexcept
+    {
+        return isDigit(c) || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == '_';
+    }
+
+    void add(const LogEntry& entry)
+    {
+        const std::string_view message = entry.message();
+        const auto raw = entry.rawLine();
+
+        Row row;
+        row.upper   = m_upper.size();
+        row.tokens  = static_cast<std::uint32_t>(m_tokens.size());
+        row.ips     = static_cast<std::uint32_t>(m_ips.size());
+        row.numbers = static_cast<std::uint32_t>(m_numbers.size());
+
+        // Addresses in line order: the raw line, or the source before the message
+        if (raw)
+            IpScanner::scan(*raw, m_ips);
+        else
+            addSourceAddresses(entry.sourceId());
+
+        // One pass: upper case, fingerprint and token boundaries. Tokens with
+        // a digit are looked at again for addresses and numbers (an address
+        // always has a digit and never spans whitespace).
+        const bool    scanMessage = !raw;
+        std::uint64_t hash = 0xcbf29ce484222325ull;
+        std::size_t   begin = 0;
+        bool          inToken = false;
+        bool          digit = false;
+        m_upper.resize(row.upper + message.size());
+        char* upper = m_upper.data() + row.upper;
+        for (std::size_t i = 0; i < message.size(); ++i)
+        {
+            const char c = message[i];
+            upper[i] = (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+            hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3ull;
+
+            if (isSpace(c))
+            {
+                if (inToken)
+                    addToken(message, begin, i, digit, scanMessage);
+                inToken = false;
+                continue;
+            }
+            if (!inToken)
+            {
+                inToken = true;
+                begin = i;
+                digit = false;
+            }
+            digit = digit || isDigit(c);
+        }
+        if (inToken)
+            addToken(message, begin, message.size(), digit, scanMessage);
+
+        row.fingerprint = hash;
+        row.tokenCount  = static_cast<std::uint32_t>(m_tokens.size() - row.tokens);
+        row.ipCount     = static_cast<std::uint32_t>(m_ips.size() - row.ips);
+        row.numberCount = static_cast<std::uint32_t>(m_numbers.size() - row.numbers);
+        m_rows.push_back(row);
+    }
+
+    void addToken(std::string_view message, std::size_t begin, std::size_t end, bool digit, bool scanAddresses)
+    {
+        m_tokens.push_back(TextRange{static_cast<std::uint32_t>(begin), static_cast<std::uint32_t>(end - begin)});
+        if (!digit)
+            return;
+
+        const std::string_view token = message.substr(begin, end - begin);
+        if (scanAddresses)
+            IpScanner::scan(token, m_ips);
+
+        // Numeric field: the whole token or the value after its last '=' / ':'
+        std::string_view value = token;
+        const auto sep = value.find_last_of("=:");
+        if (sep != std::string_view::npos)
+            value.remove_prefix(sep + 1);
+        if (isDecimal(value))
+        {
+            double number = 0.0;
+            const char* first = value.data() + (value.front() == '+' ? 1 : 0);
+            if (std::from_chars(first, value.data() + value.size(), number).ec == std::errc())
+                m_numbers.push_back(number);
+        }
+    }
+
+    /// Append the addresses in the name of 'source' (scanned on first use).
+    void addSourceAddresses(SourceId source)
+    {
+        if (source == kNoSource)
+            return;
+        if (source >= m_sources.size())
+            m_sources.resize(source + 1);
+        auto& known = m_sources[source];
+        if (!known.scanned)
+        {
+            if (const auto& name = SourceTable::global().optionalName(source))
+                IpScanner::scan(*name, known.addresses);
+            known.scanned = true;
+        }
+        m_ips.insert(m_ips.end(), known.addresses.begin(), known.addresses.end());
+    }
+
+    /// [+-]digits[.digits]
+    static bool isDecimal(std::string_view s) noexcept
+    {
+        std::size_t i = (!s.empty() && (s.front() == '+' || s.front() == '-')) ? 1 : 0;
+        const std::size_t intBegin = i;
+        while (i < s.size() && isDigit(s[i]))
+            ++i;
+        if (i == intBegin)
+            return false;
+        if (i < s.size() && s[i] == '.')
+        {
+            const std::size_t fracBegin = ++i;
+            while (i < s.size() && isDigit(s[i]))
+                ++i;
+            if (i == fracBegin)
+                return false;
+        }
+        return i == s.size();
+    }
+
+    std::vector<Row>       m_rows;
+    std::string            m_upper;   ///< Upper-cased messages, back to back.
+    std::vector<TextRange> m_tokens;
+    std::vector<IpAddress> m_ips;
+    std::vector<double>    m_numbers;
+
+    struct SourceAddresses
+    {
+        bool                   scanned = false;
+        std::vector<IpAddress> addresses;
+    };
+    std::vector<SourceAddresses> m_sources; ///< By SourceId; names never change, kept across compute().
+};
+
+// ---------- EnrichedEntry accessors ----------
+
+inline std::string_view EnrichedEntry::upper() const noexcept
+{
+    const auto& row = m_facts->m_rows[m_row];
+    return std::string_view(m_facts->m_upper).substr(row.upper, message().size());
+}
+
+inline std::uint64_t EnrichedEntry::fingerprint() const noexcept
+{
+    return m_facts->m_rows[m_row].fingerprint;
+}
+
+inline std::size_t EnrichedEntry::tokenCount() const noexcept
+{
+    return m_facts->m_rows[m_row].tokenCount;
+}
+
+inline std::string_view EnrichedEntry::token(std::size_t i) const noexcept
+{
+    return text(m_facts->m_tokens[m_facts->m_rows[m_row].tokens + i]);
+}
+
+inline std::size_t EnrichedEntry::ipCount() const noexcept
+{
+    return m_facts->m_rows[m_row].ipCount;
+}
+
+inline const IpAddress& EnrichedEntry::ip(std::size_t i) const noexcept
+{
+    return m_facts->m_ips[m_facts->m_rows[m_row].ips + i];
+}
+
+inline Span<const double> EnrichedEntry::numbers() const noexcept
+{
+    const auto& row = m_facts->m_rows[m_row];
+    return Span<const double>(m_facts->m_numbers.data() + row.numbers, row.numberCount);
+}
+
+} // namespace core
+
+#endif // CORE_ENRICHED_ENTRY_HPP
@@ -0,0 +1,143 @@
+// File: C:\Project\include\core\EntryBatch.hpp
+//
+// Column-oriented batch of parsed log entries.
+// The parser fills a batch with a few thousand consecutive entries, and the
+// pipeline aggregates over the hot scalar fields (timestamp, level, source)
+// as contiguous arrays instead of visiting entries one by one.
+
+#ifndef CORE_ENTRY_BATCH_HPP
+#define CORE_ENTRY_BATCH_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "core/EnrichedEntry.hpp"
+#include "core/LogEntry.hpp"
+#include "core/SourceTable.hpp"
+
+namespace core
+{
+
+/**
+ * @brief Structure-of-arrays container for consecutive log entries.
+ *
+ * Responsibilities:
+ *  - Keep timestamps, levels and source IDs in parallel contiguous arrays
+ *    for tight counting/bucketing loops.
+ *  - Keep the entries themselves (LogEntry) in the same order for stages
+ *    that need the message text or keep samples.
+ *  - Own the entries' derived message facts (core::Enrichment), computed
+ *    once by enrich() and shared by every detector through enriched(i).
+ *
+ * Design notes:
+ *  - Index i of every column describes the same entry, in input order.
+ *  - The message column is the entries' arena offsets (LogEntry::message()),
+ *    so the batch never copies text.
+ *  - clear() keeps the column capacity, so one batch object can be reused
+ *    for a whole file without reallocating.
+ *  - Adding or clearing entries drops the enrichment; call enrich() again
+ *    once the batch is complete.
+ */
+class EntryBatch
+{
+public:
+    using TimePoint = LogEntry::TimePoint;
+
+    /// Number of entries the parser puts in one batch by default.
+    static constexpr std::size_t kDefaultCapacity = 4096;
+
+    EntryBatch() = default;
+
+    /// Reserve room for 'capacity' entries in every column.
+    void reserve(std::size_t capacity)
+    {
+        m_timestamps.reserve(capacity);
+        m_levels.reserve(capacity);
+        m_sources.reserve(capacity);
+        m_entries.reserve(capacity);
+    }
+
+    /// Append one entry (its scalar fields go to the columns).
+    void push_back(LogEntry entry)
+    {
+        pushColumns(std::move(entry));
+        m_enrichment.clear();
+    }
+
+    /**
+     * @brief Append entry 'i' of 'other'.
+     *
+     * Its derived facts are copied along when both batches are enriched, so
+     * a subset of an enriched batch (a source shard) is enriched as well
+     * without scanning the messages again.
+     */
+    void append(const EntryBatch& other, std::size_t i)
+    {
+        const bool keepFacts = isEnriched() && other.isEnriched();
+        pushColumns(other.m_entries[i]);
+        if (keepFacts)
+            m_enrichment.append(other.m_enrichment, i, other.m_entries[i].message().size());
+        else
+            m_enrichment.clear();
+    }
+
+    /// Drop all entries, keeping the allocated capacity.
+    void clear() noexcept
+    {
+        m_timestamps.clear();
+        m_levels.clear();
+        m_sources.clear();
+        m_entries.clear();
+        m_enrichment.clear();
+    }
+
+    std::size_t size() const noexcept { return m_entries.size(); }
+    bool        empty() const noexcept { return m_entries.empty(); }
+
+    // ---------- Columns ----------
+
+    const std::vector<TimePoint>& timestamps() const noexcept { return m_timestamps; }
+    const std::vector<LogLevel>&  levels() const noexcept { return m_levels; }
+    const std::vector<SourceId>&  sourceIds() const noexcept { return m_sources; }
+
+    /// Entries in input order (row view).
+    const std::vector<LogEntry>& entries() const noexcept { return m_entries; }
+
+    const LogEntry& operator[](std::size_t i) const noexcept { return m_entries[i]; }
+
+    /// Set the template ID of entry 'i' (the only field changed after parsing).
+    void setTemplateId(std::size_t i, TemplateId id) noexcept { m_entries[i].setTemplateId(id); }
+
+    // ---------- Derived message facts ----------
+
+    /// Compute the enrichment of all entries (no-op if it is up to date).
+    void enrich()
+    {
+        if (m_enrichment.size() != m_entries.size())
+            m_enrichment.compute(m_entries);
+    }
+
+    bool isEnriched() const noexcept { return m_enrichment.size() == m_entries.size(); }
+
+    /// Entry 'i' with its derived facts; requires enrich().
+    EnrichedEntry enriched(std::size_t i) const noexcept { return EnrichedEntry(m_entries[i], m_enrichment, i); }
+
+private:
+    void pushColumns(LogEntry entry)
+    {
+        m_timestamps.push_back(entry.timestamp());
+        m_levels.push_back(entry.level());
+        m_sources.push_back(entry.sourceId());
+        m_entries.push_back(std::move(entry));
+    }
+
+    std::vector<TimePoint> m_timestamps; ///< Event time per entry.
+    std::vector<LogLevel>  m_levels;     ///< Severity per entry.
+    std::vector<SourceId>  m_sources;    ///< Interned source per entry.
+    std::vector<LogEntry>  m_entries;    ///< Full entries (text via arena offsets).
+    Enrichment             m_enrichment; ///< Facts of m_entries, once enrich() ran.
+};
+
+} // namespace core
+
+#endif // CORE_ENTRY_BATCH_HPP
@@ -0,0 +1,361 @@
+// File: C:\Project\include\core\IpAddress.hpp
+//
+// IPv4/IPv6 addresses as fixed-size integer keys, and a hand-written scanner
+// that finds them anywhere in free text (log lines) without std::regex.
+
+#ifndef CORE_IP_ADDRESS_HPP
+#define CORE_IP_ADDRESS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace core
+{
+
+/// 128-bit IPv6 address: 'hi' holds groups 0-3, 'lo' groups 4-7.
+struct Ipv6Address
+{
+    std::uint64_t hi = 0;
+    std::uint64_t lo = 0;
+
+    /// IPv4-mapped address (::ffff:0:0/96); its IPv4 address is the low 32 bits.
+    bool isV4Mapped() const noexcept { return hi == 0 && (lo >> 32) == 0xffffu; }
+
+    bool operator==(const Ipv6Address& other) const noexcept { return hi == other.hi && lo == other.lo; }
+    bool operator!=(const Ipv6Address& other) const noexcept { return !(*this == other); }
+};
+
+struct Ipv6Hash
+{
+    std::size_t operator()(const Ipv6Address& a) const noexcept
+    {
+        return static_cast<std::size_t>(a.hi ^ (a.lo * 0x9e3779b97f4a7c15ull));
+    }
+};
+
+/**
+ * @brief An IPv4 or IPv6 address found in a log line.
+ */
+struct IpAddress
+{
+    enum class Family : std::uint8_t
+    {
+        V4,
+        V6
+    };
+
+    Family        family = Family::V4;
+    std::uint32_t v4     = 0;  ///< V4 only: a.b.c.d as (a << 24) | (b << 16) | (c << 8) | d.
+    Ipv6Address   v6{};        ///< V6 only.
+
+    bool operator==(const IpAddress& other) const noexcept
+    {
+        return family == other.family && (family == Family::V4 ? v4 == other.v4 : v6 == other.v6);
+    }
+
+    /**
+     * Dotted quad, or the RFC 5952 text form of an IPv6 address ("2001:db8::1"),
+     * in mixed notation for an IPv4-mapped one ("::ffff:192.0.2.1").
+     */
+    std::string toString() const
+    {
+        static constexpr char kHex[] = "0123456789abcdef";
+        std::string out;
+        const auto appendDottedQuad = [&out](std::uint32_t address)
+        {
+            for (int shift = 24; shift >= 0; shift -= 8)
+            {
+                if (shift != 24)
+                    out += '.';
+                out += std::to_string((address >> shift) & 0xffu);
+            }
+        };
+        if (family == Family::V4)
+        {
+            appendDottedQuad(v4);
+            return out;
+        }
+        if (v6.isV4Mapped())
+        {
+            out = "::ffff:";
+            appendDottedQuad(static_cast<std::uint32_t>(v6.lo));
+            return out;
+        }
+
+        std::uint16_t groups[8];
+        for (int i = 0; i < 4; ++i)
+        {
+            groups[i]     = static_cast<std::uint16_t>(v6.hi >> (48 - 16 * i));
+            groups[i + 4] = static_cast<std::uint16_t>(v6.lo >> (48 - 16 * i));
+        }
+
+        // The longest run of two or more zero groups becomes "::" (the first on a tie).
+        int gap = -1;
+        int gapLength = 1;
+        for (int i = 0; i < 8;)
+        {
+            int j = i;
+            while (j < 8 && groups[j] == 0)
+                ++j;
+            if (j - i > gapLength)
+            {
+                gap = i;
+                gapLength = j - i;
+            }
+            i = j > i ? j : i + 1;
+        }
+
+        for (int i = 0; i < 8; ++i)
+        {
+            if (i == gap)
+            {
+                out += "::";
+                i += gapLength - 1;
+                continue;
+            }
+            if (i > 0 && i != gap + gapLength)
+                out += ':';
+            bool leading = true;
+            for (int shift = 12; shift >= 0; shift -= 4)
+            {
+                const unsigned digit = (groups[i] >> shift) & 0xfu;
+                if (leading && digit == 0 && shift > 0)
+                    continue;
+                leading = false;
+                out += kHex[digit];
+            }
+        }
+        return out;
+    }
+};
+
+/**
+ * @brief Finds IPv4 and IPv6 addresses in text in one left-to-right pass.
+ *
+ * Design notes:
+ *  - IPv4: four decimal octets (1-3 digits, at most 255) joined by '.'.
+ *  - IPv6: eight 1-4 digit hex groups joined by ':', or fewer with a single
+ *    "::", optionally ending in an embedded IPv4 address ("::ffff:10.0.0.1").
+ *  - IPv4-mapped addresses (::ffff:0:0/96, in either notation) are reported
+ *    as the IPv4 address they carry, so a dual-stack server logging the
+ *    same client both ways yields one address.
+ *    A candidate must contain a decimal digit, so words such as "add::bee"
+ *    or C++ names are not taken for addresses.
+ *  - Both must stand alone: the characters around an address may not be
+ *    letters, digits or '_', and a '.' / ':' directly continuing the
+ *    address (version strings "1.2.3.4.5", times "12:30:45") rejects it.
+ *    A port after an IPv4 address ("10.0.0.1:443") is fine.
+ *  - Addresses never contain whitespace and most bytes are rejected on a
+ *    single comparison, so the scan costs about one pass over the text.
+ */
+class IpScanner
+{
+public:
+    /// Append every address of 'text' to 'out', left to right.
+    static void scan(std::string_view text, std::vector<IpAddress>& out)
+    {
+        std::size_t pos = 0;
+        while (pos < text.size())
+        {
+            IpAddress address;
+            const std::size_t length = matchAt(text, pos, address);
+            if (length > 0)
+            {
+                out.push_back(address);
+                pos += length;
+            }
+            else
+            {
+                ++pos;
+            }
+        }
+    }
+
+    /**
+     * @brief Length of the address starting exactly at text[pos], or 0.
+     *
+     * On success the address is written to 'out'.
+     */
+    static std::size_t matchAt(std::string_view text, std::size_t pos, IpAddress& out) noexcept
+    {
+        const char c = text[pos];
+        if (!isHex(c) && c != ':')
+            return 0;
+        const char before = pos > 0 ? text[pos - 1] : ' ';
+        if (isWord(before) || before == '.')
+            return 0;
+
+        // After a ':' we are inside a longer hex/colon run that did not match
+        // as a whole, so only IPv4 may start there ("client:10.0.0.1").
+        std::size_t length = 0;
+        if (before != ':')
+        {
+            length = matchV6(text, pos, out.v6);
+            if (length > 0 && endsCleanly(text, pos + length, true))
+            {
+                out.family = IpAddress::Family::V6;
+                if (out.v6.isV4Mapped())
+                {
+                    out.family = IpAddress::Family::V4;
+                    out.v4 = static_cast<std::uint32_t>(out.v6.lo);
+                    out.v6 = Ipv6Address{};
+                }
+                return length;
+            }
+        }
+        if (isDigit(c))
+        {
+            length = matchV4(text, pos, out.v4);
+            if (length > 0 && endsCleanly(text, pos + length, false))
+            {
+                out.family = IpAddress::Family::V4;
+                return length;
+            }
+        }
+        return 0;
+    }
+
+private:
+    static bool isDigit(char c) noexcept { return c >= '0' && c <= '9'; }
+
+    static bool isHex(char c) noexcept
+    {
+        return isDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+    }
+
+    static bool isWord(char c) noexcept
+    {
+        return isDigit(c) || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == '_';
+    }
+
+    static unsigned hexValue(char c) noexcept
+    {
+        return isDigit(c) ? static_cast<unsigned>(c - '0')
+                          : static_cast<unsigned>((c | 0x20) - 'a' + 10);
+    }
+
+    /// No word character, and no '.' (or ':' for IPv6) that would continue the address.
+    static bool endsCleanly(std::string_view text, std::size_t end, bool v6) noexcept
+    {
+        if (end >= text.size())
+            return true;
+        const char c = text[end];
+        if (isWord(c))
+            return false;
+        if (end + 1 < text.size() && ((c == '.' && isDigit(text[end + 1])) || (v6 && c == ':' && isHex(text[end + 1]))))
+            return false;
+        return true;
+    }
+
+    /// Dotted quad at text[pos]; returns its length or 0.
+    static std::size_t matchV4(std::string_view text, std::size_t pos, std::uint32_t& out) noexcept
+    {
+        std::uint32_t value = 0;
+        std::size_t i = pos;
+        for (int part = 0; part < 4; ++part)
+        {
+            if (part > 0)
+            {
+                if (i >= text.size() || text[i] != '.')
+                    return 0;
+                ++i;
+            }
+            unsigned octet = 0;
+            const std::size_t begin = i;
+            while (i < text.size() && isDigit(text[i]) && i - begin < 3)
+                octet = octet * 10 + static_cast<unsigned>(text[i++] - '0');
+            if (i == begin || octet > 255 || (i < text.size() && isDigit(text[i])))
+                return 0;
+            value = (value << 8) | octet;
+        }
+        out = value;
+        return i - pos;
+    }
+
+    /// IPv6 address at text[pos]; returns its length or 0.
+    static std::size_t matchV6(std::string_view text, std::size_t pos, Ipv6Address& out) noexcept
+    {
+        std::uint16_t groups[8] = {};
+        int count = 0;
+        int gap = -1; // group index where "::" stands
+        bool digit = false;
+        std::size_t i = pos;
+
+        if (text.substr(i, 2) == "::")
+        {
+            gap = 0;
+            i += 2;
+        }
+
+        while (count < 8 && i < text.size() && isHex(text[i]))
+        {
+            std::size_t end = i;
+            unsigned value = 0;
+            while (end < text.size() && isHex(text[end]) && end - i < 4)
+            {
+                digit = digit || isDigit(text[end]);
+                value = (value << 4) | hexValue(text[end++]);
+            }
+            if (end < text.size() && isHex(text[end]))
+                return 0; // more than 4 hex digits
+
+            // Embedded IPv4 takes the last two groups
+            if (end < text.size() && text[end] == '.')
+            {
+                std::uint32_t v4 = 0;
+                const std::size_t length = count <= 6 ? matchV4(text, i, v4) : 0;
+                if (length == 0)
+                    return 0;
+                groups[count++] = static_cast<std::uint16_t>(v4 >> 16);
+                groups[count++] = static_cast<std::uint16_t>(v4);
+                i += length;
+                digit = true;
+                break;
+            }
+
+            groups[count++] = static_cast<std::uint16_t>(value);
+            i = end;
+            if (text.substr(i, 2) == "::")
+            {
+                if (gap >= 0)
+                    return 0;
+                gap = count;
+                i += 2;
+            }
+            else if (i + 1 < text.size() && text[i] == ':' && isHex(text[i + 1]))
+            {
+                ++i;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        if (!digit || (gap < 0 && count != 8) || (gap >= 0 && count > 7))
+            return 0;
+
+        // Expand "::" to the missing zero groups
+        std::uint16_t full[8] = {};
+        const int tail = gap < 0 ? 0 : count - gap;
+        for (int k = 0; k < count - tail; ++k)
+            full[k] = groups[k];
+        for (int k = 0; k < tail; ++k)
+            full[8 - tail + k] = groups[gap + k];
+
+        out = Ipv6Address{};
+        for (int k = 0; k < 4; ++k)
+        {
+            out.hi = (out.hi << 16) | full[k];
+            out.lo = (out.lo << 16) | full[k + 4];
+        }
+        return i - pos;
+    }
+};
+
+} // namespace core
+
+#endif // CORE_IP_ADDRESS_HPP
@@ -4,15 +4,22 @@
 // This class is intentionally lightweight and value‑semantics friendly,
 // so it can be stored in STL containers (e.g., std::vector, std::deque)
 // and passed between analysis modules efficiently.
+// Text fields live in shared TextArena blocks, so copying an entry never
+// copies or allocates strings.
 
 #ifndef CORE_LOG_ENTRY_HPP
 #define CORE_LOG_ENTRY_HPP
 
 #include <string>
+#include <string_view>
 #include <chrono>
+#include <memory>
 #include <optional>
 #include <cstdint>
 
+#include "core/SourceTable.hpp"
+#include "core/TextArena.hpp"
+
 namespace core
 {
 
@@ -33,6 +40,12 @@ enum class LogLevel : std::uint8_t
     Unknown  ///< Used when the original level cannot be parsed.
 };
 
+/// Dense identifier of a message template (see LogTool::Analysis::TemplateMiner).
+using TemplateId = std::uint32_t;
+
+/// Reserved ID meaning "no template assigned yet".
+constexpr TemplateId kNoTemplate = 0;
+
 /**
  * @brief Lightweight, immutable-ish representation of a single log entry.
  *
@@ -45,6 +58,16 @@ enum class LogLevel : std::uint8_t
  *  - Timestamps use std::chrono for type safety and portability.
  *  - Optional fields (like source) use std::optional to avoid
  *    ad‑hoc sentinel values.
+ *  - The source is stored as an interned SourceId (see SourceTable);
+ *    source() resolves it to the shared name on demand.
+ *  - Message and raw line are (offset, length) pairs into a shared,
+ *    reference-counted TextArena block; the parser packs the text of many
+ *    entries into one block. An entry is about 56 bytes with no heap
+ *    allocation of its own.
+ *  - The template ID is not set by the parser: the run assigns it to each
+ *    batch in file order, before the analysis modules see it.
+ *  - The raw line is opt-in: the parser keeps it only when asked to, and
+ *    when the message is a slice of the raw line it is not stored twice.
  *  - The class manages only in‑memory data, so RAII is trivial:
  *    standard members are automatically cleaned up.
  */
@@ -71,17 +94,58 @@ public:
      * @param source Identifier of the component/service (optional).
      * @param message Raw or normalized log message body.
      * @param rawLine Original line text (optional, useful for reporting/debug).
+     *
+     * The text is copied into a block owned by this entry alone.
      */
     LogEntry(TimePoint timestamp,
              LogLevel level,
              std::optional<std::string> source,
-             std::string message,
-             std::optional<std::string> rawLine = std::nullopt)
+             std::string_view message,
+             std::optional<std::string_view> rawLine = std::nullopt)
         : m_timestamp(timestamp),
-          m_level(level),
-          m_source(std::move(source)),
-          m_message(std::move(message)),
-          m_rawLine(std::move(rawLine))
+          m_sourceId(source ? SourceTable::global().intern(*source) : kNoSource),
+          m_level(level)
+    {
+        TextArenaWriter own(0); // every non-empty text gets an exactly-sized block
+        storeText(message, rawLine, own);
+    }
+
+    /**
+     * @brief Construct from an already interned source ID (parser fast path).
+     *
+     * The text is appended to the current block of 'arena', shared with
+     * the other entries written through it.
+     */
+    LogEntry(TimePoint timestamp,
+             LogLevel level,
+             SourceId sourceId,
+             std::string_view message,
+             std::optional<std::string_view> rawLine,
+             TextArenaWriter& arena)
+        : m_timestamp(timestamp),
+          m_sourceId(sourceId),
+          m_level(level)
+    {
+        storeText(message, rawLine, arena);
+    }
+
+    /**
+     * @brief Construct over text that already lives in 'block' (no copy).
+     *
+     * Entries replayed from a memory-mapped entry cache use this: 'message'
+     * points into the mapping, which 'block' keeps alive.
+     */
+    LogEntry(TimePoint timestamp,
+             LogLevel level,
+             SourceId sourceId,
+             std::string_view message,
+             std::shared_ptr<const TextArena> block) noexcept
+        : m_timestamp(timestamp),
+          m_text(std::move(block)),
+          m_chars(message.data()),
+          m_messageLength(static_cast<std::uint32_t>(message.size())),
+          m_sourceId(sourceId),
+          m_level(level)
     {
     }
 
@@ -115,17 +179,42 @@ public:
     /**
      * @brief Get the source identifier (service/module), if available.
      */
-    const std::optional<std::string>& source() const noexcept
+    const std::optional<std::string>& source() const
+    {
+        return SourceTable::global().optionalName(m_sourceId);
+    }
+
+    /**
+     * @brief Get the interned source ID (kNoSource if there is none).
+     *
+     * Analysis code should key per-source state by this ID.
+     */
+    SourceId sourceId() const noexcept
+    {
+        return m_sourceId;
+    }
+
+    /**
+     * @brief Get the message template ID (kNoTemplate until one is assigned).
+     */
+    TemplateId templateId() const noexcept
+    {
+        return m_templateId;
+    }
+
+    void setTemplateId(TemplateId id) noexcept
     {
-        return m_source;
+        m_templateId = id;
     }
 
     /**
      * @brief Get the parsed log message text.
+     *
+     * The view stays valid for the lifetime of this entry (or any copy).
      */
-    const std::string& message() const noexcept
+    std::string_view message() const noexcept
     {
-        return m_message;
+        return std::string_view(m_chars + m_messageOffset, m_messageLength);
     }
 
     /**
@@ -135,9 +224,13 @@ public:
      *  - Detailed anomaly reports
      *  - Debugging parsing issues
      */
-    const std::optional<std::string>& rawLine() const noexcept
+    std::optional<std::string_view> rawLine() const noexcept
     {
-        return m_rawLine;
+        if (!m_hasRawLine)
+        {
+            return std::nullopt;
+        }
+        return std::string_view(m_chars, m_rawLength);
     }
 
     // ---------- Convenience Methods ----------
@@ -168,12 +261,47 @@ public:
     }
 
 private:
+    /// Copy the text fields into 'arena' (raw line first, message after it
+    /// unless the message is already a slice of the raw line).
+    void storeText(std::string_view message,
+                   const std::optional<std::string_view>& rawLine,
+                   TextArenaWriter& arena)
+    {
+        m_messageLength = static_cast<std::uint32_t>(message.size());
+        if (!rawLine)
+        {
+            m_chars = arena.write(message, std::string_view(), m_text);
+            return;
+        }
+
+        m_hasRawLine = true;
+        m_rawLength  = static_cast<std::uint32_t>(rawLine->size());
+        const char* rawBegin = rawLine->data();
+        const char* rawEnd   = rawBegin + rawLine->size();
+        if (!message.empty() && message.data() >= rawBegin &&
+            message.data() + message.size() <= rawEnd)
+        {
+            m_messageOffset = static_cast<std::uint32_t>(message.data() - rawBegin);
+            m_chars = arena.write(*rawLine, std::string_view(), m_text);
+        }
+        else
+        {
+            m_messageOffset = m_rawLength;
+            m_chars = arena.write(*rawLine, message, m_text);
+        }
+    }
+
     // Core structured fields used across the analysis and anomaly modules.
-    TimePoint                 m_timestamp{};          ///< Event time (normalized).
-    LogLevel                  m_level{LogLevel::Unknown}; ///< Severity level.
-    std::optional<std::string> m_source;             ///< Service / component name.
-    std::string               m_message;             ///< Parsed message body.
-    std::optional<std::string> m_rawLine;           ///< Original line (optional).
+    TimePoint                        m_timestamp{};              ///< Event time (normalized).
+    std::shared_ptr<const TextArena> m_text;                     ///< Block holding the text below.
+    const char*                      m_chars{""};                ///< Start of this entry's text in m_text.
+    std::uint32_t                    m_messageOffset{0};         ///< Message start, relative to m_chars.
+    std::uint32_t                    m_messageLength{0};         ///< Parsed message body length.
+    std::uint32_t                    m_rawLength{0};             ///< Raw line length (raw line starts at m_chars).
+    SourceId                         m_sourceId{kNoSource};      ///< Interned service / component name.
+    TemplateId                       m_templateId{kNoTemplate};  ///< Message template, once assigned.
+    LogLevel                         m_level{LogLevel::Unknown}; ///< Severity level.
+    bool                             m_hasRawLine{false};        ///< Whether the raw line was kept.
 };
 
 } // namespace core
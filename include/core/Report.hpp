@@ -13,9 +13,13 @@
 #include <cstdint>
 #include <optional>
 #include <map>
+#include <array>
 
 #include "core/LogEntry.hpp"
+#include "core/EntryBatch.hpp"
 #include "core/Anomaly.hpp"
+#include "core/SourceTable.hpp"
+#include "core/StateCodec.hpp"
 
 namespace core
 {
@@ -52,6 +56,8 @@ struct SourceStats
  *
  * Design notes:
  *  - Value-type semantics with STL containers (std::vector, std::map).
+ *  - Per-source counters are a flat array indexed by SourceId; names are
+ *    only resolved when sourceStatistics() is called at report time.
  *  - No ownership of external resources; RAII via standard members.
  *  - Thread-safe for read-only access after construction.
  */
@@ -177,6 +183,37 @@ public:
         }
     }
 
+    /**
+     * @brief Count every entry of a batch by level and by source.
+     *
+     * Same effect as incrementLevelCount(level) plus updateSourceStats(source, level)
+     * for each entry, but done as two scans over the batch columns.
+     */
+    void addEntryCounts(const EntryBatch& batch)
+    {
+        const std::size_t n      = batch.size();
+        const LogLevel*   levels = batch.levels().data();
+        const SourceId*   ids    = batch.sourceIds().data();
+
+        std::array<std::uint64_t, kLevelSlots> perLevel{};
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            ++perLevel[static_cast<std::size_t>(levels[i])];
+        }
+        for (std::size_t lv = 0; lv < kLevelSlots; ++lv)
+        {
+            if (perLevel[lv] != 0)
+            {
+                m_levelStats[static_cast<LogLevel>(lv)].count += perLevel[lv];
+            }
+        }
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            updateSourceStats(ids[i], levels[i]);
+        }
+    }
+
     /**
      * @brief Increment anomaly count for a given log level (without incrementing event count).
      *
@@ -191,19 +228,42 @@ public:
 
     // ---------- Source statistics ----------
 
-    const std::map<std::string, SourceStats>& sourceStatistics() const noexcept
+    /**
+     * @brief Statistics per source name (built from the ID-indexed counters).
+     *
+     * Entries without a source are reported as "unknown".
+     */
+    std::map<std::string, SourceStats> sourceStatistics() const
     {
-        return m_sourceStats;
+        std::map<std::string, SourceStats> byName;
+        const auto& table = SourceTable::global();
+        for (SourceId id = 0; id < m_sourceStats.size(); ++id)
+        {
+            const auto& st = m_sourceStats[id];
+            if (st.totalEvents == 0)
+            {
+                continue;
+            }
+            auto& dst = byName[table.nameOr(id, "unknown")];
+            dst.totalEvents   += st.totalEvents;
+            dst.errorEvents   += st.errorEvents;
+            dst.warningEvents += st.warningEvents;
+        }
+        return byName;
     }
 
     /**
      * @brief Update statistics for a particular source.
      *
-     * @param source Source identifier (service/module).
+     * @param source Interned source identifier (see LogEntry::sourceId()).
      * @param level Severity level of the log entry.
      */
-    void updateSourceStats(const std::string& source, LogLevel level)
+    void updateSourceStats(SourceId source, LogLevel level)
     {
+        if (source >= m_sourceStats.size())
+        {
+            m_sourceStats.resize(static_cast<std::size_t>(source) + 1);
+        }
         auto& stats = m_sourceStats[source];
         ++stats.totalEvents;
 
@@ -217,6 +277,14 @@ public:
         }
     }
 
+    /**
+     * @brief Update statistics for a source given by name.
+     */
+    void updateSourceStats(const std::string& source, LogLevel level)
+    {
+        updateSourceStats(SourceTable::global().intern(source), level);
+    }
+
     // ---------- Global summary helpers ----------
 
     /**
@@ -227,9 +295,9 @@ public:
     std::uint64_t totalErrorEvents() const noexcept
     {
         std::uint64_t total = 0;
-        for (const auto& kv : m_sourceStats)
+        for (const auto& st : m_sourceStats)
         {
-            total += kv.second.errorEvents;
+            total += st.errorEvents;
         }
         return total;
     }
@@ -240,14 +308,77 @@ public:
     std::uint64_t totalWarningEvents() const noexcept
     {
         std::uint64_t total = 0;
-        for (const auto& kv : m_sourceStats)
+        for (const auto& st : m_sourceStats)
         {
-            total += kv.second.warningEvents;
+            total += st.warningEvents;
         }
         return total;
     }
 
+    // ---------- Checkpoint state ----------
+
+    /**
+     * @brief Write the anomalies and statistics (not the metadata) to 'out'.
+     */
+    void saveState(StateWriter& out) const
+    {
+        out.putSize(m_anomalies.size());
+        for (const auto& a : m_anomalies)
+        {
+            out.putAnomaly(a);
+        }
+
+        out.putSize(m_levelStats.size());
+        for (const auto& [level, stats] : m_levelStats)
+        {
+            out.put(level);
+            out.put(stats.count);
+            out.put(stats.anomalyCount);
+        }
+
+        out.putSize(m_sourceStats.size());
+        for (const auto& st : m_sourceStats)
+        {
+            out.put(st.totalEvents);
+            out.put(st.errorEvents);
+            out.put(st.warningEvents);
+        }
+    }
+
+    /**
+     * @brief Replace the anomalies and statistics with those written by saveState().
+     */
+    void loadState(StateReader& in)
+    {
+        m_anomalies.clear();
+        const std::size_t anomalies = in.getSize();
+        m_anomalies.reserve(anomalies);
+        for (std::size_t i = 0; i < anomalies; ++i)
+        {
+            m_anomalies.push_back(in.getAnomaly());
+        }
+
+        m_levelStats.clear();
+        for (std::size_t n = in.getSize(); n > 0; --n)
+        {
+            auto& stats        = m_levelStats[in.get<LogLevel>()];
+            stats.count        = in.get<std::uint64_t>();
+            stats.anomalyCount = in.get<std::uint64_t>();
+        }
+
+        m_sourceStats.assign(in.getSize(), SourceStats{});
+        for (auto& st : m_sourceStats)
+        {
+            st.totalEvents   = in.get<std::uint64_t>();
+            st.errorEvents   = in.get<std::uint64_t>();
+            st.warningEvents = in.get<std::uint64_t>();
+        }
+    }
+
 private:
+    /// LogLevel values are 0..Unknown.
+    static constexpr std::size_t kLevelSlots = static_cast<std::size_t>(LogLevel::Unknown) + 1;
+
     // Core metadata.
     TimePoint                   m_analysisStart{};   ///< When analysis started.
     TimePoint                   m_analysisEnd{};     ///< When analysis finished.
@@ -259,7 +390,7 @@ private:
 
     // Aggregated statistics.
     std::map<LogLevel, LevelStats>  m_levelStats;    ///< Stats per log level.
-    std::map<std::string, SourceStats> m_sourceStats;///< Stats per source component.
+    std::vector<SourceStats>        m_sourceStats;   ///< Stats per source, indexed by SourceId.
 };
 
 } // namespace core
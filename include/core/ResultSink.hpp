@@ -0,0 +1,111 @@
+// File: C:\Project\include\core\ResultSink.hpp
+//
+// Caller-owned output buffer for batch detection: detectors append their
+// results tagged with the index of the entry that produced them.
+
+#ifndef CORE_RESULT_SINK_HPP
+#define CORE_RESULT_SINK_HPP
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace core
+{
+
+/**
+ * @brief Append-only buffer of (entry index, result) pairs.
+ *
+ * Responsibilities:
+ *  - Collect the results a detector produces for a batch, in the order the
+ *    entries were processed.
+ *  - Let the caller merge the outputs of several detectors back into
+ *    per-entry order via the index.
+ *
+ * Design notes:
+ *  - The caller owns the sink and reuses it across batches: clear() keeps
+ *    the capacity, so steady-state batch processing does not allocate.
+ *  - Indices are positions in the batch passed to processBatch(), so they
+ *    are non-decreasing within one call.
+ */
+template <typename T>
+class ResultSink
+{
+public:
+    struct Item
+    {
+        std::size_t index; ///< Position of the producing entry in its batch.
+        T           value;
+    };
+
+    void emit(std::size_t index, T value)
+    {
+        m_items.push_back(Item{index, std::move(value)});
+    }
+
+    void clear() noexcept { m_items.clear(); }
+
+    std::size_t size() const noexcept { return m_items.size(); }
+    bool        empty() const noexcept { return m_items.empty(); }
+
+    const Item& operator[](std::size_t i) const noexcept { return m_items[i]; }
+    Item&       operator[](std::size_t i) noexcept { return m_items[i]; }
+
+    auto begin() noexcept { return m_items.begin(); }
+    auto end() noexcept { return m_items.end(); }
+    auto begin() const noexcept { return m_items.begin(); }
+    auto end() const noexcept { return m_items.end(); }
+
+    /**
+     * @brief Append the items of several sinks, merged by entry index.
+     *
+     * Each part must be ordered by index (as produced by processBatch()).
+     * Used to recombine the outputs of detectors that processed disjoint
+     * subsets of one batch (source shards); parts are left empty.
+     */
+    void mergeByIndex(std::vector<ResultSink>& parts)
+    {
+        std::vector<std::size_t> next(parts.size(), 0);
+        for (;;)
+        {
+            std::size_t best = parts.size();
+            for (std::size_t p = 0; p < parts.size(); ++p)
+            {
+                if (next[p] < parts[p].size() &&
+                    (best == parts.size() || parts[p][next[p]].index < parts[best][next[best]].index))
+                {
+                    best = p;
+                }
+            }
+            if (best == parts.size())
+            {
+                break;
+            }
+            m_items.push_back(std::move(parts[best][next[best]++]));
+        }
+        for (auto& part : parts)
+        {
+            part.clear();
+        }
+    }
+
+    /// Move the values out (dropping the indices) and clear the sink.
+    std::vector<T> takeValues()
+    {
+        std::vector<T> out;
+        out.reserve(m_items.size());
+        for (auto& item : m_items)
+        {
+            out.push_back(std::move(item.value));
+        }
+        m_items.clear();
+        return out;
+    }
+
+private:
+    std::vector<Item> m_items;
+};
+
+} // namespace core
+
+#endif // CORE_RESULT_SINK_HPP
@@ -0,0 +1,140 @@
+// File: C:\Project\include\core\SourceTable.hpp
+//
+// Process-wide interning table for source/service names.
+// Each distinct name is stored once and identified by a dense integer ID,
+// so analysis modules can index flat arrays instead of hashing strings.
+
+#ifndef CORE_SOURCE_TABLE_HPP
+#define CORE_SOURCE_TABLE_HPP
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace core
+{
+
+/// Dense identifier of an interned source name.
+using SourceId = std::uint32_t;
+
+/// Reserved ID meaning "entry has no source".
+constexpr SourceId kNoSource = 0;
+
+/**
+ * @brief Interning table mapping source names <-> dense SourceIds.
+ *
+ * Responsibilities:
+ *  - Hand out one stable ID per distinct name (IDs are 1, 2, 3, ... in
+ *    first-seen order; kNoSource is reserved for "no source").
+ *  - Resolve IDs back to names at report time.
+ *
+ * Design notes:
+ *  - Names live in a std::deque, so references returned by name()/
+ *    optionalName() stay valid for the lifetime of the table.
+ *  - Thread-safe: lookups take a shared lock, inserting a new name an
+ *    exclusive one (rare: a log has a handful of distinct sources).
+ *  - ID assignment order depends on parse order; code that prints
+ *    per-source results must order by name, not by ID.
+ */
+class SourceTable
+{
+public:
+    SourceTable()
+    {
+        m_names.emplace_back(std::nullopt); // slot for kNoSource
+    }
+
+    SourceTable(const SourceTable&)            = delete;
+    SourceTable& operator=(const SourceTable&) = delete;
+
+    /// The table shared by the parser, analyzers and reports.
+    static SourceTable& global()
+    {
+        static SourceTable table;
+        return table;
+    }
+
+    /**
+     * @brief Return the ID of 'name', adding it on first use.
+     *
+     * An empty name maps to kNoSource.
+     */
+    SourceId intern(std::string_view name)
+    {
+        if (name.empty())
+        {
+            return kNoSource;
+        }
+
+        {
+            std::shared_lock<std::shared_mutex> lock(m_mutex);
+            const auto it = m_index.find(name);
+            if (it != m_index.end())
+            {
+                return it->second;
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        const auto it = m_index.find(name);
+        if (it != m_index.end())
+        {
+            return it->second; // another thread won the race
+        }
+        const auto id = static_cast<SourceId>(m_names.size());
+        const std::string& stored = *m_names.emplace_back(std::string(name));
+        m_index.emplace(std::string_view(stored), id);
+        return id;
+    }
+
+    /// Look up an existing name without adding it.
+    std::optional<SourceId> find(std::string_view name) const
+    {
+        if (name.empty())
+        {
+            return kNoSource;
+        }
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        const auto it = m_index.find(name);
+        if (it == m_index.end())
+        {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    /// Name of 'id' (std::nullopt for kNoSource or an unknown ID).
+    const std::optional<std::string>& optionalName(SourceId id) const
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        return id < m_names.size() ? m_names[id] : m_names[kNoSource];
+    }
+
+    /// Name of 'id', or 'fallback' when the ID carries no name.
+    std::string nameOr(SourceId id, std::string_view fallback) const
+    {
+        const auto& name = optionalName(id);
+        return name ? *name : std::string(fallback);
+    }
+
+    /// Number of IDs handed out so far, including kNoSource (IDs are < size()).
+    std::size_t size() const
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        return m_names.size();
+    }
+
+private:
+    mutable std::shared_mutex                      m_mutex;
+    std::deque<std::optional<std::string>>         m_names; ///< Indexed by SourceId.
+    std::unordered_map<std::string_view, SourceId> m_index; ///< Views into m_names.
+};
+
+} // namespace core
+
+#endif // CORE_SOURCE_TABLE_HPP
@@ -0,0 +1,77 @@
+// File: C:\Project\include\core\Span.hpp
+//
+// Minimal non-owning view over a contiguous sequence (C++17 stand-in for
+// std::span), used to hand batches of entries to analyzers and detectors.
+
+#ifndef CORE_SPAN_HPP
+#define CORE_SPAN_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace core
+{
+
+/**
+ * @brief Pointer + length view over contiguous elements.
+ *
+ * Design notes:
+ *  - Implicitly constructible from any container exposing data()/size()
+ *    (std::vector, std::array, EntryBatch::entries()), so call sites can
+ *    pass containers directly.
+ *  - Never owns or copies elements; the viewed storage must outlive it.
+ */
+template <typename T>
+class Span
+{
+public:
+    using element_type = T;
+    using iterator     = T*;
+
+    constexpr Span() noexcept = default;
+
+    constexpr Span(T* data, std::size_t size) noexcept
+        : m_data(data), m_size(size)
+    {
+    }
+
+    template <typename Container,
+              typename = std::enable_if_t<
+                  std::is_convertible_v<decltype(std::declval<Container&>().data()), T*>>>
+    constexpr Span(Container& c) noexcept
+        : m_data(c.data()), m_size(c.size())
+    {
+    }
+
+    constexpr T*          data() const noexcept { return m_data; }
+    constexpr std::size_t size() const noexcept { return m_size; }
+    constexpr bool        empty() const noexcept { return m_size == 0; }
+
+    constexpr T& operator[](std::size_t i) const noexcept { return m_data[i]; }
+
+    constexpr iterator begin() const noexcept { return m_data; }
+    constexpr iterator end() const noexcept { return m_data + m_size; }
+
+    /// Elements [offset, offset + count), clamped to the view.
+    constexpr Span subspan(std::size_t offset, std::size_t count) const noexcept
+    {
+        if (offset > m_size)
+        {
+            offset = m_size;
+        }
+        if (count > m_size - offset)
+        {
+            count = m_size - offset;
+        }
+        return Span(m_data + offset, count);
+    }
+
+private:
+    T*          m_data = nullptr;
+    std::size_t m_size = 0;
+};
+
+} // namespace core
+
+#endif // CORE_SPAN_HPP
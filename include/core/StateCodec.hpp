@@ -0,0 +1,288 @@
+// File: C:\Project\include\core\StateCodec.hpp
+//
+// Compact binary encoding of analysis state (detector windows, counters,
+// retained entries and anomalies), used to persist run checkpoints.
+
+#ifndef CORE_STATE_CODEC_HPP
+#define CORE_STATE_CODEC_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "core/Anomaly.hpp"
+#include "core/LogEntry.hpp"
+#include "core/TextArena.hpp"
+
+namespace core
+{
+
+/**
+ * @brief Appends state values to a byte string.
+ *
+ * Design notes:
+ *  - Scalars are stored in native byte order and width: a checkpoint is
+ *    read back by the same build on the same machine, not exchanged.
+ *  - Strings and containers are length-prefixed; time points are stored
+ *    as system_clock ticks.
+ *  - putVarint() stores an unsigned integer in 1-10 bytes (LEB128, 7 bits
+ *    a byte), for large tables of mostly small numbers.
+ *  - Source IDs are written as-is; the checkpoint stores the SourceTable
+ *    names so the IDs can be re-interned identically before reading.
+ */
+class StateWriter
+{
+public:
+    template <typename T>
+    void put(T value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "put() takes plain values");
+        const std::size_t at = m_bytes.size();
+        m_bytes.resize(at + sizeof(T));
+        std::memcpy(&m_bytes[at], &value, sizeof(T));
+    }
+
+    void putSize(std::size_t n) { put<std::uint64_t>(n); }
+
+    void putVarint(std::uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            m_bytes.push_back(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        m_bytes.push_back(static_cast<char>(value));
+    }
+
+    void putString(std::string_view text)
+    {
+        putSize(text.size());
+        m_bytes.append(text.data(), text.size());
+    }
+
+    void putOptionalString(const std::optional<std::string>& text)
+    {
+        put<std::uint8_t>(text ? 1 : 0);
+        if (text)
+        {
+            putString(*text);
+        }
+    }
+
+    void putTime(std::chrono::system_clock::time_point tp)
+    {
+        put<std::int64_t>(tp.time_since_epoch().count());
+    }
+
+    void putEntry(const LogEntry& entry)
+    {
+        putTime(entry.timestamp());
+        put(entry.level());
+        put(entry.sourceId());
+        put(entry.templateId());
+        putString(entry.message());
+        const auto raw = entry.rawLine();
+        put<std::uint8_t>(raw ? 1 : 0);
+        if (raw)
+        {
+            putString(*raw);
+        }
+    }
+
+    /// Any sequence of time points (vector, deque).
+    template <typename Container>
+    void putTimes(const Container& times)
+    {
+        putSize(times.size());
+        for (const auto& tp : times)
+        {
+            putTime(tp);
+        }
+    }
+
+    /// Any sequence of entries (vector, deque).
+    template <typename Container>
+    void putEntries(const Container& entries)
+    {
+        putSize(entries.size());
+        for (const auto& e : entries)
+        {
+            putEntry(e);
+        }
+    }
+
+    void putAnomaly(const Anomaly& anomaly)
+    {
+        put(anomaly.type());
+        put(anomaly.severity());
+        putTime(anomaly.windowStart());
+        putTime(anomaly.windowEnd());
+        put(anomaly.score());
+        putString(anomaly.description());
+        putOptionalString(anomaly.source());
+        putEntries(anomaly.relatedEntries());
+    }
+
+    const std::string& bytes() const noexcept { return m_bytes; }
+    std::string take() noexcept { return std::move(m_bytes); }
+
+private:
+    std::string m_bytes;
+};
+
+/**
+ * @brief Reads values written by StateWriter, in the same order.
+ *
+ * Throws std::runtime_error when the data ends early or a length is
+ * implausible, so a damaged checkpoint is rejected instead of restored.
+ * Entries read back share text blocks allocated by this reader.
+ */
+class StateReader
+{
+public:
+    explicit StateReader(std::string_view bytes) noexcept
+        : m_bytes(bytes)
+    {
+    }
+
+    template <typename T>
+    T get()
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "get() returns plain values");
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    std::size_t getSize()
+    {
+        const auto n = get<std::uint64_t>();
+        // Every counted element takes at least one byte.
+        if (n > remaining())
+        {
+            throw std::runtime_error("state: bad length");
+        }
+        return static_cast<std::size_t>(n);
+    }
+
+    std::uint64_t getVarint()
+    {
+        std::uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7)
+        {
+            const auto byte = static_cast<unsigned char>(*take(1));
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return value;
+            }
+        }
+        throw std::runtime_error("state: bad varint");
+    }
+
+    std::string_view getStringView()
+    {
+        const std::size_t n = getSize();
+        return std::string_view(take(n), n);
+    }
+
+    std::string getString() { return std::string(getStringView()); }
+
+    std::optional<std::string> getOptionalString()
+    {
+        if (get<std::uint8_t>() == 0)
+        {
+            return std::nullopt;
+        }
+        return getString();
+    }
+
+    std::chrono::system_clock::time_point getTime()
+    {
+        using Clock = std::chrono::system_clock;
+        return Clock::time_point(Clock::duration(get<std::int64_t>()));
+    }
+
+    LogEntry getEntry()
+    {
+        const auto ts      = getTime();
+        const auto level   = get<LogLevel>();
+        const auto source  = get<SourceId>();
+        const auto tmpl    = get<TemplateId>();
+        const auto message = getStringView();
+        std::optional<std::string_view> raw;
+        if (get<std::uint8_t>() != 0)
+        {
+            raw = getStringView();
+        }
+        LogEntry entry(ts, level, source, message, raw, m_arena);
+        entry.setTemplateId(tmpl);
+        return entry;
+    }
+
+    /// Replace the contents of 'times' (vector, deque).
+    template <typename Container>
+    void getTimes(Container& times)
+    {
+        times.clear();
+        for (std::size_t n = getSize(); n > 0; --n)
+        {
+            times.push_back(getTime());
+        }
+    }
+
+    /// Replace the contents of 'entries' (vector, deque).
+    template <typename Container>
+    void getEntries(Container& entries)
+    {
+        entries.clear();
+        for (std::size_t n = getSize(); n > 0; --n)
+        {
+            entries.push_back(getEntry());
+        }
+    }
+
+    Anomaly getAnomaly()
+    {
+        const auto type        = get<AnomalyType>();
+        const auto severity    = get<AnomalySeverity>();
+        const auto start       = getTime();
+        const auto end         = getTime();
+        const auto score       = get<double>();
+        auto       description = getString();
+        auto       source      = getOptionalString();
+        std::vector<LogEntry> related;
+        getEntries(related);
+        return Anomaly(type, severity, start, end, score, std::move(description),
+                       std::move(source), std::move(related));
+    }
+
+    std::size_t remaining() const noexcept { return m_bytes.size() - m_pos; }
+    bool atEnd() const noexcept { return m_pos == m_bytes.size(); }
+
+private:
+    const char* take(std::size_t n)
+    {
+        if (n > remaining())
+        {
+            throw std::runtime_error("state: truncated");
+        }
+        const char* p = m_bytes.data() + m_pos;
+        m_pos += n;
+        return p;
+    }
+
+    std::string_view m_bytes;
+    std::size_t      m_pos = 0;
+    TextArenaWriter  m_arena;
+};
+
+} // namespace core
+
+#endif // CORE_STATE_CODEC_HPP
@@ -0,0 +1,146 @@
+// File: C:\Project\include\core\TextArena.hpp
+//
+// Append-only character blocks backing the text of LogEntry objects.
+// Many entries share one block, so parsing a line costs a memcpy into the
+// current block instead of one or more heap allocations per entry.
+
+#ifndef CORE_TEXT_ARENA_HPP
+#define CORE_TEXT_ARENA_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <utility>
+
+namespace core
+{
+
+/**
+ * @brief Fixed-capacity, append-only block of characters.
+ *
+ * Design notes:
+ *  - Text is copied in once and never moves, so views into a block stay
+ *    valid for as long as the block is alive.
+ *  - Blocks are reference counted (std::shared_ptr): every LogEntry keeps
+ *    the block holding its text alive, and a block is freed when the last
+ *    entry referring to it goes away.
+ *  - A block can also stand for text owned elsewhere (a mapped entry cache),
+ *    holding only a reference to its owner.
+ */
+class TextArena
+{
+public:
+    explicit TextArena(std::size_t capacity)
+        : m_data(new char[capacity > 0 ? capacity : 1]),
+          m_capacity(capacity)
+    {
+    }
+
+    /**
+     * @brief Read-only block over memory owned by 'owner' (e.g. a mapped
+     *        file): nothing can be appended, and the block keeps 'owner' alive.
+     */
+    explicit TextArena(std::shared_ptr<const void> owner) noexcept
+        : m_owner(std::move(owner))
+    {
+    }
+
+    TextArena(const TextArena&)            = delete;
+    TextArena& operator=(const TextArena&) = delete;
+
+    /// Bytes still free in this block.
+    std::size_t remaining() const noexcept
+    {
+        return m_capacity - m_used;
+    }
+
+    /**
+     * @brief Copy 'text' into the block and return where it was stored.
+     *
+     * The caller must check remaining() first.
+     */
+    const char* append(std::string_view text) noexcept
+    {
+        char* dst = m_data.get() + m_used;
+        if (!text.empty())
+        {
+            std::memcpy(dst, text.data(), text.size());
+        }
+        m_used += text.size();
+        return dst;
+    }
+
+private:
+    std::unique_ptr<char[]> m_data;
+    std::size_t             m_capacity = 0;
+    std::size_t             m_used     = 0;
+    std::shared_ptr<const void> m_owner; ///< Keeps borrowed text alive (no m_data then).
+};
+
+/**
+ * @brief Hands out space from a chain of TextArena blocks (one "batch" each).
+ *
+ * Responsibilities:
+ *  - Keep a current block and open a new one when the next text does not fit.
+ *  - Give text larger than a block its own exactly-sized block.
+ *
+ * Design notes:
+ *  - Not thread-safe: use one writer per thread (the parser keeps a
+ *    thread_local writer).
+ *  - Blocks are small enough that the few entries analyzers retain for
+ *    samples do not pin much memory.
+ */
+class TextArenaWriter
+{
+public:
+    static constexpr std::size_t kDefaultBlockSize = 32 * 1024;
+
+    explicit TextArenaWriter(std::size_t blockSize = kDefaultBlockSize)
+        : m_blockSize(blockSize)
+    {
+    }
+
+    /**
+     * @brief Store 'first' immediately followed by 'second' in one block.
+     *
+     * @param[out] block Block now holding the text (keeps it alive);
+     *                   left unchanged when there is no text.
+     * @return Pointer to the first stored character.
+     */
+    const char* write(std::string_view first,
+                      std::string_view second,
+                      std::shared_ptr<const TextArena>& block)
+    {
+        const std::size_t size = first.size() + second.size();
+        if (size == 0)
+        {
+            return "";
+        }
+        if (size > m_blockSize)
+        {
+            auto own = std::make_shared<TextArena>(size);
+            const char* start = own->append(first);
+            own->append(second);
+            block = std::move(own);
+            return start;
+        }
+
+        if (!m_current || m_current->remaining() < size)
+        {
+            m_current = std::make_shared<TextArena>(m_blockSize);
+        }
+        const char* start = m_current->append(first);
+        m_current->append(second);
+        block = m_current;
+        return start;
+    }
+
+private:
+    std::size_t                m_blockSize;
+    std::shared_ptr<TextArena> m_current;
+};
+
+} // namespace core
+
+#endif // CORE_TEXT_ARENA_HPP
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "core/LogEntry.hpp"
+
+namespace LogTool
+{
+    namespace Input
+    {
+        /**
+         * Checkpoint
+         *
+         * Responsibilities:
+         *  - Remember how far an append-only log has been analysed: which file
+         *    (device/inode), the offset of the first byte not yet analysed, the
+         *    last entry timestamp, and the analysis state at that point.
+         *  - Decide whether a later run may resume from it, so that it only
+         *    analyses the appended tail and still reports what a full re-run
+         *    would.
+         *
+         * Design notes:
+         *  - The offset is always at a line boundary; a trailing line without
+         *    its newline yet is left for the next run.
+         *  - Replacement of the file under the same name is caught by the inode
+         *    (POSIX) and by a fingerprint of the bytes just before the offset,
+         *    which also catches copytruncate followed by regrowth.
+         *  - The analysis state is an opaque blob (core::StateWriter bytes)
+         *    owned by the caller; 'layout' names the detector configuration it
+         *    was taken with, and a checksum guards it against damage.
+         *  - save() writes "<path>.tmp" and renames it over the old file, so an
+         *    interrupted run never leaves a torn checkpoint behind.
+         */
+        class Checkpoint
+        {
+        public:
+            struct FileIdentity
+            {
+                std::uint64_t device = 0;
+                std::uint64_t inode  = 0; ///< 0 on Windows (no inode numbers).
+                std::uint64_t size   = 0;
+            };
+
+            /// Bytes before the offset covered by the fingerprint.
+            static constexpr std::size_t kFingerprintBytes = 4096;
+
+            std::string               inputPath;
+            FileIdentity              file;        ///< Input file at the time of the checkpoint.
+            std::uint64_t             offset = 0;  ///< First byte not analysed yet.
+            std::uint64_t             fingerprint = 0;
+            core::LogEntry::TimePoint lastTimestamp{};
+            std::string               layout;      ///< Detector layout the state belongs to.
+            std::string               state;       ///< Serialized analysis state.
+
+            /// Identity of the file at 'path' (nullopt if it cannot be stat'ed).
+            static std::optional<FileIdentity> identify(const std::string &path);
+
+            /// Fingerprint of the kFingerprintBytes of 'data' ending at 'offset'.
+            static std::uint64_t fingerprintAt(std::string_view data, std::uint64_t offset) noexcept;
+
+            /// Same fingerprint, read from the file (nullopt if it is shorter than 'offset').
+            static std::optional<std::uint64_t> fingerprintFile(const std::string &path, std::uint64_t offset);
+
+            /// Write atomically; returns false (and logs) on I/O failure.
+            bool save(const std::string &path) const;
+
+            /// Read a checkpoint; nullopt if missing, damaged or from another version (logged).
+            static std::optional<Checkpoint> load(const std::string &path);
+
+            /**
+             * Why this checkpoint cannot be resumed on the file 'current', whose
+             * full contents are 'data', with detector layout 'currentLayout';
+             * empty when it can.
+             */
+            std::string mismatch(const FileIdentity &current, std::string_view data,
+                                 const std::string &currentLayout) const;
+        };
+
+    } // namespace Input
+} // namespace LogTool
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "utils/SpscQueue.hpp"
+
+namespace LogTool
+{
+    namespace Input
+    {
+        /**
+         * Compressed log input (rotated "app.log.1.gz" and the like).
+         *
+         * Responsibilities:
+         *  - Recognise gzip and zstd data by their magic bytes.
+         *  - Decompress a whole compressed file as a stream of output pieces,
+         *    never holding more than one piece of decompressed text.
+         *
+         * Design notes:
+         *  - gzip is decoded by a built-in inflater (RFC 1951/1952, multi-member
+         *    files, CRC-32 and length checked), so no zlib is needed.
+         *  - zstd uses libzstd and is only available when built with
+         *    LOGTOOL_WITH_ZSTD defined and linked to libzstd (the CMake option
+         *    -DLOGTOOL_WITH_ZSTD=ON does both); otherwise such input is
+         *    rejected with a hint naming that option.
+         *  - Corrupt or truncated data throws std::runtime_error after the
+         *    output decoded so far has been passed on.
+         */
+        enum class Compression
+        {
+            None,
+            Gzip,
+            Zstd
+        };
+
+        /// Compression format of data starting with 'head' (a few bytes suffice).
+        Compression detectCompression(std::string_view head) noexcept;
+
+        /// "gzip", "zstd" or "none".
+        const char *compressionName(Compression kind) noexcept;
+
+        /// Whether this build can decompress 'kind'.
+        bool compressionSupported(Compression kind) noexcept;
+
+        /// How to get a build that decompresses 'kind' ("" if this one does).
+        const char *compressionHint(Compression kind) noexcept;
+
+        /// Receives decompressed output; returning false stops decompression.
+        using DecompressSink = std::function<bool(std::string_view)>;
+
+        /// Decompress all of 'input' into 'sink' (throws on corrupt or unsupported data).
+        void decompress(Compression kind, std::string_view input, const DecompressSink &sink);
+
+        /**
+         * DecompressStream
+         *
+         * Responsibilities:
+         *  - Decompress on a background thread, overlapping with parsing, and
+         *    hand the text to the reader as line-aligned chunks.
+         *
+         * Design notes:
+         *  - Chunks travel through a Utils::SpscQueue of 'queueDepth' slots, so
+         *    the decompressor runs at most that many chunks ahead (backpressure).
+         *  - Every chunk but the last ends with '\n', so lines never straddle
+         *    chunks; the decompressor thread also does that split.
+         *  - Destroying the stream stops the thread (the queue is closed and the
+         *    sink returns false).
+         */
+        class DecompressStream
+        {
+        public:
+            static constexpr std::size_t kDefaultChunkBytes = 1u << 20; // 1 MiB
+            static constexpr std::size_t kDefaultQueueDepth = 4;
+
+            /// Start decompressing 'input' (which must outlive the stream).
+            DecompressStream(Compression kind,
+                             std::string_view input,
+                             std::size_t chunkBytes = kDefaultChunkBytes,
+                             std::size_t queueDepth = kDefaultQueueDepth);
+
+            ~DecompressStream();
+
+            DecompressStream(const DecompressStream &)            = delete;
+            DecompressStream &operator=(const DecompressStream &) = delete;
+
+            /// Next chunk of text (blocks); false at the end of the data.
+            bool next(std::string &chunk);
+
+            /// Why decompression stopped early (empty if it did not); valid once next() returned false.
+            const std::string &error() const noexcept { return m_error; }
+
+            /// Decompressed bytes handed out so far.
+            std::uint64_t bytesOut() const noexcept { return m_bytesOut; }
+
+        private:
+            void produce();
+
+            Compression                     m_kind;
+            std::string_view                m_input;
+            std::size_t                     m_chunkBytes;
+            Utils::SpscQueue<std::string>   m_queue;
+            std::string                     m_error;     // written by the thread before close()
+            std::uint64_t                   m_bytesOut = 0;
+            std::thread                     m_thread;
+        };
+
+    } // namespace Input
+} // namespace LogTool
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/TextArena.hpp"
+#include "input/FileReader.hpp"
+#include "input/LogParser.hpp"
+
+namespace LogTool
+{
+    namespace Input
+    {
+        /**
+         * EntryCache
+         *
+         * Responsibilities:
+         *  - Keep the parse result of a log in a binary columnar sidecar file
+         *    ("<log>.lcache"), so re-running the same file with other settings
+         *    feeds the detectors without parsing the text again (--cache).
+         *  - Write it from the parsed batches of a normal run (Writer), and
+         *    replay it as the same batches, malformed lines included (run()).
+         *
+         * Design notes:
+         *  - The file is a header, a sequence of stripes and a fixed footer.
+         *    A stripe holds up to kStripeEntries entries as columns: timestamps
+         *    (clock ticks), message end offsets, source dictionary indices,
+         *    malformed-line positions and errors, levels (one byte), then one
+         *    string heap with the message text. Sources are dictionary encoded;
+         *    each stripe lists the names it adds to the dictionary.
+         *  - A checksum of every stripe is stored before the footer and checked
+         *    by open(), so a damaged cache is rewritten instead of replayed.
+         *  - Replay memory-maps the cache: entry messages are views into the
+         *    mapping (a TextArena over it keeps it alive), so no text is copied.
+         *  - The cache records size, modification time and head/tail
+         *    fingerprints of its log; any change to the log makes it stale.
+         *  - Raw lines are not stored, and a run with --since/--until neither
+         *    reads nor writes the cache.
+         *  - Writer streams stripes to "<cache>.tmp" and renames it on finish(),
+         *    so a torn cache is never picked up.
+         */
+        class EntryCache
+        {
+        public:
+            using Consumer = std::function<void(LogParser::ParsedBatch &)>;
+
+            /// Identity of the log file a cache was built from.
+            struct Source
+            {
+                std::uint64_t size = 0;
+                std::int64_t  mtime = 0;      // filesystem clock ticks
+                std::uint64_t headPrint = 0;  // fingerprint of the first bytes
+                std::uint64_t tailPrint = 0;  // fingerprint of the last bytes
+
+                bool operator==(const Source &other) const noexcept
+                {
+                    return size == other.size && mtime == other.mtime && headPrint == other.headPrint &&
+                           tailPrint == other.tailPrint;
+                }
+            };
+
+            /// Entries per stripe (a stripe also ends before its heap passes kStripeHeapBytes).
+            static constexpr std::size_t kStripeEntries = 1u << 16;
+            static constexpr std::size_t kStripeHeapBytes = 16u << 20; // 16 MiB
+
+            /// Sidecar path of 'logPath'.
+            static std::string sidecarPath(const std::string &logPath) { return logPath + ".lcache"; }
+
+            /// Identity of the log at 'logPath' (nullopt if it cannot be read).
+            static std::optional<Source> describe(const std::string &logPath);
+
+            /// Streams parsed batches, in file order, into a new cache file.
+            class Writer
+            {
+            public:
+                Writer(std::string path, const Source &source);
+                ~Writer();
+
+                Writer(const Writer &)            = delete;
+                Writer &operator=(const Writer &) = delete;
+
+                void add(const LogParser::ParsedBatch &batch);
+
+                /// Write the last stripe and the footer and move the file in place.
+                bool finish();
+
+            private:
+                void flushStripe();
+
+                std::string   m_path;
+                std::string   m_tmpPath;
+                std::ofstream m_out;
+                bool          m_failed = false;
+
+                // Current stripe, column by column.
+                std::vector<std::int64_t>  m_times;
+                std::vector<std::uint32_t> m_messageEnds;
+                std::vector<std::uint32_t> m_sources;
+                std::vector<std::uint8_t>  m_levels;
+                std::vector<std::uint32_t> m_badPositions;
+                std::vector<std::string>   m_badErrors;
+                std::vector<std::string>   m_newSources;
+                std::string                m_heap;
+
+                std::unordered_map<core::SourceId, std::uint32_t> m_dictionary; // ID -> index + 1
+                std::vector<std::uint64_t> m_checksums; // one per written stripe
+                std::uint64_t m_stripes = 0;
+                std::uint64_t m_entries = 0;
+                std::uint64_t m_malformed = 0;
+            };
+
+            /**
+             * Open the cache at 'path' if it was built from a log with identity
+             * 'source'. Returns nullopt when it is missing, stale or damaged,
+             * with the reason in 'whyNot' (empty when there is no cache).
+             */
+            static std::optional<EntryCache> open(const std::string &path, const Source &source, std::string &whyNot);
+
+            std::uint64_t entryCount() const noexcept { return m_entries; }
+            std::uint64_t malformedCount() const noexcept { return m_malformed; }
+
+            /**
+             * Call 'consume' with the cached batches (up to EntryBatch::kDefaultCapacity
+             * lines each) in file order. Throws std::runtime_error on damaged data.
+             */
+            void run(const Consumer &consume) const;
+
+        private:
+            EntryCache() = default;
+
+            std::shared_ptr<FileReader>           m_file;  // the mapping
+            std::shared_ptr<const core::TextArena> m_text; // keeps m_file alive for the entries
+            std::size_t   m_stripesBegin = 0;              // offset of the first stripe
+            std::size_t   m_stripesEnd = 0;                // offset of the footer
+            std::uint64_t m_stripes = 0;
+            std::uint64_t m_entries = 0;
+            std::uint64_t m_malformed = 0;
+        };
+
+    } // namespace Input
+} // namespace LogTool
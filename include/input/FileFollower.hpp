@@ -0,0 +1,108 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace LogTool
+{
+    namespace Input
+    {
+        /**
+         * FileFollower
+         *
+         * Responsibilities:
+         *  - Keep a log file open and hand out the complete lines appended to
+         *    it since the last call ("tail -F").
+         *  - Survive log rotation: a new file behind the path (rename to
+         *    app.log.1 + recreate, detected by device/inode change) is picked up
+         *    from its start after the old file has been drained; truncation in
+         *    place (copytruncate) restarts at offset 0.
+         *
+         * Design notes:
+         *  - On Linux, waits for changes with inotify on the file's directory
+         *    (so creates/renames are seen too); elsewhere it polls. Either way
+         *    a wait never exceeds the poll interval, which bounds latency.
+         *  - A trailing partial line is held back until its newline arrives
+         *    (or the file is rotated away).
+         *  - Reads at most 'maxReadBytes' per call, so a large backlog is
+         *    delivered in bounded chunks.
+         *  - Windows has no inode numbers: rotation is detected through
+         *    truncation only.
+         */
+        class FileFollower
+        {
+        public:
+            struct Options
+            {
+                std::chrono::milliseconds pollInterval{250}; ///< Longest wait per poll().
+                std::size_t               maxReadBytes = 1u << 20;
+            };
+
+            /**
+             * @param path        File to follow.
+             * @param startOffset Byte offset to resume from (clamped to the file size).
+             */
+            FileFollower(std::string path, std::uint64_t startOffset, Options options);
+            FileFollower(std::string path, std::uint64_t startOffset);
+
+            FileFollower(const FileFollower &)            = delete;
+            FileFollower &operator=(const FileFollower &) = delete;
+
+            ~FileFollower();
+
+            /// Open the file (and the change watch). Returns false if the file cannot be opened.
+            bool open();
+
+            /**
+             * Wait (up to the poll interval) for new data, then append the new
+             * complete lines to 'out', each terminated by '\n'.
+             * Returns the number of bytes appended (0 on timeout).
+             */
+            std::size_t poll(std::string &out);
+
+            /// Offset of the next unread byte in the current file.
+            std::uint64_t offset() const noexcept { return m_offset; }
+
+            /// Offset just past the last complete line handed out (excludes a held-back partial line).
+            std::uint64_t consumedOffset() const noexcept { return m_offset - m_pending.size(); }
+
+            /// Number of rotations/truncations handled so far.
+            std::size_t rotations() const noexcept { return m_rotations; }
+
+            const std::string &path() const noexcept { return m_path; }
+
+        private:
+            /// Block until the watch reports a change or the interval elapses.
+            void waitForChange();
+
+            /// Read up to maxReadBytes at m_offset into m_pending; returns bytes read.
+            std::size_t readMore();
+
+            /// After EOF: reopen on rotation, rewind on truncation. Returns true if the file changed.
+            bool checkRotation(std::string &out);
+
+            /// Move complete lines from m_pending to 'out'; returns bytes moved.
+            std::size_t takeLines(std::string &out);
+
+            bool openFile();
+            void closeFile() noexcept;
+
+            std::string   m_path;
+            Options       m_options;
+            std::uint64_t m_offset    = 0;
+            std::size_t   m_rotations = 0;
+            std::string   m_pending;          // bytes read but not yet a complete line
+            std::string   m_readBuffer;       // maxReadBytes scratch for one read
+            bool          m_backlog  = false; // last read filled maxReadBytes: do not wait
+
+            int           m_fd = -1;
+            std::uint64_t m_device = 0;
+            std::uint64_t m_inode  = 0;
+
+            int m_watchFd = -1; // inotify instance (Linux only)
+        };
+
+    } // namespace Input
+} // namespace LogTool
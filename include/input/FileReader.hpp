@@ -5,11 +5,16 @@
 #include <fstream>
 #include <optional>
 #include <mutex>
+#include <memory>
+#include <cstddef>
 
 namespace LogTool
 {
     namespace Input
     {
+        enum class Compression;
+        class DecompressStream;
+
         /**
          * FileReader
          *
@@ -19,7 +24,14 @@ namespace LogTool
          *  - Manage file resources via RAII.
          *
          * Design notes:
-         *  - Uses std::ifstream with an internal read buffer.
+         *  - Uses std::ifstream with an internal read buffer (Mode::Stream), or
+         *    a read-only memory mapping of the whole file (Mode::Mapped).
+         *  - In mapped mode nextLineView() hands out views straight into the
+         *    mapping, so no per-line heap allocation happens before parsing.
+         *  - gzip/zstd files are recognised by their magic bytes whatever mode
+         *    was asked for (Mode::Compressed): the compressed file is mapped and
+         *    a DecompressStream thread inflates it into line-aligned chunks
+         *    while the caller parses, so nothing is decompressed to disk.
          *  - Designed primarily for single-threaded ownership; callers can
          *    create multiple FileReader instances for parallel parsing of
          *    different files or file segments.
@@ -28,14 +40,21 @@ namespace LogTool
         class FileReader
         {
         public:
+            enum class Mode
+            {
+                Stream,     // std::ifstream + std::getline
+                Mapped,     // mmap / MapViewOfFile, zero-copy line views
+                Compressed  // gzip/zstd, decompressed on a background thread
+            };
+
             /// Default-constructed FileReader is not associated with any file.
-            FileReader() = default;
+            FileReader();
 
             /**
              * Construct and open a file immediately.
              * If open fails, isOpen() will return false.
              */
-            explicit FileReader(const std::string &filePath);
+            explicit FileReader(const std::string &filePath, Mode mode = Mode::Stream);
 
             // Non-copyable: owning a file handle should not be implicitly copied.
             FileReader(const FileReader &)            = delete;
@@ -52,8 +71,11 @@ namespace LogTool
              * Open a file for reading.
              * Returns true on success, false if opening fails.
              * Any previously open file is closed first.
+             *
+             * Mode::Mapped silently falls back to Mode::Stream when the file
+             * cannot be mapped (e.g. pipes or special files); check mode().
              */
-            bool open(const std::string &filePath);
+            bool open(const std::string &filePath, Mode mode = Mode::Stream);
 
             /// Close the underlying file stream explicitly (optional).
             void close() noexcept;
@@ -64,6 +86,12 @@ namespace LogTool
             /// Get the path of the currently opened file (empty if none).
             std::string filePath() const;
 
+            /// Mode actually in use for the open file.
+            Mode mode() const noexcept { return m_mode; }
+
+            /// Compression format of the open file (Compression::None unless mode() == Mode::Compressed).
+            Compression compression() const noexcept { return m_compression; }
+
             /**
              * Read the next line from the file.
              *
@@ -75,6 +103,52 @@ namespace LogTool
              */
             std::optional<std::string> nextLine();
 
+            /**
+             * Read the next line without copying it.
+             *
+             * The trailing '\n' and a Windows-style '\r' are stripped.
+             * In mapped mode the view points into the mapping and stays valid
+             * until the reader is closed; in stream and compressed mode it
+             * points into an internal buffer and is only valid until the next call.
+             */
+            std::optional<std::string_view> nextLineView();
+
+            /**
+             * Compressed mode: move the next block of decompressed text into
+             * 'chunk' instead of reading it line by line. Every block but the
+             * last ends with '\n'. Returns false at the end (logging a
+             * decompression error, if any) and in the other modes.
+             */
+            bool nextChunk(std::string &chunk);
+
+            /**
+             * Whole mapped file contents (empty unless mode() == Mode::Mapped).
+             * Lets callers split the file into ranges for parallel parsing.
+             */
+            std::string_view mappedData() const noexcept;
+
+            /**
+             * Restrict a mapped file to bytes [begin, end): mappedData() and
+             * nextLineView() then only see that range (e.g. the part of a log
+             * appended since a checkpoint). Returns false, changing nothing,
+             * in stream mode or when the range does not fit the mapping.
+             */
+            bool restrictTo(std::size_t begin, std::size_t end) noexcept;
+
+            /// File offset of the first byte of mappedData().
+            std::size_t mappedOffset() const noexcept { return m_viewBegin; }
+
+            /// Offset within mappedData() of the next line nextLineView() returns.
+            std::size_t mappedPosition() const noexcept { return m_mapPos; }
+
+            /**
+             * Split the line starting at 'pos' out of 'data' and advance 'pos'
+             * past its terminator. Applies the same '\n' / '\r\n' rules as
+             * nextLineView(); returns std::nullopt once 'pos' reaches the end.
+             */
+            static std::optional<std::string_view> nextLineIn(std::string_view data,
+                                                              std::size_t &pos) noexcept;
+
             /**
              * Reset the read position to the beginning of the file.
              * Returns true on success, false if not open or if seek fails.
@@ -85,9 +159,42 @@ namespace LogTool
             /// Helper to release any current file and reset state.
             void reset() noexcept;
 
+            /// Map the whole file read-only; returns false if mapping is not possible.
+            bool mapFile(const std::string &filePath);
+
+            /// Release the mapping (if any).
+            void unmapFile() noexcept;
+
+            /// Open a gzip/zstd file and start decompressing it.
+            bool openCompressed(const std::string &filePath, Compression kind);
+
+            /// The compressed bytes (mapping, or a copy for files that cannot be mapped).
+            std::string_view compressedData() const noexcept;
+
         private:
             std::ifstream m_stream;       // RAII-managed file stream
             std::string   m_filePath;     // path to the currently open file
+            std::string   m_lineBuffer;   // reused by nextLineView() in stream mode
+            Mode          m_mode = Mode::Stream;
+
+            // Mapped mode state
+            const char   *m_mapData = nullptr;
+            std::size_t   m_mapSize = 0;
+            std::size_t   m_mapPos  = 0;       // relative to m_viewBegin
+            std::size_t   m_viewBegin = 0;     // restrictTo() range within the mapping
+            std::size_t   m_viewEnd   = 0;
+            bool          m_mapOpen = false;
+
+            // Compressed mode state
+            Compression                       m_compression{};
+            std::unique_ptr<std::string>      m_compressedCopy; // stable address for the thread
+            std::unique_ptr<DecompressStream> m_decompress;
+            std::string                       m_chunk;          // current decompressed block
+            std::size_t                       m_chunkPos = 0;
+#if defined(_WIN32)
+            void         *m_fileHandle    = nullptr;
+            void         *m_mappingHandle = nullptr;
+#endif
         };
 
     } // namespace Input
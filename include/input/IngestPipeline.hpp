@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "input/FileReader.hpp"
+#include "input/LogParser.hpp"
+
+namespace LogTool
+{
+    namespace Input
+    {
+        /**
+         * IngestPipeline
+         *
+         * Responsibilities:
+         *  - Run ingestion as overlapping stages: one reader thread cuts the input
+         *    into line-aligned chunks, a pool of parser threads turns chunks into
+         *    LogParser::ParsedBatch objects, and the calling thread consumes the
+         *    batches (detection) strictly in file order.
+         *  - Bound memory with explicit backpressure: every stage edge is a
+         *    Utils::SpscQueue of 'queueDepth' slots, so a slow consumer stalls the
+         *    parsers, which in turn stall the reader.
+         *
+         * Design notes:
+         *  - Chunk k goes to parser k % N and its batch is read back from parser
+         *    k % N, so order is restored without locks or reordering buffers: each
+         *    reader->parser and parser->consumer edge is single-producer/single-consumer.
+         *  - Mapped input is passed as views into the mapping; streamed input is
+         *    copied into owned chunks (freed once parsed: entries keep their text
+         *    in arenas), and compressed input hands over its decompressed blocks.
+         *  - Throughput approaches the slowest stage instead of the sum of stages.
+         */
+        class IngestPipeline
+        {
+        public:
+            using Batch    = std::shared_ptr<LogParser::ParsedBatch>;
+            using Consumer = std::function<void(const Batch &)>;
+
+            /// Default slots per queue (chunks or batches in flight per edge).
+            static constexpr std::size_t kDefaultQueueDepth = 4;
+
+            /// Default size of one reader chunk.
+            static constexpr std::size_t kDefaultChunkBytes = 1u << 20; // 1 MiB
+
+            /**
+             * @param parser        Parser shared by all parser threads (must outlive this object).
+             * @param parserThreads Parser thread count (at least 1).
+             * @param queueDepth    Capacity of every inter-stage queue (at least 1).
+             * @param chunkBytes    Target size of one reader chunk.
+             */
+            IngestPipeline(const LogParser &parser,
+                           std::size_t parserThreads,
+                           std::size_t queueDepth = kDefaultQueueDepth,
+                           std::size_t chunkBytes = kDefaultChunkBytes);
+
+            IngestPipeline(const IngestPipeline &)            = delete;
+            IngestPipeline &operator=(const IngestPipeline &) = delete;
+
+            /**
+             * Read 'reader' to the end through the pipeline, calling 'consume' on
+             * the calling thread once per batch in file order. Empty lines are
+             * skipped. Blocks until every stage has finished.
+             */
+            void run(FileReader &reader, const Consumer &consume);
+
+        private:
+            /// One line-aligned piece of input.
+            struct Chunk
+            {
+                std::string_view             text;
+                std::shared_ptr<std::string> owned;      // set for streamed input
+                std::size_t                  offset = 0; // within the mapped data (mapped input)
+            };
+
+            const LogParser &m_parser;
+            std::size_t      m_parserThreads;
+            std::size_t      m_queueDepth;
+            std::size_t      m_chunkBytes;
+        };
+
+    } // namespace Input
+} // namespace LogTool
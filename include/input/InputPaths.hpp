@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace LogTool
+{
+    namespace Input
+    {
+        /**
+         * Input path expansion for the command line.
+         *
+         * Responsibilities:
+         *  - Turn the input arguments into the list of files to analyse: a plain
+         *    path is kept as given, a directory contributes the regular files
+         *    directly inside it, and a glob pattern ('*', '?', '[...]' in the
+         *    file name part) the files it matches.
+         *
+         * Design notes:
+         *  - Globs are matched here rather than relying on the shell, so quoted
+         *    patterns and shells without globbing (cmd.exe) work the same.
+         *  - Directory and glob results are sorted by name, so the input order
+         *    (the merge tie-break for equal timestamps) does not depend on the
+         *    file system; hidden files ('.name') and the tool's sidecar files
+         *    ('.idx' time indexes, '.lcache' entry caches) are skipped.
+         *  - A file named twice (e.g. via a directory and explicitly) is kept once,
+         *    at its first position.
+         */
+
+        /// True if 'name' matches the glob 'pattern' ('*', '?', '[abc]', '[a-z]', '[!a]').
+        bool globMatch(std::string_view pattern, std::string_view name) noexcept;
+
+        /**
+         * Expand 'args' into input files, in argument order. Arguments that name
+         * an empty directory or a pattern matching nothing are added to 'unmatched'.
+         * Plain paths are not checked for existence (opening them reports that).
+         */
+        std::vector<std::string> expandInputPaths(const std::vector<std::string> &args,
+                                                  std::vector<std::string> &unmatched);
+
+    } // namespace Input
+} // namespace LogTool
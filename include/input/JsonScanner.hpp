@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace LogTool
+{
+    namespace Input
+    {
+        /**
+         * JsonScanner
+         *
+         * Responsibilities:
+         *  - Walk one JSON log object (a single line) exactly once and capture the
+         *    values of a caller-supplied set of top-level keys.
+         *  - Decode JSON string escapes, including \uXXXX and surrogate pairs, to UTF-8.
+         *
+         * Design notes:
+         *  - No DOM and no allocation while scanning: captured values are views into
+         *    the line; only decode() produces an owned string.
+         *  - String bodies are skipped by searching for the next '"' or '\\' 16 bytes
+         *    at a time with SSE2 when the target supports it (scalar fallback otherwise).
+         *  - Nested objects/arrays are skipped; only top-level members are matched.
+         *  - Best effort: on malformed input the values captured so far are kept.
+         *  - Stateless static functions (thread-safe).
+         */
+        class JsonScanner
+        {
+        public:
+            /// One captured member value.
+            struct Value
+            {
+                std::string_view raw;            // string body without quotes, or scalar text
+                bool             found = false;
+                bool             isString = false;
+                bool             hasEscapes = false;
+            };
+
+            /**
+             * Scan the object in 'json' once. For each top-level member whose key equals
+             * keys[i], store its value in out[i] (first occurrence wins).
+             *
+             * Returns false if the object is structurally malformed.
+             */
+            static bool scanObject(std::string_view json,
+                                   const std::string_view *keys,
+                                   std::size_t keyCount,
+                                   Value *out) noexcept;
+
+            /// Owned text of a value (escapes decoded for strings).
+            static std::string decode(const Value &value);
+
+            /// Append the unescaped form of a JSON string body to 'out'.
+            static void appendUnescaped(std::string_view body, std::string &out);
+
+            /// First '"' or '\\' in [p, end), or 'end' if there is none.
+            static const char *findQuoteOrBackslash(const char *p, const char *end) noexcept;
+        };
+
+    } // namespace Input
+} // namespace LogTool
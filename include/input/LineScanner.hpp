@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+#include "../core/LogEntry.hpp"
+
+namespace LogTool
+{
+    namespace Input
+    {
+        /**
+         * ScannedLine
+         *
+         * Field offsets found by one left-to-right pass over a text log line.
+         * All members are views into the scanned line (nothing is owned).
+         */
+        struct ScannedLine
+        {
+            std::string_view line;        // the (trimmed) line that was scanned
+            std::string_view timestamp;   // empty if the line does not start with one
+            std::string_view level;       // level token without brackets (empty if none)
+            std::size_t      bodyBegin = 0; // offset of the first non-space after the level
+
+            /// True if the line starts with "TIMESTAMP LEVEL" followed by whitespace.
+            bool hasPrefix() const noexcept { return !level.empty() && bodyBegin < line.size(); }
+
+            /// Everything after the level token and its trailing whitespace.
+            std::string_view body() const noexcept { return line.substr(bodyBegin); }
+        };
+
+        /**
+         * LineScanner
+         *
+         * Responsibilities:
+         *  - Find the timestamp, level token (bare or bracketed) and body offsets of a
+         *    line in a single pass, without allocating.
+         *  - Provide the field-level matching primitives shared with PatternMatcher.
+         *
+         * Design notes:
+         *  - Stateless static functions (thread-safe).
+         *  - The scan is done once per line; every compiled template then reuses it.
+         */
+        class LineScanner
+        {
+        public:
+            /// Scan "TIMESTAMP LEVEL body..." from the start of 'line'.
+            static ScannedLine scan(std::string_view line) noexcept;
+
+            /**
+             * Length of a timestamp at the start of 's' (0 if there is none).
+             * See Utils::timestampLength() for the accepted forms.
+             */
+            static std::size_t matchTimestamp(std::string_view s) noexcept;
+
+            /**
+             * Match a bare ("INFO") or bracketed ("[INFO]") level token at the start
+             * of 's'. Sets 'token' to the letters and returns the consumed length
+             * (0 if there is none).
+             */
+            static std::size_t matchLevel(std::string_view s, std::string_view &token) noexcept;
+
+            /// Map a level word to a LogLevel, case-insensitively ("warning" -> Warn).
+            static std::optional<core::LogLevel> levelFromToken(std::string_view token) noexcept;
+
+            static bool isSpace(char c) noexcept
+            {
+                return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+            }
+        };
+
+    } // namespace Input
+} // namespace LogTool
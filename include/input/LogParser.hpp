@@ -8,9 +8,11 @@
 
 
 #include "../core/LogEntry.hpp"
+#include "../core/EntryBatch.hpp"
 // Bridge: core headers use LogTool::core (lowercase). Allow Core::... in this module.
 namespace LogTool { namespace Core = core; }
 #include "FileReader.hpp"
+#include "PatternMatcher.hpp"
 #include "../utils/StringUtils.hpp"
 #include "../utils/TimeUtils.hpp"
 
@@ -27,10 +29,16 @@ namespace LogTool
          *  - Gracefully skip malformed log entries (reliability).
          *
          * Design notes:
-         *  - Stateless parsing logic (thread-safe).
-         *  - Supports configurable parsing rules via patterns.
+         *  - Parsing is const and thread-safe; only configuration (patterns,
+         *    detectFormat) mutates the parser and must happen before sharing it.
+         *  - Supports configurable parsing rules via patterns, compiled once into
+         *    PatternMatcher programs and tried in priority order.
+         *  - detectFormat() promotes the template that dominates a file sample,
+         *    so uniform files match on the first attempt.
          *  - Works with FileReader's streaming interface.
          *  - Returns std::optional<LogEntry> to indicate parse success/failure.
+         *  - Entry text is packed into per-thread TextArena blocks (no per-entry
+         *    allocation); the raw line is kept only with setKeepRawLines(true).
          */
         class LogParser
         {
@@ -45,10 +53,45 @@ namespace LogTool
                 std::string error; // best-effort parse error
             };
 
+            // A line that failed to parse, placed relative to the entries of its batch.
+            struct MalformedLine
+            {
+                std::size_t position = 0; // number of batch entries that precede this line
+                std::string error;
+            };
+
+            // Parse output for a run of consecutive lines (see parseInto()).
+            struct ParsedBatch
+            {
+                Core::EntryBatch entries;
+                std::vector<MalformedLine> malformed; // in input order
+
+                // Byte range [inputBegin, inputEnd) of the parsed lines within the
+                // reader's mapped data, when the producer knows it (0, 0 otherwise).
+                std::size_t inputBegin = 0;
+                std::size_t inputEnd   = 0;
+
+                // parseInto(): the last parsed line was outside the time range
+                // (kept across clear(), so a reused batch continues the input).
+                bool outOfRange = false;
+
+                void clear()
+                {
+                    entries.clear();
+                    malformed.clear();
+                    inputBegin = inputEnd = 0;
+                }
+
+                std::size_t lineCount() const noexcept { return entries.size() + malformed.size(); }
+            };
+
             /// Default constructor with common log format patterns.
             LogParser();
 
-            // Stateless and copyable (all parsing is pure functions).
+            /// Number of lines detectFormat() samples by default.
+            static constexpr std::size_t kDetectSampleLines = 2000;
+
+            // Copyable (configuration only; all parsing is pure functions).
             LogParser(const LogParser &)            = default;
             LogParser &operator=(const LogParser &) = default;
 
@@ -72,6 +115,14 @@ namespace LogTool
              */
             ParseResult parseLineDetailed(std::string_view rawLine) const;
 
+            /**
+             * Parse a line and append the outcome to a batch: the entry goes to
+             * out.entries, a failure to out.malformed (with the same error text
+             * parseLineDetailed() reports). With a time range set, entries
+             * outside it are dropped, and so are malformed lines that follow one.
+             */
+            void parseInto(std::string_view rawLine, ParsedBatch &out) const;
+
             /**
              * Parse lines directly from a FileReader stream.
              *
@@ -83,12 +134,14 @@ namespace LogTool
             /**
              * Add a custom parsing pattern.
              *
-             * Format: "TIMESTAMP LEVEL SOURCE: MESSAGE"
-             * Example patterns the parser tries:
+             * Format: "%timestamp% %level% %source%: %message%" (see PatternMatcher)
+             * Example lines the default patterns accept:
              *   - "2023-10-03 14:23:45 INFO app1: User login failed"
-             *   - "[2023-10-03T14:23:45] ERROR database Connection timeout"
+             *   - "2023-10-03 14:23:45 [ERROR] database - Connection timeout"
+             *
+             * Returns false (and ignores the pattern) if it cannot be compiled.
              */
-            void addPattern(std::string pattern);
+            bool addPattern(std::string pattern);
 
             /// Clear all parsing patterns (use only custom ones).
             void clearPatterns();
@@ -96,31 +149,54 @@ namespace LogTool
             /// Get the current set of parsing patterns (for debugging/config).
             const std::vector<std::string>& patterns() const noexcept;
 
+            /**
+             * Sample up to 'maxLines' text lines from the start of 'sample' and move
+             * the pattern that matches most of them to the front of the try order.
+             * The remaining patterns keep their configured priority.
+             *
+             * Returns the index (into patterns()) of the promoted pattern, or
+             * std::nullopt if no sampled line matched any pattern.
+             */
+            std::optional<std::size_t> detectFormat(std::string_view sample,
+                                                    std::size_t maxLines = kDetectSampleLines);
+
+            /**
+             * Only keep entries with since <= timestamp < until in parseInto()
+             * (either bound may be open). Used for --since/--until.
+             */
+            void setTimeRange(std::optional<Utils::TimePoint> since, std::optional<Utils::TimePoint> until) noexcept
+            {
+                m_since = since;
+                m_until = until;
+            }
+            bool hasTimeRange() const noexcept { return m_since || m_until; }
+
+            /// Keep the original line in parsed entries (LogEntry::rawLine()). Off by default.
+            void setKeepRawLines(bool keep) noexcept { m_keepRawLines = keep; }
+            bool keepRawLines() const noexcept { return m_keepRawLines; }
+
         private:
-            // Lightweight JSON extraction helpers (no external JSON dependency).
+            // JSON lines: one JsonScanner pass per line (no external JSON dependency).
             std::optional<Core::LogEntry> tryParseJsonLine(std::string_view line, std::string* errOut) const;
-            static std::optional<std::string> extractJsonString(std::string_view json, std::string_view key);
-            static std::optional<std::string> extractJsonRaw(std::string_view json, std::string_view key);
             static std::string_view trimSv(std::string_view s);
-            /// Try to parse a specific log format pattern from the line.
+            /// Try to parse a scanned line with one compiled pattern.
             std::optional<Core::LogEntry> tryParsePattern(
-                std::string_view line,
-                std::string_view pattern) const;
-
-            /// Extract timestamp using common formats.
-            std::optional<Utils::TimePoint> extractTimestamp(std::string_view line) const;
-
-            /// Extract log level from common level strings.
-            std::optional<Core::LogLevel> extractLevel(std::string_view line) const;
+                const ScannedLine &scan,
+                const PatternMatcher &matcher) const;
 
-            /// Extract source/service name (before colon or in brackets).
-            std::optional<std::string> extractSource(std::string_view line) const;
+            /// Convert a matched timestamp field (see Utils::parseLogTimestamp).
+            std::optional<Utils::TimePoint> extractTimestamp(std::string_view field) const;
 
-            /// Extract the main message content.
-            std::optional<std::string> extractMessage(std::string_view line) const;
+            /// Restore the configured try order (after patterns change).
+            void resetOrder();
 
         private:
-            std::vector<std::string> m_patterns;
+            std::vector<std::string>    m_patterns;   // template text, configured priority
+            std::vector<PatternMatcher> m_matchers;   // compiled, parallel to m_patterns
+            std::vector<std::size_t>    m_order;      // try order (indices into m_matchers)
+            bool                        m_keepRawLines = false;
+            std::optional<Utils::TimePoint> m_since;  // setTimeRange()
+            std::optional<Utils::TimePoint> m_until;
         };
 
     } // namespace Input
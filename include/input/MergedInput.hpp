@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "input/LogParser.hpp"
+
+namespace LogTool
+{
+    namespace Input
+    {
+        /**
+         * MergedInput
+         *
+         * Responsibilities:
+         *  - Read several log files (e.g. one per service plus rotated siblings)
+         *    as one stream in timestamp order, so time-ordered detectors see the
+         *    events correctly interleaved without an external 'cat | sort'.
+         *  - Parse the files in parallel on a pool of at most 'threads' workers
+         *    and merge the parsed streams on the calling thread with a k-way
+         *    heap merge.
+         *
+         * Design notes:
+         *  - Each file is assumed to be in time order (as written by its logger);
+         *    the merge only interleaves files, so an out-of-order line keeps its
+         *    place relative to its own file.
+         *  - Equal timestamps are taken in input order, so the merged stream is
+         *    deterministic.
+         *  - Each file gets a copy of the parser with its own detectFormat(), so
+         *    files in different formats each match their template first.
+         *  - A malformed line is passed on right after the entry before it in its
+         *    file, so it is counted in that entry's minute as with a single file.
+         *  - A file is only opened (mapped, with its own parser) once the merge
+         *    reaches its first timestamp, found up front by parsing its first
+         *    lines, and is released when exhausted. Rotated siblings are read
+         *    one after the other, so open files and parsers are bounded by the
+         *    number of files that overlap in time, not by the file count.
+         *  - Pool tasks parse one batch of one file and never block; a file is
+         *    parsed ahead by at most 'queueDepth' batches, so memory is bounded
+         *    by open files x depth batches.
+         */
+        class MergedInput
+        {
+        public:
+            using Consumer = std::function<void(LogParser::ParsedBatch &)>;
+
+            /// Default batches in flight per file.
+            static constexpr std::size_t kDefaultQueueDepth = 4;
+
+            /**
+             * @param parser     Template parser, copied per file (configure it first).
+             * @param paths      Input files; their order breaks timestamp ties.
+             * @param queueDepth Parsed batches buffered per file (at least 1).
+             * @param threads    Parser threads (0 = hardware concurrency).
+             */
+            MergedInput(const LogParser &parser,
+                        std::vector<std::string> paths,
+                        std::size_t queueDepth = kDefaultQueueDepth,
+                        std::size_t threads = 1);
+
+            MergedInput(const MergedInput &)            = delete;
+            MergedInput &operator=(const MergedInput &) = delete;
+
+            /// Check that every file can be opened; false if any cannot (logged).
+            bool open();
+
+            /// Total size in bytes of the opened files.
+            std::uint64_t totalBytes() const noexcept { return m_totalBytes; }
+
+            const std::vector<std::string> &paths() const noexcept { return m_paths; }
+
+            /**
+             * Parse all files and call 'consume' on the calling thread with batches
+             * of up to EntryBatch::kDefaultCapacity lines in merged order. Blocks
+             * until every file has been read.
+             */
+            void run(const Consumer &consume);
+
+        private:
+            const LogParser          &m_parser;
+            std::vector<std::string>  m_paths;
+            std::size_t               m_queueDepth;
+            std::size_t               m_threads;
+            std::uint64_t             m_totalBytes = 0;
+        };
+
+    } // namespace Input
+} // namespace LogTool
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+#include "input/LogParser.hpp"
+#include "utils/ThreadPool.hpp"
+
+namespace LogTool
+{
+    namespace Input
+    {
+        /**
+         * ParallelParser
+         *
+         * Responsibilities:
+         *  - Split one in-memory (usually memory-mapped) log file into byte
+         *    ranges aligned to newline boundaries.
+         *  - Parse the ranges concurrently, each into one LogParser::ParsedBatch.
+         *  - Deliver the batches to a single consumer strictly in file order,
+         *    so downstream detectors see exactly what the serial loop would.
+         *
+         * Design notes:
+         *  - Ranges are submitted ahead to a ThreadPool (bounded look-ahead), and
+         *    consumed front to back as their futures complete; memory stays
+         *    proportional to lookahead * chunkBytes, not the file size.
+         *  - Empty lines are skipped, matching the serial ingest loop.
+         *  - The LogParser is shared read-only between workers (it is stateless).
+         */
+        class ParallelParser
+        {
+        public:
+            using Consumer = std::function<void(LogParser::ParsedBatch &)>;
+
+            /// Default range size handed to a single worker.
+            static constexpr std::size_t kDefaultChunkBytes = 1u << 20; // 1 MiB
+
+            /**
+             * @param parser     Parser shared by all workers (must outlive this object).
+             * @param threads    Worker count; 0 = hardware concurrency.
+             * @param chunkBytes Target size of one byte range.
+             */
+            ParallelParser(const LogParser &parser,
+                           std::size_t threads,
+                           std::size_t chunkBytes = kDefaultChunkBytes);
+
+            ParallelParser(const ParallelParser &)            = delete;
+            ParallelParser &operator=(const ParallelParser &) = delete;
+
+            /**
+             * Parse every non-empty line of 'data' and call 'consume' once per
+             * range with its batch, in file order. Blocks until the whole buffer
+             * is consumed.
+             */
+            void parse(std::string_view data, const Consumer &consume);
+
+            /// Number of worker threads in use.
+            std::size_t threadCount() const noexcept { return m_pool.size(); }
+
+            /**
+             * Split 'data' into consecutive ranges of roughly 'chunkBytes' each.
+             * Every range except possibly the last ends just after a '\n', so no
+             * line straddles two ranges.
+             */
+            static std::vector<std::string_view> splitRanges(std::string_view data,
+                                                             std::size_t chunkBytes);
+
+        private:
+            const LogParser  &m_parser;
+            std::size_t       m_chunkBytes;
+            Utils::ThreadPool m_pool;
+        };
+
+    } // namespace Input
+} // namespace LogTool
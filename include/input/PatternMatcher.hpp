@@ -0,0 +1,92 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <optional>
+#include <vector>
+
+#include "LineScanner.hpp"
+
+namespace LogTool
+{
+    namespace Input
+    {
+        /**
+         * PatternMatcher
+         *
+         * Responsibilities:
+         *  - Compile one LogParser template (e.g. "%timestamp% %level% %source%: %message%")
+         *    into a flat token program, once.
+         *  - Match a raw line against that program and report the field slices.
+         *
+         * Design notes:
+         *  - Template syntax: %timestamp%, %level%, %source%, %message% are fields,
+         *    a space matches one or more whitespace characters, "\\x" is a literal x,
+         *    every other character is matched literally.
+         *  - %message% must be the last field and captures the rest of the line.
+         *  - %level% accepts a bare or a bracketed token ("INFO" / "[INFO]").
+         *  - Matching only slices the input (no allocation); field validation such as
+         *    timestamp conversion is left to the caller.
+         *  - Templates starting with "%timestamp% %level% " skip straight to the body
+         *    offset found by LineScanner, so the line prefix is scanned once per line
+         *    rather than once per template.
+         *  - Immutable after compile(), so one matcher can be shared between threads.
+         */
+        class PatternMatcher
+        {
+        public:
+            /// Slices of the matched line (empty when the template lacks the field).
+            struct Fields
+            {
+                std::string_view timestamp;
+                std::string_view level;
+                std::string_view source;
+                std::string_view message;
+            };
+
+            /**
+             * Compile a template.
+             * Returns std::nullopt for templates that cannot be matched
+             * (unknown field name, %message% not last, no timestamp field).
+             */
+            static std::optional<PatternMatcher> compile(std::string_view pattern);
+
+            /// Match a scanned (trimmed) line; on success fill 'out' and return true.
+            bool match(const ScannedLine &scan, Fields &out) const;
+
+            /// Original template text.
+            const std::string &pattern() const noexcept { return m_pattern; }
+
+        private:
+            enum class TokenKind
+            {
+                Literal,     // exact text
+                Space,       // one or more whitespace characters
+                Timestamp,
+                Level,
+                Source,
+                Message
+            };
+
+            struct Token
+            {
+                TokenKind   kind;
+                std::string text;   // Literal only
+            };
+
+            PatternMatcher() = default;
+
+            /// Match tokens [firstToken, end) against line[pos..], starting from 'f'.
+            bool matchFrom(std::string_view line,
+                           std::size_t pos,
+                           std::size_t firstToken,
+                           Fields f,
+                           Fields &out) const;
+
+            std::vector<Token> m_tokens;
+            std::string        m_pattern;
+            bool               m_scanPrefix = false; // tokens 0..3 are "%timestamp% %level% "
+        };
+
+    } // namespace Input
+} // namespace LogTool
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "core/LogEntry.hpp"
+#include "input/LogParser.hpp"
+
+namespace LogTool
+{
+    namespace Input
+    {
+        /**
+         * TimeIndex
+         *
+         * Responsibilities:
+         *  - Sparse sidecar index ("<log>.idx") mapping the time range of every
+         *    block of about kDefaultBlockBytes of a log to its byte range, so
+         *    --since/--until read only the blocks that can hold matching lines.
+         *  - Built from the parsed batches of a normal run (--index) or by the
+         *    'index' subcommand, and checked against the log before use.
+         *
+         * Design notes:
+         *  - Blocks end on line boundaries, so they are as fine as the target
+         *    size (the search resolution of searchSorted()) whatever the size
+         *    of the parsed batches; a range query reads at most about one
+         *    block more than the matching lines at either end.
+         *  - Blocks keep the minimum and maximum timestamp of their entries, so
+         *    a file with local disorder is still answered correctly. When both
+         *    stay non-decreasing over the file (the usual case) the blocks are
+         *    found by binary search, otherwise by a linear pass over the index.
+         *  - The index covers a prefix of the file; lines appended later are
+         *    read as well when the range reaches past the indexed end.
+         *  - A fingerprint of the bytes before the indexed end (as for
+         *    checkpoints) detects a rewritten or rotated file.
+         *  - Without an index, searchSorted() binary-searches the file itself
+         *    when sampled timestamps show it is in time order, then checks the
+         *    lines outside the range found (parsing, but none of the analysis)
+         *    so entries out of place are never dropped.
+         */
+        class TimeIndex
+        {
+        public:
+            using TimePoint = core::LogEntry::TimePoint;
+
+            struct Block
+            {
+                std::uint64_t begin = 0; ///< First byte.
+                std::uint64_t end   = 0; ///< One past the last byte (a line boundary).
+                TimePoint     minTs{};   ///< Earliest entry in the block.
+                TimePoint     maxTs{};   ///< Latest entry in the block.
+            };
+
+            /// Target block size (blocks end at the first line boundary past it).
+            static constexpr std::uint64_t kDefaultBlockBytes = 64u << 10; // 64 KiB
+
+            /// Collects the parsed batches of a file, in file order, into blocks.
+            class Builder
+            {
+            public:
+                explicit Builder(std::uint64_t blockBytes = kDefaultBlockBytes);
+
+                /// 'batch' was parsed (without a time range) from 'text', the file bytes from offset 'begin'.
+                void add(std::uint64_t begin, std::string_view text, const LogParser::ParsedBatch &batch);
+
+                /// Finish the index; 'data' is the file contents up to the indexed end.
+                TimeIndex finish(std::string_view data);
+
+            private:
+                /// The line [begin, end) was read; 'time' is set when it parsed as an entry.
+                void addLine(std::uint64_t begin, std::uint64_t end, const TimePoint *time);
+
+                /// Mark the last block if it has no time (see finish()).
+                void closeBlock();
+
+                std::uint64_t            m_blockBytes;
+                std::vector<Block>       m_blocks;
+                bool                     m_open = false;    // last block still growing
+                bool                     m_hasTime = false; // last block has a time
+                std::optional<TimePoint> m_lastTime;        // time of the last entry so far
+            };
+
+            /// Sidecar path of 'logPath'.
+            static std::string sidecarPath(const std::string &logPath) { return logPath + ".idx"; }
+
+            /// Write atomically; returns false (and logs) on I/O failure.
+            bool save(const std::string &path) const;
+
+            /// Read an index; nullopt if missing, damaged or from another version.
+            static std::optional<TimeIndex> load(const std::string &path);
+
+            /// Whether the index still describes 'data' (the file's current contents).
+            bool matches(std::string_view data) const noexcept;
+
+            /**
+             * Byte range of a file of 'fileSize' bytes that holds every entry with
+             * since <= timestamp < until (open bounds when unset).
+             */
+            std::pair<std::uint64_t, std::uint64_t> range(std::optional<TimePoint> since,
+                                                          std::optional<TimePoint> until,
+                                                          std::uint64_t fileSize) const;
+
+            /**
+             * Same range, found by binary search over a file without an index.
+             * Returns nullopt when 'data' is not in time order, so the range
+             * cannot be trusted: a sample of timestamps is out of order, a line
+             * outside the range has a timestamp inside it, or no line parses.
+             */
+            static std::optional<std::pair<std::size_t, std::size_t>> searchSorted(std::string_view data,
+                                                                                 const LogParser &parser,
+                                                                                 std::optional<TimePoint> since,
+                                                                                 std::optional<TimePoint> until);
+
+            const std::vector<Block> &blocks() const noexcept { return m_blocks; }
+            std::uint64_t coveredBytes() const noexcept { return m_covered; }
+            bool sorted() const noexcept { return m_sorted; }
+
+        private:
+            std::vector<Block> m_blocks;
+            std::uint64_t      m_covered = 0;     // the index describes bytes [0, m_covered)
+            std::uint64_t      m_fingerprint = 0; // of the bytes before m_covered
+            bool               m_sorted = false;  // minTs and maxTs non-decreasing
+        };
+
+    } // namespace Input
+} // namespace LogTool
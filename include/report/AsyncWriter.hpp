@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "utils/Logger.hpp"
+#include "utils/SpscQueue.hpp"
+
+namespace LogTool
+{
+    namespace Report
+    {
+        /**
+         * AsyncWriter
+         *
+         * Responsibilities:
+         *  - Own one dedicated output thread that runs formatting/writing jobs
+         *    in submission order, so exporting overlaps with analysis.
+         *  - Bound the backlog: submit() blocks once 'queueDepth' jobs are
+         *    pending (backpressure instead of unbounded memory growth).
+         *
+         * Design notes:
+         *  - Jobs travel over a Utils::SpscQueue: submit() must be called from
+         *    one thread at a time (the analysis thread).
+         *  - A job that throws is logged and skipped; later jobs still run.
+         *  - finish() (or the destructor) drains the queue and joins the thread;
+         *    data referenced by jobs must stay alive until then.
+         *  - Jobs report through log(), not the global logger directly: their
+         *    messages are held and written by finish() on the calling thread,
+         *    so they never interleave with console output printed meanwhile.
+         */
+        class AsyncWriter
+        {
+        public:
+            using Job = std::function<void()>;
+
+            static constexpr std::size_t kDefaultQueueDepth = 64;
+
+            explicit AsyncWriter(std::size_t queueDepth = kDefaultQueueDepth);
+
+            AsyncWriter(const AsyncWriter&) = delete;
+            AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+            ~AsyncWriter();
+
+            /// Queue a job for the writer thread (blocks while the queue is full).
+            void submit(Job job);
+
+            /// Run all pending jobs, stop the thread and write the held log messages. Idempotent.
+            void finish();
+
+            /// Log from a job: held until finish(). Thread-safe.
+            void log(Utils::LogLevel level, std::string message);
+
+        private:
+            void run();
+
+            Utils::SpscQueue<Job> m_jobs;
+            std::thread           m_thread;
+
+            std::mutex                                          m_logMutex;
+            std::vector<std::pair<Utils::LogLevel, std::string>> m_held; // job messages, in order
+        };
+
+        /**
+         * BufferedFile
+         *
+         * Output file with a large user-supplied stream buffer, so row-by-row
+         * exports turn into few large write() calls. Used on the writer thread.
+         */
+        class BufferedFile
+        {
+        public:
+            static constexpr std::size_t kDefaultBufferBytes = 1u << 20; // 1 MiB
+
+            explicit BufferedFile(const std::string& path,
+                                  std::ios::openmode mode = std::ios::out | std::ios::trunc,
+                                  std::size_t bufferBytes = kDefaultBufferBytes);
+
+            bool isOpen() const { return m_out.is_open(); }
+
+            void write(std::string_view text) { m_out.write(text.data(), static_cast<std::streamsize>(text.size())); }
+
+            std::ostream& stream() noexcept { return m_out; }
+
+            /// Flush and close (also done by the destructor).
+            void close();
+
+        private:
+            std::unique_ptr<char[]> m_buffer; // must outlive m_out
+            std::ofstream           m_out;
+        };
+
+    } // namespace Report
+} // namespace LogTool
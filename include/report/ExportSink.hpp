@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/EntryBatch.hpp"
+#include "core/Report.hpp"
+#include "report/AsyncWriter.hpp"
+
+namespace LogTool
+{
+    namespace Report
+    {
+        /// Per-minute counters of one run (time-series export).
+        struct MinuteCounts
+        {
+            std::uint64_t total = 0, trace = 0, debug = 0, info = 0, warn = 0, error = 0, critical = 0, unknown = 0,
+                          anomalies = 0, malformed = 0;
+        };
+
+        /// Minute bucket (epoch seconds, multiple of 60) -> counters.
+        using MinuteSeries = std::map<std::time_t, MinuteCounts>;
+
+        /**
+         * IExportSink
+         *
+         * Responsibilities:
+         *  - Receive the run's output as it is produced: parsed batches during
+         *    the single ingest pass, the final report and time series at the end.
+         *  - Hand all formatting and file I/O to the shared AsyncWriter thread.
+         *
+         * Design notes:
+         *  - Callbacks come from the analysis thread, batches in file order.
+         *  - onFinish() arguments must stay alive until AsyncWriter::finish().
+         */
+        class IExportSink
+        {
+        public:
+            virtual ~IExportSink() = default;
+
+            virtual void onBatch(const core::EntryBatch& /*batch*/) {}
+
+            virtual void onFinish(const core::Report& /*report*/, const MinuteSeries& /*series*/) {}
+        };
+
+        /**
+         * entries.csv: one row per parsed entry (timestamp, level, source, message),
+         * streamed batch by batch during the first (and only) parse.
+         * With 'append', rows are added to an existing file (a run resumed from
+         * a checkpoint only parses the new lines); the header is written only
+         * when the file is new.
+         */
+        class EntriesCsvSink final : public IExportSink
+        {
+        public:
+            EntriesCsvSink(AsyncWriter& writer, std::string path, bool append = false);
+
+            void onBatch(const core::EntryBatch& batch) override;
+            void onFinish(const core::Report& report, const MinuteSeries& series) override;
+
+        private:
+            struct State; // writer-thread side: file, per-second/per-source caches
+
+            AsyncWriter&           m_writer;
+            std::shared_ptr<State> m_state;
+        };
+
+        /// timeseries_per_minute.csv, written once the run is complete.
+        class TimeSeriesCsvSink final : public IExportSink
+        {
+        public:
+            TimeSeriesCsvSink(AsyncWriter& writer, std::string path);
+
+            void onFinish(const core::Report& report, const MinuteSeries& series) override;
+
+        private:
+            AsyncWriter& m_writer;
+            std::string  m_path;
+        };
+
+        /// analysis-report.json (JsonReporter, pretty-printed).
+        class JsonReportSink final : public IExportSink
+        {
+        public:
+            JsonReportSink(AsyncWriter& writer, std::string path);
+
+            void onFinish(const core::Report& report, const MinuteSeries& series) override;
+
+        private:
+            AsyncWriter& m_writer;
+            std::string  m_path;
+        };
+
+        /// analysis-report.csv (CsvReporter, anomalies only).
+        class CsvReportSink final : public IExportSink
+        {
+        public:
+            CsvReportSink(AsyncWriter& writer, std::string path);
+
+            void onFinish(const core::Report& report, const MinuteSeries& series) override;
+
+        private:
+            AsyncWriter& m_writer;
+            std::string  m_path;
+        };
+
+    } // namespace Report
+} // namespace LogTool
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace LogTool
+{
+    namespace Utils
+    {
+        /**
+         * CountMinSketch
+         *
+         * Responsibilities:
+         *  - Estimate how often each 64-bit key was counted, in fixed memory
+         *    (depth rows of width counters), however many distinct keys arrive.
+         *
+         * Design notes:
+         *  - An estimate never undercounts: it is the true count plus whatever
+         *    colliding keys added, so an estimate of 0 means "never seen".
+         *  - Conservative update: add() only raises the counters that are below
+         *    the new estimate, which keeps the overcount of rare keys small.
+         *  - Keys are expected to be well mixed already (hash values); each row
+         *    remixes the key with its own seed and masks it (width is a power
+         *    of two). Counters saturate instead of wrapping.
+         */
+        class CountMinSketch
+        {
+        public:
+            static constexpr std::size_t kDefaultWidth = 1u << 18;
+            static constexpr std::size_t kDefaultDepth = 4;
+
+            explicit CountMinSketch(std::size_t width = kDefaultWidth, std::size_t depth = kDefaultDepth)
+                : m_width(roundUpPow2(width)),
+                  m_depth(std::max<std::size_t>(depth, 1)),
+                  m_counters(m_width * m_depth, 0)
+            {
+            }
+
+            /// Count 'key' 'count' more times; returns its new estimate.
+            std::uint64_t add(std::uint64_t key, std::uint64_t count) noexcept
+            {
+                const std::uint64_t target = estimate(key) + count;
+                const std::uint32_t capped = static_cast<std::uint32_t>(
+                    std::min<std::uint64_t>(target, std::numeric_limits<std::uint32_t>::max()));
+                for (std::size_t row = 0; row < m_depth; ++row)
+                {
+                    std::uint32_t &counter = m_counters[slot(key, row)];
+                    counter = std::max(counter, capped);
+                }
+                return capped;
+            }
+
+            /// Upper bound of the number of times 'key' was counted.
+            std::uint64_t estimate(std::uint64_t key) const noexcept
+            {
+                std::uint32_t lowest = std::numeric_limits<std::uint32_t>::max();
+                for (std::size_t row = 0; row < m_depth; ++row)
+                    lowest = std::min(lowest, m_counters[slot(key, row)]);
+                return lowest;
+            }
+
+            void clear() noexcept { std::fill(m_counters.begin(), m_counters.end(), 0); }
+
+            std::size_t width() const noexcept { return m_width; }
+            std::size_t depth() const noexcept { return m_depth; }
+
+            /// All counters, row by row (for checkpoints).
+            const std::vector<std::uint32_t> &counters() const noexcept { return m_counters; }
+            std::vector<std::uint32_t> &counters() noexcept { return m_counters; }
+
+        private:
+            static std::size_t roundUpPow2(std::size_t n) noexcept
+            {
+                std::size_t p = 1;
+                while (p < n)
+                    p <<= 1;
+                return p;
+            }
+
+            std::size_t slot(std::uint64_t key, std::size_t row) const noexcept
+            {
+                // splitmix64 finalizer over key + per-row seed
+                std::uint64_t x = key + 0x9e3779b97f4a7c15ull * (row + 1);
+                x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+                x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+                x ^= x >> 31;
+                return row * m_width + static_cast<std::size_t>(x & (m_width - 1));
+            }
+
+            std::size_t                m_width;
+            std::size_t                m_depth;
+            std::vector<std::uint32_t> m_counters; // m_depth rows of m_width
+        };
+
+    } // namespace Utils
+} // namespace LogTool
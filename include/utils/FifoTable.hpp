@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+namespace LogTool
+{
+    namespace Utils
+    {
+        /**
+         * FifoTable
+         *
+         * Responsibilities:
+         *  - Map keys to values in at most 'capacity' entries, forgetting the
+         *    oldest insertion first once full (keys are never refreshed, so
+         *    insertion order is recency order).
+         *
+         * Design notes:
+         *  - Entries sit in a deque in insertion order plus a key -> sequence
+         *    number map, so push(), find() and take() are O(1) on average.
+         *  - take() leaves a hole in the deque; holes at the front are dropped
+         *    right away and the deque is compacted once holes outnumber the
+         *    entries, so it never holds more than twice size() nodes.
+         */
+        template <typename Key, typename Value, typename Hash = std::hash<Key>>
+        class FifoTable
+        {
+        public:
+            explicit FifoTable(std::size_t capacity) : m_capacity(capacity > 0 ? capacity : 1) {}
+
+            std::size_t capacity() const noexcept { return m_capacity; }
+            std::size_t size() const noexcept { return m_index.size(); }
+
+            /// Entries forgotten to make room so far.
+            std::uint64_t agedOut() const noexcept { return m_agedOut; }
+
+            /// Change the capacity; lowering it below size() forgets on the next push().
+            void setCapacity(std::size_t capacity) noexcept { m_capacity = capacity > 0 ? capacity : 1; }
+
+            /**
+             * Insert a key that is not in the table. Returns the key of the
+             * entry forgotten to make room, if any.
+             */
+            std::optional<Key> push(const Key &key, Value value)
+            {
+                std::optional<Key> forgotten;
+                while (size() >= m_capacity)
+                {
+                    forgotten = m_nodes.front().key;
+                    m_index.erase(m_nodes.front().key);
+                    popFront();
+                    ++m_agedOut;
+                    dropFrontHoles();
+                }
+                m_index.emplace(key, m_first + m_nodes.size());
+                m_nodes.push_back(Node{key, std::move(value), true});
+                return forgotten;
+            }
+
+            /// Value of 'key', or nullptr if it is not in the table.
+            const Value *find(const Key &key) const
+            {
+                const auto it = m_index.find(key);
+                return it != m_index.end() ? &m_nodes[it->second - m_first].value : nullptr;
+            }
+
+            /// Remove 'key' and move its value to 'out'; false if it is not in the table.
+            bool take(const Key &key, Value &out)
+            {
+                const auto it = m_index.find(key);
+                if (it == m_index.end())
+                    return false;
+                Node &node = m_nodes[it->second - m_first];
+                out = std::move(node.value);
+                node.value = Value{};
+                node.live = false;
+                m_index.erase(it);
+                ++m_holes;
+                dropFrontHoles();
+                if (m_holes > size())
+                    compact();
+                return true;
+            }
+
+            /// Call f(key, value) for every entry, oldest first.
+            template <typename F>
+            void forEach(F &&f) const
+            {
+                for (const auto &node : m_nodes)
+                {
+                    if (node.live)
+                        f(node.key, node.value);
+                }
+            }
+
+            void clear() noexcept
+            {
+                m_nodes.clear();
+                m_index.clear();
+                m_first = 0;
+                m_holes = 0;
+                m_agedOut = 0;
+            }
+
+            /// Make room for 'n' entries without rehashing (checkpoints).
+            void reserve(std::size_t n) { m_index.reserve(n); }
+
+            /// Append an entry as the newest (checkpoints, oldest first); the table must not be full.
+            void restore(const Key &key, Value value, std::uint64_t agedOut)
+            {
+                m_index.emplace(key, m_first + m_nodes.size());
+                m_nodes.push_back(Node{key, std::move(value), true});
+                m_agedOut = agedOut;
+            }
+
+        private:
+            struct Node
+            {
+                Key   key{};
+                Value value{};
+                bool  live = true; ///< false once taken
+            };
+
+            void popFront()
+            {
+                m_nodes.pop_front();
+                ++m_first;
+            }
+
+            void dropFrontHoles()
+            {
+                while (!m_nodes.empty() && !m_nodes.front().live)
+                {
+                    --m_holes;
+                    popFront();
+                }
+            }
+
+            void compact()
+            {
+                std::deque<Node> live;
+                for (auto &node : m_nodes)
+                {
+                    if (node.live)
+                    {
+                        m_index[node.key] = m_first + live.size();
+                        live.push_back(std::move(node));
+                    }
+                }
+                m_nodes.swap(live);
+                m_holes = 0;
+            }
+
+            std::size_t                                 m_capacity;
+            std::deque<Node>                            m_nodes;     // insertion order, with holes
+            std::unordered_map<Key, std::uint64_t, Hash> m_index;    // key -> sequence number
+            std::uint64_t                               m_first = 0; // sequence number of m_nodes.front()
+            std::size_t                                 m_holes = 0;
+            std::uint64_t                               m_agedOut = 0;
+        };
+
+    } // namespace Utils
+} // namespace LogTool
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace LogTool
+{
+    namespace Utils
+    {
+        /**
+         * FlatCounter
+         *
+         * Responsibilities:
+         *  - Count occurrences of small fixed-size keys (integers, IP addresses)
+         *    in one flat array, without a node allocation per key.
+         *
+         * Design notes:
+         *  - Open addressing with linear probing over a power-of-two table,
+         *    kept at most half full; slots are {key, count}, so a 32-bit key
+         *    costs 8 bytes per slot.
+         *  - A count of 0 marks an empty slot (every stored key was counted at
+         *    least once), so no key value has to be reserved as "empty".
+         *  - Counts saturate at 2^32 - 1 instead of wrapping.
+         *  - Keys are never removed one by one (clear() drops all of them).
+         *  - Hash output is remixed (splitmix64 finalizer), so identity hashes
+         *    such as std::hash<std::uint32_t> still spread over the table.
+         */
+        template <typename Key, typename Hash = std::hash<Key>>
+        class FlatCounter
+        {
+        public:
+            explicit FlatCounter(std::size_t capacity = 64) : m_slots(roundUpPow2(capacity)) {}
+
+            /// Count 'key' 'n' more times; returns its new count.
+            std::uint32_t add(const Key &key, std::uint32_t n = 1)
+            {
+                if (n == 0)
+                    return count(key);
+                if ((m_size + 1) * 2 > m_slots.size())
+                    grow();
+                Slot &slot = m_slots[probe(key)];
+                if (slot.count == 0)
+                {
+                    slot.key = key;
+                    ++m_size;
+                }
+                slot.count = n > kMaxCount - slot.count ? kMaxCount : slot.count + n;
+                return slot.count;
+            }
+
+            /// Count of 'key' (0 if it was never counted).
+            std::uint32_t count(const Key &key) const noexcept
+            {
+                return m_slots[probe(key)].count;
+            }
+
+            std::size_t size() const noexcept { return m_size; }
+            bool        empty() const noexcept { return m_size == 0; }
+
+            void clear() noexcept
+            {
+                for (auto &slot : m_slots)
+                    slot = Slot{};
+                m_size = 0;
+            }
+
+            /// Call f(key, count) for every counted key (no particular order).
+            template <typename F>
+            void forEach(F &&f) const
+            {
+                for (const auto &slot : m_slots)
+                {
+                    if (slot.count != 0)
+                        f(slot.key, slot.count);
+                }
+            }
+
+        private:
+            static constexpr std::uint32_t kMaxCount = std::numeric_limits<std::uint32_t>::max();
+
+            struct Slot
+            {
+                Key           key{};
+                std::uint32_t count = 0; ///< 0 = empty
+            };
+
+            static std::size_t roundUpPow2(std::size_t n) noexcept
+            {
+                std::size_t p = 2;
+                while (p < n)
+                    p <<= 1;
+                return p;
+            }
+
+            static std::uint64_t mix(std::uint64_t x) noexcept
+            {
+                x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+                x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+                return x ^ (x >> 31);
+            }
+
+            /// Slot holding 'key', or the empty slot where it would go.
+            std::size_t probe(const Key &key) const noexcept
+            {
+                const std::size_t mask = m_slots.size() - 1;
+                std::size_t i = static_cast<std::size_t>(mix(static_cast<std::uint64_t>(Hash{}(key)))) & mask;
+                while (m_slots[i].count != 0 && !(m_slots[i].key == key))
+                    i = (i + 1) & mask;
+                return i;
+            }
+
+            void grow()
+            {
+                std::vector<Slot> old(m_slots.size() * 2);
+                old.swap(m_slots);
+                for (const auto &slot : old)
+                {
+                    if (slot.count != 0)
+                        m_slots[probe(slot.key)] = slot;
+                }
+            }
+
+            std::vector<Slot> m_slots;
+            std::size_t       m_size = 0;
+        };
+
+    } // namespace Utils
+} // namespace LogTool
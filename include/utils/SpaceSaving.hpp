@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace LogTool
+{
+    namespace Utils
+    {
+        /**
+         * SpaceSaving
+         *
+         * Responsibilities:
+         *  - Keep the most frequent keys of an unbounded stream (heavy hitters)
+         *    with a payload each, in at most 'capacity' slots (Metwally et al.,
+         *    "Space-Saving").
+         *
+         * Design notes:
+         *  - Until the table is full every count is exact. Afterwards a new key
+         *    takes over the slot of the smallest count c: it starts at c + weight
+         *    with error c, so count - error <= true count <= count.
+         *  - Keys with a true count above (total weight / capacity) are always
+         *    in the table; the rarest ones are the first to be replaced.
+         *  - Slots sit in an indexed min-heap on count plus a key -> slot map,
+         *    so add() is O(log capacity). Counts only grow, so a slot only ever
+         *    sifts towards the leaves.
+         *  - Value must be default-constructible; a replaced slot gets a fresh
+         *    Value (add() reports that through 'fresh').
+         */
+        template <typename Key, typename Value, typename Hash = std::hash<Key>>
+        class SpaceSaving
+        {
+        public:
+            struct Slot
+            {
+                Key           key{};
+                std::uint64_t count = 0;
+                std::uint64_t error = 0; ///< Count inherited from the replaced key.
+                Value         value{};
+            };
+
+            explicit SpaceSaving(std::size_t capacity) : m_capacity(capacity > 0 ? capacity : 1) {}
+
+            std::size_t capacity() const noexcept { return m_capacity; }
+            std::size_t size() const noexcept { return m_slots.size(); }
+
+            /// Keys replaced so far (0 while every count is exact).
+            std::uint64_t evictions() const noexcept { return m_evictions; }
+
+            /// Change the capacity; lowering it below size() only stops growth.
+            void setCapacity(std::size_t capacity) noexcept { m_capacity = capacity > 0 ? capacity : 1; }
+
+            /**
+             * Count 'key' 'weight' more times and return its slot. 'fresh' is
+             * set when the key was not in the table (its value is new).
+             */
+            Slot &add(const Key &key, std::uint64_t weight, bool &fresh)
+            {
+                const auto found = m_index.find(key);
+                std::uint32_t slot;
+                if (found != m_index.end())
+                {
+                    fresh = false;
+                    slot = found->second;
+                    m_slots[slot].count += weight;
+                }
+                else if (m_slots.size() < m_capacity)
+                {
+                    fresh = true;
+                    slot = static_cast<std::uint32_t>(m_slots.size());
+                    m_slots.push_back(Slot{key, weight, 0, Value{}});
+                    m_heapPos.push_back(static_cast<std::uint32_t>(m_heap.size()));
+                    m_heap.push_back(slot);
+                    m_index.emplace(key, slot);
+                    siftUp(m_heapPos[slot]);
+                    return m_slots[slot];
+                }
+                else
+                {
+                    fresh = true;
+                    slot = m_heap.front();
+                    Slot &victim = m_slots[slot];
+                    m_index.erase(victim.key);
+                    victim = Slot{key, victim.count + weight, victim.count, Value{}};
+                    m_index.emplace(key, slot);
+                    ++m_evictions;
+                }
+                siftDown(m_heapPos[slot]);
+                return m_slots[slot];
+            }
+
+            /// Slot of 'key', or nullptr if it is not tracked.
+            const Slot *find(const Key &key) const
+            {
+                const auto it = m_index.find(key);
+                return it != m_index.end() ? &m_slots[it->second] : nullptr;
+            }
+
+            /// All tracked slots (no particular order).
+            const std::vector<Slot> &slots() const noexcept { return m_slots; }
+
+            void clear() noexcept
+            {
+                m_slots.clear();
+                m_heap.clear();
+                m_heapPos.clear();
+                m_index.clear();
+                m_evictions = 0;
+            }
+
+            /// Make room for 'n' slots without rehashing (checkpoints).
+            void reserve(std::size_t n)
+            {
+                m_slots.reserve(n);
+                m_heap.reserve(n);
+                m_heapPos.reserve(n);
+                m_index.reserve(n);
+            }
+
+            /// Restore a slot (checkpoints); the table must not be full.
+            void restore(Slot slot, std::uint64_t evictions)
+            {
+                const auto index = static_cast<std::uint32_t>(m_slots.size());
+                m_index.emplace(slot.key, index);
+                m_slots.push_back(std::move(slot));
+                m_heapPos.push_back(static_cast<std::uint32_t>(m_heap.size()));
+                m_heap.push_back(index);
+                siftUp(m_heapPos[index]);
+                m_evictions = evictions;
+            }
+
+        private:
+            bool less(std::uint32_t a, std::uint32_t b) const noexcept
+            {
+                return m_slots[m_heap[a]].count < m_slots[m_heap[b]].count;
+            }
+
+            void swapNodes(std::uint32_t a, std::uint32_t b) noexcept
+            {
+                std::swap(m_heap[a], m_heap[b]);
+                m_heapPos[m_heap[a]] = a;
+                m_heapPos[m_heap[b]] = b;
+            }
+
+            void siftUp(std::uint32_t node) noexcept
+            {
+                while (node > 0)
+                {
+                    const std::uint32_t parent = (node - 1) / 2;
+                    if (!less(node, parent))
+                        break;
+                    swapNodes(node, parent);
+                    node = parent;
+                }
+            }
+
+            void siftDown(std::uint32_t node) noexcept
+            {
+                const auto n = static_cast<std::uint32_t>(m_heap.size());
+                for (;;)
+                {
+                    const std::uint32_t left = 2 * node + 1;
+                    if (left >= n)
+                        break;
+                    std::uint32_t child = left;
+                    if (left + 1 < n && less(left + 1, left))
+                        child = left + 1;
+                    if (!less(child, node))
+                        break;
+                    swapNodes(node, child);
+                    node = child;
+                }
+            }
+
+            std::size_t                              m_capacity;
+            std::vector<Slot>                        m_slots;
+            std::vector<std::uint32_t>               m_heap;    // slot indices, min-heap on count
+            std::vector<std::uint32_t>               m_heapPos; // slot index -> heap node
+            std::unordered_map<Key, std::uint32_t, Hash> m_index;
+            std::uint64_t                            m_evictions = 0;
+        };
+
+    } // namespace Utils
+} // namespace LogTool
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace LogTool
+{
+    namespace Utils
+    {
+        /**
+         * SpscQueue
+         *
+         * Responsibilities:
+         *  - Bounded FIFO connecting exactly one producer thread to exactly one
+         *    consumer thread (one pipeline edge).
+         *  - Provide backpressure: push() waits while the queue is full, so a fast
+         *    stage can never run more than 'capacity' items ahead of a slow one.
+         *  - Signal end-of-stream via close().
+         *
+         * Design notes:
+         *  - Lock-free ring buffer: the producer only writes m_tail, the consumer
+         *    only writes m_head (acquire/release ordering, no mutex, no CAS).
+         *  - Capacity is rounded up to a power of two so indices wrap with a mask.
+         *  - Blocking calls back off from yield() to short sleeps, so an idle
+         *    stage does not burn a core while it waits.
+         *  - T must be default-constructible and movable (batches are passed as
+         *    std::shared_ptr).
+         */
+        template <typename T>
+        class SpscQueue
+        {
+        public:
+            explicit SpscQueue(std::size_t capacity)
+                : m_capacity(roundUpPow2(capacity)),
+                  m_mask(m_capacity - 1),
+                  m_slots(new T[m_capacity])
+            {
+            }
+
+            SpscQueue(const SpscQueue &)            = delete;
+            SpscQueue &operator=(const SpscQueue &) = delete;
+
+            std::size_t capacity() const noexcept { return m_capacity; }
+
+            /// Producer: enqueue if there is room; returns false when full.
+            bool tryPush(T &value)
+            {
+                const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+                if (tail - m_head.load(std::memory_order_acquire) == m_capacity)
+                {
+                    return false;
+                }
+                m_slots[tail & m_mask] = std::move(value);
+                m_tail.store(tail + 1, std::memory_order_release);
+                return true;
+            }
+
+            /// Consumer: dequeue if an item is available; returns false when empty.
+            bool tryPop(T &out)
+            {
+                const std::size_t head = m_head.load(std::memory_order_relaxed);
+                if (head == m_tail.load(std::memory_order_acquire))
+                {
+                    return false;
+                }
+                out = std::move(m_slots[head & m_mask]);
+                m_slots[head & m_mask] = T{}; // release what the slot held (e.g. a batch)
+                m_head.store(head + 1, std::memory_order_release);
+                return true;
+            }
+
+            /**
+             * Producer: enqueue, waiting while the queue is full (backpressure).
+             * Returns false (dropping 'value') if the queue was closed.
+             */
+            bool push(T value)
+            {
+                for (unsigned spins = 0; !tryPush(value); ++spins)
+                {
+                    if (m_closed.load(std::memory_order_acquire))
+                    {
+                        return false;
+                    }
+                    backoff(spins);
+                }
+                return true;
+            }
+
+            /**
+             * Consumer: dequeue, waiting while the queue is empty.
+             * Returns false once the queue is closed and fully drained.
+             */
+            bool pop(T &out)
+            {
+                for (unsigned spins = 0;; ++spins)
+                {
+                    if (tryPop(out))
+                    {
+                        return true;
+                    }
+                    if (m_closed.load(std::memory_order_acquire))
+                    {
+                        // Items pushed before close() are visible now; drain them first.
+                        return tryPop(out);
+                    }
+                    backoff(spins);
+                }
+            }
+
+            /// End of stream (either side may call it; pending items stay poppable).
+            void close() noexcept { m_closed.store(true, std::memory_order_release); }
+
+            bool closed() const noexcept { return m_closed.load(std::memory_order_acquire); }
+
+        private:
+            static std::size_t roundUpPow2(std::size_t n) noexcept
+            {
+                std::size_t p = 2;
+                while (p < n)
+                {
+                    p <<= 1;
+                }
+                return p;
+            }
+
+            static void backoff(unsigned spins)
+            {
+                if (spins < 64)
+                {
+                    std::this_thread::yield();
+                }
+                else
+                {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                }
+            }
+
+            const std::size_t    m_capacity;
+            const std::size_t    m_mask;
+            std::unique_ptr<T[]> m_slots;
+
+            alignas(64) std::atomic<std::size_t> m_head{0}; // next slot to pop (consumer)
+            alignas(64) std::atomic<std::size_t> m_tail{0}; // next slot to fill (producer)
+            alignas(64) std::atomic<bool>        m_closed{false};
+        };
+
+    } // namespace Utils
+} // namespace LogTool
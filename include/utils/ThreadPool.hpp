@@ -0,0 +1,80 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace LogTool
+{
+    namespace Utils
+    {
+        /**
+         * ThreadPool
+         *
+         * Responsibilities:
+         *  - Own a fixed set of worker threads for CPU-bound pipeline stages
+         *    (parallel parsing, independent detectors).
+         *  - Run submitted tasks in FIFO order and hand results back via std::future.
+         *
+         * Design notes:
+         *  - Workers are joined in the destructor (RAII); queued tasks still run.
+         *  - Exceptions thrown by a task are propagated through its future.
+         *  - Non-copyable and non-movable (workers capture 'this').
+         */
+        class ThreadPool
+        {
+        public:
+            /// threadCount == 0 picks std::thread::hardware_concurrency() (at least 1).
+            explicit ThreadPool(std::size_t threadCount = 0);
+
+            ThreadPool(const ThreadPool &)            = delete;
+            ThreadPool &operator=(const ThreadPool &) = delete;
+            ThreadPool(ThreadPool &&)                 = delete;
+            ThreadPool &operator=(ThreadPool &&)      = delete;
+
+            ~ThreadPool();
+
+            /// Number of worker threads.
+            std::size_t size() const noexcept { return m_workers.size(); }
+
+            /**
+             * Queue a callable and return a future for its result.
+             * Thread-safe.
+             */
+            template <typename F>
+            auto submit(F &&task) -> std::future<std::invoke_result_t<std::decay_t<F>>>
+            {
+                using R = std::invoke_result_t<std::decay_t<F>>;
+                auto packaged = std::make_shared<std::packaged_task<R()>>(std::forward<F>(task));
+                std::future<R> result = packaged->get_future();
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_tasks.emplace_back([packaged]() { (*packaged)(); });
+                }
+                m_cv.notify_one();
+                return result;
+            }
+
+            /// Resolve a requested thread count (0 = hardware concurrency, never below 1).
+            static std::size_t resolveThreadCount(std::size_t requested) noexcept;
+
+        private:
+            void workerLoop();
+
+        private:
+            std::vector<std::thread>          m_workers;
+            std::deque<std::function<void()>> m_tasks;
+            std::mutex                        m_mutex;
+            std::condition_variable           m_cv;
+            bool                              m_stopping = false;
+        };
+
+    } // namespace Utils
+} // namespace LogTool
@@ -63,9 +63,48 @@ namespace LogTool
          *
          * Returns std::nullopt if parsing fails.
          * This is a good default for normalized internal timestamps.
+         * Only the first 19 characters are read (see parseLogTimestamp()).
          */
         std::optional<TimePoint> parseTimestamp(std::string_view sv);
 
+        /**
+         * Days since 1970-01-01 of a proleptic Gregorian date (month 1..12).
+         * Pure arithmetic (H. Hinnant's days_from_civil), valid for any year.
+         */
+        constexpr std::int64_t daysFromCivil(std::int64_t y, unsigned m, unsigned d) noexcept
+        {
+            y -= m <= 2 ? 1 : 0;
+            const std::int64_t era = (y >= 0 ? y : y - 399) / 400;
+            const unsigned yoe = static_cast<unsigned>(y - era * 400);                // [0, 399]
+            const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;    // [0, 365]
+            const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;              // [0, 146096]
+            return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+        }
+
+        /**
+         * Length of a log timestamp at the start of 'sv' (0 if there is none).
+         *
+         * Shape check only (no range validation), accepting:
+         *  - "YYYY-MM-DD HH:MM:SS" / "YYYY-MM-DDTHH:MM:SS", optionally followed by
+         *    ".fff" (any number of digits) and "Z", "+hh:mm", "-hhmm" or "+hh"
+         *  - syslog "Mon dd HH:MM:SS" (day may be space padded: "Feb  3")
+         */
+        std::size_t timestampLength(std::string_view sv) noexcept;
+
+        /**
+         * Parse a whole log timestamp field without allocating.
+         *
+         * Accepts every form timestampLength() recognizes, plus epoch seconds
+         * (up to 11 digits) and epoch milliseconds (12+ digits).
+         *  - Fields are range checked ("2025-99-99 99:99:99" is rejected).
+         *  - Fractional seconds are kept (sub-second TimePoint precision).
+         *  - With "Z" / an offset the value is UTC based; without one it is local
+         *    time, like std::mktime. Local dates are converted once per day and
+         *    cached per thread, so consecutive lines only pay for HH:MM:SS.
+         *  - Syslog timestamps carry no year; the current local year is assumed.
+         */
+        std::optional<TimePoint> parseLogTimestamp(std::string_view sv) noexcept;
+
         /**
          * Parse a UNIX timestamp (seconds since epoch) string.
          *
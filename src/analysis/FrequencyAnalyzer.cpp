@@ -1,22 +1,20 @@
 #include "analysis/FrequencyAnalyzer.hpp"
 
 #include <algorithm>
-#include <cctype>
-#include <iterator>
 #include <sstream>
 
+#include "analysis/TemplateMiner.hpp"
 #include "utils/Logger.hpp"
 
 namespace
 {
-    std::string toUpperCopy(std::string s)
+    constexpr std::size_t kTopN = 10;
+
+    /// Display name of a source slot ("" for entries without a source).
+    std::string sourceName(core::SourceId id)
     {
-        std::transform(s.begin(), s.end(), s.begin(),
-                       [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
-        return s;
+        return core::SourceTable::global().nameOr(id, "");
     }
-
-    constexpr std::size_t kTopN = 10;
 }
 
 namespace LogTool
@@ -24,8 +22,7 @@ namespace LogTool
     namespace Analysis
     {
         FrequencyAnalyzer::FrequencyAnalyzer()
-            : m_messageHashLength(3),
-              m_spikeMultiplier(3.0),
+            : m_spikeMultiplier(3.0),
               m_minOccurrences(2)
         {
             LogTool::Utils::getLogger().info("FrequencyAnalyzer initialized with default thresholds");
@@ -38,6 +35,13 @@ namespace LogTool
             updateUnlocked(entry);
         }
 
+        void FrequencyAnalyzer::addBatch(core::Span<const core::LogEntry> entries)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const auto &entry : entries)
+                updateUnlocked(entry);
+        }
+
         FrequencyAnalyzer::FrequencyStats FrequencyAnalyzer::getStats() const
         {
             std::lock_guard<std::mutex> lock(m_mutex);
@@ -46,19 +50,27 @@ namespace LogTool
 
             // Total events = sum of source counts
             std::size_t total = 0;
-            for (const auto &kv : m_sourceCounts)
-                total += kv.second;
+            for (core::SourceId id = 0; id < m_sourceCounts.size(); ++id)
+            {
+                if (m_sourceCounts[id] == 0)
+                    continue;
+                total += m_sourceCounts[id];
+                stats.bySource[sourceName(id)] += m_sourceCounts[id];
+            }
 
             stats.totalEvents = total;
-            stats.bySource = m_sourceCounts;
             stats.byLevel  = m_levelCounts;
-            stats.topMessages = m_messageCounts;
+            for (core::TemplateId id = 0; id < m_templateCounts.size(); ++id)
+            {
+                if (m_templateCounts[id] > 0)
+                    stats.topMessages[templateName(id)] += m_templateCounts[id];
+            }
 
             // Top sources
             stats.topSources.clear();
-            stats.topSources.reserve(std::min<std::size_t>(kTopN, m_sourceCounts.size()));
+            stats.topSources.reserve(std::min<std::size_t>(kTopN, stats.bySource.size()));
 
-            for (const auto &kv : m_sourceCounts)
+            for (const auto &kv : stats.bySource)
             {
                 if (kv.second > 0)
                     stats.topSources.emplace_back(kv.first, kv.second);
@@ -70,11 +82,11 @@ namespace LogTool
             if (stats.topSources.size() > kTopN)
                 stats.topSources.resize(kTopN);
 
-            // Top message hashes
+            // Top message templates
             stats.topMessagesSorted.clear();
-            stats.topMessagesSorted.reserve(std::min<std::size_t>(kTopN, m_messageCounts.size()));
+            stats.topMessagesSorted.reserve(stats.topMessages.size());
 
-            for (const auto &kv : m_messageCounts)
+            for (const auto &kv : stats.topMessages)
             {
                 if (kv.second > 0)
                     stats.topMessagesSorted.emplace_back(kv.first, kv.second);
@@ -94,39 +106,44 @@ namespace LogTool
             std::lock_guard<std::mutex> lock(m_mutex);
             std::vector<std::string> anomalies;
 
-            // Source spikes
-            for (const auto &kv : m_sourceCounts)
+            // Source spikes (IDs depend on parse order, so report by name)
+            std::vector<std::pair<std::string, core::SourceId>> sources;
+            for (core::SourceId id = 0; id < m_sourceCounts.size(); ++id)
             {
-                const std::string &source = kv.first;
-                const std::size_t count = kv.second;
-
-                auto avgIt = m_sourceMovingAvg.find(source);
-                if (avgIt != m_sourceMovingAvg.end() && avgIt->second > 0.0)
-                {
-                    if (static_cast<double>(count) > avgIt->second * m_spikeMultiplier)
-                    {
-                        std::ostringstream oss;
-                        oss << "Source '" << source << "' spike: " << count
-                            << " events (" << (static_cast<double>(count) / avgIt->second) << "x average)";
-                        anomalies.push_back(oss.str());
-                    }
-                }
+                if (m_sourceCounts[id] > 0)
+                    sources.emplace_back(sourceName(id), id);
             }
+            std::sort(sources.begin(), sources.end());
 
-            // Rare message hashes
-            for (const auto &kv : m_messageCounts)
+            for (const auto &[source, id] : sources)
             {
-                const std::string &msgHash = kv.first;
-                const std::size_t count = kv.second;
-
-                if (count < m_minOccurrences)
+                const std::size_t count = m_sourceCounts[id];
+                const double avg = m_sourceMovingAvg[id];
+                if (avg > 0.0 && static_cast<double>(count) > avg * m_spikeMultiplier)
                 {
                     std::ostringstream oss;
-                    oss << "Rare message pattern '" << msgHash << "': only " << count << " occurrences";
+                    oss << "Source '" << source << "' spike: " << count
+                        << " events (" << (static_cast<double>(count) / avg) << "x average)";
                     anomalies.push_back(oss.str());
                 }
             }
 
+            // Rare message templates, sorted by text (IDs follow input order)
+            std::vector<std::pair<std::string, std::size_t>> rare;
+            for (core::TemplateId id = 0; id < m_templateCounts.size(); ++id)
+            {
+                if (m_templateCounts[id] > 0 && m_templateCounts[id] < m_minOccurrences)
+                    rare.emplace_back(templateName(id), m_templateCounts[id]);
+            }
+            std::sort(rare.begin(), rare.end());
+
+            for (const auto &[name, count] : rare)
+            {
+                std::ostringstream oss;
+                oss << "Rare message pattern '" << name << "': only " << count << " occurrences";
+                anomalies.push_back(oss.str());
+            }
+
             return anomalies;
         }
 
@@ -136,17 +153,65 @@ namespace LogTool
 
             m_sourceCounts.clear();
             m_levelCounts.clear();
-            m_messageCounts.clear();
+            m_templateCounts.clear();
             m_sourceHistory.clear();
             m_sourceMovingAvg.clear();
 
             LogTool::Utils::getLogger().debug("FrequencyAnalyzer counters reset");
         }
 
-        void FrequencyAnalyzer::setMessageHashLength(std::size_t length) noexcept
+        void FrequencyAnalyzer::saveState(core::StateWriter &out) const
         {
             std::lock_guard<std::mutex> lock(m_mutex);
-            m_messageHashLength = length;
+
+            out.putSize(m_sourceCounts.size());
+            for (std::size_t id = 0; id < m_sourceCounts.size(); ++id)
+            {
+                out.putSize(m_sourceCounts[id]);
+                out.put(m_sourceMovingAvg[id]);
+                out.putSize(m_sourceHistory[id].size());
+                for (const std::size_t v : m_sourceHistory[id])
+                    out.putSize(v);
+            }
+
+            out.putSize(m_levelCounts.size());
+            for (const auto &[level, count] : m_levelCounts)
+            {
+                out.put(level);
+                out.putSize(count);
+            }
+
+            out.putSize(m_templateCounts.size());
+            for (const std::size_t count : m_templateCounts)
+                out.putSize(count);
+        }
+
+        void FrequencyAnalyzer::loadState(core::StateReader &in)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            const std::size_t sources = in.getSize();
+            m_sourceCounts.assign(sources, 0);
+            m_sourceMovingAvg.assign(sources, 0.0);
+            m_sourceHistory.assign(sources, {});
+            for (std::size_t id = 0; id < sources; ++id)
+            {
+                m_sourceCounts[id] = in.get<std::uint64_t>();
+                m_sourceMovingAvg[id] = in.get<double>();
+                for (std::size_t n = in.getSize(); n > 0; --n)
+                    m_sourceHistory[id].push_back(in.get<std::uint64_t>());
+            }
+
+            m_levelCounts.clear();
+            for (std::size_t n = in.getSize(); n > 0; --n)
+            {
+                const auto level = in.get<core::LogLevel>();
+                m_levelCounts[level] = in.get<std::uint64_t>();
+            }
+
+            m_templateCounts.assign(in.getSize(), 0);
+            for (auto &count : m_templateCounts)
+                count = in.get<std::uint64_t>();
         }
 
         void FrequencyAnalyzer::setSpikeMultiplier(double multiplier) noexcept
@@ -161,40 +226,36 @@ namespace LogTool
             m_minOccurrences = count;
         }
 
-        std::string FrequencyAnalyzer::hashMessage(const std::string &message) const
+        std::string FrequencyAnalyzer::templateName(core::TemplateId id)
         {
-            std::istringstream iss(message);
-            std::vector<std::string> words;
-            std::string word;
-
-            while (words.size() < m_messageHashLength && (iss >> word))
-                words.push_back(toUpperCopy(word));
-
-            if (words.empty())
-                return "EMPTY";
-
-            std::ostringstream oss;
-            std::copy(words.begin(), words.end(), std::ostream_iterator<std::string>(oss, " "));
-            std::string result = oss.str();
-            if (!result.empty())
-                result.pop_back(); // remove trailing space
-            return result;
+            std::string name = TemplateMiner::global().text(id);
+            return name.empty() ? "EMPTY" : name;
         }
 
         // Correct type matching header (core::LogEntry)
         void FrequencyAnalyzer::updateUnlocked(const core::LogEntry &entry)
         {
-            // Unwrap `std::optional<std::string>` using `.value()` for source
-            m_sourceCounts[entry.source().value_or("")]++;  // Safe unwrap
+            const core::SourceId source = entry.sourceId();
+            if (source >= m_sourceCounts.size())
+            {
+                const std::size_t n = static_cast<std::size_t>(source) + 1;
+                m_sourceCounts.resize(n, 0);
+                m_sourceHistory.resize(n);
+                m_sourceMovingAvg.resize(n, 0.0);
+            }
+
+            m_sourceCounts[source]++;
             m_levelCounts[entry.level()]++;
 
-            const std::string msgHash = hashMessage(entry.message());
-            m_messageCounts[msgHash]++;
+            const core::TemplateId id = TemplateMiner::global().idOf(entry);
+            if (id >= m_templateCounts.size())
+                m_templateCounts.resize(static_cast<std::size_t>(id) + 1, 0);
+            m_templateCounts[id]++;
 
-            updateMovingAverage(entry.source().value_or(""));  // Safe unwrap
+            updateMovingAverage(source);
         }
 
-        void FrequencyAnalyzer::updateMovingAverage(const std::string &source)
+        void FrequencyAnalyzer::updateMovingAverage(core::SourceId source)
         {
             auto &history = m_sourceHistory[source];
             history.push_back(m_sourceCounts[source]);
@@ -3,8 +3,9 @@
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <stdexcept>
+#include "analysis/TemplateMiner.hpp"
 #include "utils/Logger.hpp"
-#include "utils/StringUtils.hpp"
 
 namespace LogTool
 {
@@ -13,24 +14,75 @@ namespace LogTool
         using namespace core;  // Correct usage of 'core' namespace
         using namespace Utils;
 
-        // EventSignature hash and equality
-        bool PatternAnalyzer::EventSignature::operator==(const EventSignature& other) const
+        namespace
         {
-            return source == other.source &&
-                   level == other.level &&
-                   messagePrefix == other.messagePrefix;
-        }
+            // splitmix64 finalizer.
+            std::uint64_t mix64(std::uint64_t x) noexcept
+            {
+                x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+                x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+                return x ^ (x >> 31);
+            }
 
-        struct PatternAnalyzer::EventSignature::Hash 
-        {
-            std::size_t operator()(const EventSignature& sig) const noexcept
+            // Source and template IDs are checkpointed, so the fingerprint is stable across resumes
+            std::uint64_t eventFingerprint(core::SourceId source, core::LogLevel level, core::TemplateId templateId) noexcept
+            {
+                return mix64((static_cast<std::uint64_t>(templateId) << 32) ^
+                             (static_cast<std::uint64_t>(source) << 8) ^
+                             static_cast<std::uint64_t>(level));
+            }
+
+            // Signed value as a zigzag varint (small magnitudes take one byte)
+            void putDelta(core::StateWriter& out, std::int64_t delta)
+            {
+                out.putVarint((static_cast<std::uint64_t>(delta) << 1) ^ static_cast<std::uint64_t>(delta >> 63));
+            }
+
+            std::int64_t getDelta(core::StateReader& in)
+            {
+                const std::uint64_t z = in.getVarint();
+                return static_cast<std::int64_t>((z >> 1) ^ (0 - (z & 1)));
+            }
+
+            void putTimeDelta(core::StateWriter& out, Utils::TimePoint tp, Utils::TimePoint base)
             {
-                std::size_t h1 = std::hash<std::string>{}(sig.source);
-                std::size_t h2 = std::hash<int>{}(static_cast<int>(sig.level));
-                std::size_t h3 = std::hash<std::string>{}(sig.messagePrefix);
-                return h1 ^ (h2 << 1) ^ h3;
+                putDelta(out, (tp - base).count());
+            }
+
+            Utils::TimePoint getTimeDelta(core::StateReader& in, Utils::TimePoint base)
+            {
+                return base + Utils::TimePoint::duration(getDelta(in));
+            }
+
+            // Event IDs of a pattern but its first 'skip' ones (known to the reader)
+            void putEvents(core::StateWriter& out, const std::vector<std::uint32_t>& events, std::size_t skip = 0)
+            {
+                out.putVarint(events.size() - skip);
+                for (std::size_t i = skip; i < events.size(); ++i)
+                {
+                    out.putVarint(events[i]);
+                }
+            }
+
+            void getEvents(core::StateReader& in, std::size_t eventCount, std::vector<std::uint32_t>& events)
+            {
+                const auto n = in.getVarint();
+                if (n > in.remaining())
+                {
+                    throw std::runtime_error("pattern events: bad length");
+                }
+                events.reserve(events.size() + n);
+                for (std::uint64_t i = 0; i < n; ++i)
+                {
+                    const auto id = in.getVarint();
+                    if (id >= eventCount)
+                    {
+                        throw std::runtime_error("pattern event out of range");
+                    }
+                    events.push_back(static_cast<std::uint32_t>(id));
+                }
             }
-        };
+        }
 
         PatternAnalyzer::PatternAnalyzer()
         {
@@ -42,9 +94,22 @@ namespace LogTool
         void PatternAnalyzer::addEntry(const core::LogEntry& entry)
         {
             std::lock_guard<std::mutex> lock(m_mutex);
-            
+            addEntryUnlocked(entry);
+        }
+
+        void PatternAnalyzer::addBatch(core::Span<const core::LogEntry> entries)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const auto& entry : entries)
+            {
+                addEntryUnlocked(entry);
+            }
+        }
+
+        void PatternAnalyzer::addEntryUnlocked(const core::LogEntry& entry)
+        {
             // Add to recent events window
-            m_recentEvents.push_back(entry);
+            m_recentEvents.push_back(createEventUnlocked(entry));
             
             // Evict old events to maintain window size
             if (m_recentEvents.size() > m_sequenceWindowSize)
@@ -52,23 +117,17 @@ namespace LogTool
                 m_recentEvents.pop_front();
             }
             
-            // Extract all possible sequences (n-grams) from recent events
+            // Only the n-grams ending at the new event are new. Each is credited
+            // with every window position it will be part of (W - len + 1).
+            const std::size_t last = m_recentEvents.size() - 1;
+            std::uint64_t key = m_recentEvents[last].fingerprint;
             for (std::size_t len = 2; len <= std::min(m_sequenceWindowSize, m_recentEvents.size()); ++len)
             {
-                for (std::size_t start = 0; start <= m_recentEvents.size() - len; ++start)
-                {
-                    EventSequence sequence;
-                    sequence.reserve(len);
-                    
-                    for (std::size_t i = start; i < start + len; ++i)
-                    {
-                        sequence.push_back(createSignature(m_recentEvents[i]));
-                    }
-                    
-                    std::string sig = sequenceToSignature(sequence);
-                    updatePatternUnlocked(sequence, m_recentEvents.back());
-                }
+                const std::size_t first = last + 1 - len;
+                key = extendKey(key, m_recentEvents[first].fingerprint);
+                updatePatternUnlocked(key, first, m_sequenceWindowSize - len + 1, entry);
             }
+            ++m_entryCount;
         }
 
         PatternAnalyzer::PatternStats PatternAnalyzer::getStats() const
@@ -76,28 +135,33 @@ namespace LogTool
             std::lock_guard<std::mutex> lock(m_mutex);
 
             PatternStats stats;
-            stats.totalPatterns = m_patterns.size();
+            stats.totalPatterns = m_patterns.size() + m_rare.size();
 
-            // Count repeating patterns (freq >= 2)
-            for (const auto& [sig, pattern] : m_patterns)
+            const auto pending = pendingWeightsUnlocked();
+            const auto texts = eventTextsUnlocked();
+            std::vector<std::pair<std::string, std::size_t>> sortedPatterns;
+            auto countPattern = [&](const std::vector<std::uint32_t>& events, std::size_t frequency)
             {
-                if (pattern.frequency >= 2)
+                sortedPatterns.push_back({signature(events, texts), frequency});
+
+                // Count repeating patterns (freq >= 2)
+                if (frequency >= 2)
                     stats.repeatingPatterns++;
 
                 // Count error chains
-                if (isErrorChainFromSignature(sig))
+                if (isErrorChainFromSignature(sortedPatterns.back().first))
                     stats.errorChains++;
+            };
+            for (const auto& slot : m_patterns.slots())
+            {
+                countPattern(slot.value.events, frequencyUnlocked(slot, pending));
             }
+            m_rare.forEach([&](std::uint64_t, const RarePattern& rare) { countPattern(rare.events, 1); });
 
             // Top patterns by frequency
             stats.topPatterns.clear(); // Clear before adding top patterns
 
             // Sort patterns by frequency
-            std::vector<std::pair<std::string, std::size_t>> sortedPatterns;
-            for (const auto& [sig, pattern] : m_patterns) {
-                sortedPatterns.push_back({sig, pattern.frequency});
-            }
-
             std::sort(sortedPatterns.begin(), sortedPatterns.end(),
                       [](const auto& a, const auto& b) { return a.second > b.second; });
 
@@ -121,10 +185,26 @@ namespace LogTool
             std::lock_guard<std::mutex> lock(m_mutex);
             std::vector<std::string> anomalies;
             
+            // Signatures are reported sorted: hash-map order depends on insertion
+            // history, which differs between a full run and a resumed one.
+            std::vector<std::string> seenOnce;
+            const auto pending = pendingWeightsUnlocked();
+            const auto texts = eventTextsUnlocked();
+            for (const auto& slot : m_patterns.slots())
+            {
+                if (frequencyUnlocked(slot, pending) == 1) // Never seen before
+                {
+                    seenOnce.push_back(signature(slot.value.events, texts));
+                }
+            }
+            m_rare.forEach([&](std::uint64_t, const RarePattern& rare)
+                           { seenOnce.push_back(signature(rare.events, texts)); });
+            std::sort(seenOnce.begin(), seenOnce.end());
+
             // Check for novel high-severity patterns (first time seen)
-            for (const auto& [sig, pattern] : m_patterns)
+            for (const auto& sig : seenOnce)
             {
-                if (pattern.frequency == 1 && isHighSeverityPattern(sig))
+                if (isHighSeverityPattern(sig))
                 {
                     std::ostringstream oss;
                     oss << "Novel high-severity pattern: " << sig.substr(0, 50) << "...";
@@ -133,12 +213,9 @@ namespace LogTool
             }
             
             // Check for unusual sequence transitions
-            for (const auto& [sig, count] : m_sequenceCounts)
+            for (const auto& sig : seenOnce)
             {
-                if (count == 1) // Never seen before
-                {
-                    anomalies.push_back("New sequence pattern: " + sig);
-                }
+                anomalies.push_back("New sequence pattern: " + sig);
             }
             
             return anomalies;
@@ -149,10 +226,242 @@ namespace LogTool
             std::lock_guard<std::mutex> lock(m_mutex);
             m_recentEvents.clear();
             m_patterns.clear();
-            m_sequenceCounts.clear();
+            m_rare.clear();
+            m_sketch.reset();
+            m_events.clear();
+            m_eventIds.clear();
+            m_entryCount = 0;
             getLogger().debug("PatternAnalyzer reset");
         }
 
+        void PatternAnalyzer::saveState(core::StateWriter& out) const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            // Interned events first: patterns and the window refer to their IDs
+            out.putSize(m_events.size());
+            for (const auto& info : m_events)
+            {
+                out.put(info.sourceId);
+                out.put(static_cast<std::uint8_t>(info.level));
+                out.put(info.templateId);
+            }
+
+            out.putSize(m_recentEvents.size());
+            for (const auto& event : m_recentEvents)
+            {
+                out.putEntry(event.entry);
+            }
+
+            out.put(m_entryCount);
+
+            // Patterns are most of the state, so they are written as varints:
+            // keys are recomputed from the events, and times and example IDs
+            // are deltas (slots are mostly in order of appearance).
+            // Counts are saved as credited (pending weights included).
+            out.putVarint(m_patterns.evictions());
+            out.putSize(m_patterns.size());
+            Utils::TimePoint previousSeen{};
+            std::uint64_t previousExample = 0;
+            for (const auto& slot : m_patterns.slots())
+            {
+                const auto& pattern = slot.value;
+                putEvents(out, pattern.events);
+                out.putVarint(slot.count);
+                out.putVarint(slot.error);
+                out.putVarint(pattern.exampleIds.size());
+                std::uint64_t base = previousExample;
+                for (const auto id : pattern.exampleIds)
+                {
+                    putDelta(out, static_cast<std::int64_t>(id - base));
+                    base = id;
+                }
+                if (!pattern.exampleIds.empty())
+                {
+                    previousExample = pattern.exampleIds.front();
+                }
+                putTimeDelta(out, pattern.firstSeen, previousSeen);
+                putTimeDelta(out, pattern.lastSeen, pattern.firstSeen);
+                previousSeen = pattern.firstSeen;
+            }
+
+            // Rare candidates, oldest first. Consecutive ones usually overlap
+            // (windows one entry apart), so only the events a candidate does not
+            // share with the previous one are written.
+            out.putVarint(m_rare.agedOut());
+            out.putSize(m_rare.size());
+            const std::vector<std::uint32_t>* previous = nullptr;
+            previousExample = 0;
+            previousSeen = Utils::TimePoint{};
+            m_rare.forEach([&](std::uint64_t, const RarePattern& rare)
+                           {
+                               const std::uint64_t step = rare.exampleId - previousExample;
+                               std::size_t shared = 0;
+                               if (previous && step > 0 && step < previous->size() &&
+                                   rare.events.size() >= previous->size() - step &&
+                                   std::equal(previous->begin() + step, previous->end(), rare.events.begin()))
+                               {
+                                   shared = previous->size() - step;
+                               }
+                               putDelta(out, static_cast<std::int64_t>(step));
+                               out.putVarint(shared);
+                               putEvents(out, rare.events, shared);
+                               putTimeDelta(out, rare.seen, previousSeen);
+                               previous = &rare.events;
+                               previousExample = rare.exampleId;
+                               previousSeen = rare.seen;
+                           });
+
+            // Sketch, if there is one yet: dimensions, then the non-zero counters
+            // by index while they are few, otherwise all of them
+            out.put<std::uint8_t>(m_sketch ? 1 : 0);
+            if (!m_sketch)
+            {
+                return;
+            }
+            const auto& counters = m_sketch->counters();
+            const auto nonZero = static_cast<std::size_t>(
+                std::count_if(counters.begin(), counters.end(), [](std::uint32_t c) { return c != 0; }));
+            const bool sparse = nonZero * 3 < counters.size();
+            out.put<std::uint64_t>(m_sketch->width());
+            out.put<std::uint64_t>(m_sketch->depth());
+            out.put<std::uint8_t>(sparse ? 1 : 0);
+            out.putSize(sparse ? nonZero : counters.size());
+            for (std::size_t i = 0; i < counters.size(); ++i)
+            {
+                if (!sparse)
+                {
+                    out.put(counters[i]);
+                }
+                else if (counters[i] != 0)
+                {
+                    out.put<std::uint64_t>(i);
+                    out.put(counters[i]);
+                }
+            }
+        }
+
+        void PatternAnalyzer::loadState(core::StateReader& in)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_events.clear();
+            m_eventIds.clear();
+            for (std::size_t n = in.getSize(); n > 0; --n)
+            {
+                EventInfo info;
+                info.sourceId = in.get<core::SourceId>();
+                info.level = static_cast<core::LogLevel>(in.get<std::uint8_t>());
+                info.templateId = in.get<core::TemplateId>();
+                internUnlocked(info);
+            }
+
+            m_recentEvents.clear();
+            for (std::size_t n = in.getSize(); n > 0; --n)
+            {
+                m_recentEvents.push_back(createEventUnlocked(in.getEntry()));
+            }
+
+            m_entryCount = in.get<std::uint64_t>();
+
+            m_patterns.clear();
+            const auto evictions = in.getVarint();
+            Utils::TimePoint previousSeen{};
+            std::uint64_t previousExample = 0;
+            const std::size_t slots = in.getSize();
+            m_patterns.reserve(slots);
+            for (std::size_t n = slots; n > 0; --n)
+            {
+                PatternStore::Slot slot;
+                auto& pattern = slot.value;
+                getEvents(in, m_events.size(), pattern.events);
+                slot.key = keyOfUnlocked(pattern.events);
+                slot.count = in.getVarint();
+                slot.error = in.getVarint();
+                const auto examples = in.getVarint();
+                if (examples > in.remaining())
+                {
+                    throw std::runtime_error("pattern examples: bad length");
+                }
+                std::uint64_t base = previousExample;
+                pattern.exampleIds.reserve(examples);
+                for (std::uint64_t i = 0; i < examples; ++i)
+                {
+                    base += static_cast<std::uint64_t>(getDelta(in));
+                    pattern.exampleIds.push_back(base);
+                }
+                if (!pattern.exampleIds.empty())
+                {
+                    previousExample = pattern.exampleIds.front();
+                }
+                pattern.firstSeen = getTimeDelta(in, previousSeen);
+                pattern.lastSeen = getTimeDelta(in, pattern.firstSeen);
+                previousSeen = pattern.firstSeen;
+                if (m_patterns.find(slot.key) != nullptr)
+                {
+                    throw std::runtime_error("pattern saved twice");
+                }
+                m_patterns.restore(std::move(slot), evictions);
+            }
+
+            m_rare.clear();
+            const auto agedOut = in.getVarint();
+            std::vector<std::uint32_t> previous;
+            previousExample = 0;
+            previousSeen = Utils::TimePoint{};
+            const std::size_t candidates = in.getSize();
+            m_rare.reserve(candidates);
+            for (std::size_t n = candidates; n > 0; --n)
+            {
+                RarePattern rare;
+                rare.exampleId = previousExample + static_cast<std::uint64_t>(getDelta(in));
+                const auto shared = in.getVarint();
+                if (shared > previous.size())
+                {
+                    throw std::runtime_error("rare pattern: bad overlap");
+                }
+                rare.events.reserve(previous.size());
+                rare.events.assign(previous.end() - static_cast<std::ptrdiff_t>(shared), previous.end());
+                getEvents(in, m_events.size(), rare.events);
+                rare.seen = getTimeDelta(in, previousSeen);
+                const auto key = keyOfUnlocked(rare.events);
+                if (m_rare.find(key) != nullptr || m_patterns.find(key) != nullptr)
+                {
+                    throw std::runtime_error("pattern saved twice");
+                }
+                previous = rare.events;
+                previousExample = rare.exampleId;
+                previousSeen = rare.seen;
+                m_rare.restore(key, std::move(rare), agedOut);
+            }
+
+            m_sketch.reset();
+            if (in.get<std::uint8_t>() == 0)
+            {
+                return;
+            }
+            m_sketch.emplace(sketchWidth(m_patterns.capacity()));
+            if (in.get<std::uint64_t>() != m_sketch->width() || in.get<std::uint64_t>() != m_sketch->depth())
+            {
+                throw std::runtime_error("pattern sketch dimensions changed");
+            }
+            auto& counters = m_sketch->counters();
+            const bool sparse = in.get<std::uint8_t>() != 0;
+            const std::size_t n = in.getSize();
+            if (!sparse && n != counters.size())
+            {
+                throw std::runtime_error("pattern sketch size changed");
+            }
+            for (std::size_t k = 0; k < n; ++k)
+            {
+                const auto i = sparse ? in.get<std::uint64_t>() : k;
+                if (i >= counters.size())
+                {
+                    throw std::runtime_error("pattern sketch counter out of range");
+                }
+                counters[i] = in.get<std::uint32_t>();
+            }
+        }
+
         void PatternAnalyzer::setSequenceWindowSize(std::size_t size) noexcept
         {
             std::lock_guard<std::mutex> lock(m_mutex);
@@ -165,6 +474,14 @@ namespace LogTool
             m_maxPatternExamples = count;
         }
 
+        void PatternAnalyzer::setMaxPatterns(std::size_t count)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_patterns.setCapacity(count);
+            m_rare.setCapacity(count);
+            m_sketch.reset();
+        }
+
         void PatternAnalyzer::setPatternTimeout(Utils::seconds timeout) noexcept
         {
             std::lock_guard<std::mutex> lock(m_mutex);
@@ -173,79 +490,220 @@ namespace LogTool
 
         // --- Private implementation ---
 
-        PatternAnalyzer::EventSignature PatternAnalyzer::createSignature(const core::LogEntry& entry) const
+        PatternAnalyzer::WindowEvent PatternAnalyzer::createEventUnlocked(const core::LogEntry& entry)
         {
-            EventSignature sig;
-            sig.source = entry.source().value_or("");  // Handle optional source
-            sig.level = entry.level();
-            
-            // Take first 3 words of message as prefix (using StringUtils)
-            auto words = Utils::splitAndTrim(entry.message(), ' ');
-            std::ostringstream oss;
-            for (std::size_t i = 0; i < std::min<std::size_t>(3, words.size()); ++i)
+            const EventInfo info{entry.sourceId(), entry.level(), TemplateMiner::global().idOf(entry)};
+            return WindowEvent{entry, eventFingerprint(info.sourceId, info.level, info.templateId), internUnlocked(info)};
+        }
+
+        std::uint32_t PatternAnalyzer::internUnlocked(const EventInfo& info)
+        {
+            const std::uint64_t fingerprint = eventFingerprint(info.sourceId, info.level, info.templateId);
+            const auto found = m_eventIds.find(fingerprint);
+            if (found != m_eventIds.end())
             {
-                if (i > 0) oss << " ";
-                oss << words[i];
+                return found->second;
             }
-            sig.messagePrefix = oss.str();
-            
-            return sig;
+            const auto id = static_cast<std::uint32_t>(m_events.size());
+            m_events.push_back(info);
+            m_eventIds.emplace(fingerprint, id);
+            return id;
+        }
+
+        std::uint64_t PatternAnalyzer::keyOfUnlocked(const std::vector<std::uint32_t>& events) const
+        {
+            // Chained back to front, as addEntryUnlocked() builds it
+            if (events.empty())
+            {
+                throw std::runtime_error("pattern without events");
+            }
+            auto fingerprint = [this](std::uint32_t id)
+            {
+                const EventInfo& info = m_events[id];
+                return eventFingerprint(info.sourceId, info.level, info.templateId);
+            };
+            std::uint64_t key = fingerprint(events.back());
+            for (std::size_t i = events.size() - 1; i-- > 0;)
+            {
+                key = extendKey(key, fingerprint(events[i]));
+            }
+            return key;
+        }
+
+        std::vector<std::uint32_t> PatternAnalyzer::windowEvents(std::size_t first) const
+        {
+            std::vector<std::uint32_t> events;
+            events.reserve(m_recentEvents.size() - first);
+            for (std::size_t i = first; i < m_recentEvents.size(); ++i)
+            {
+                events.push_back(m_recentEvents[i].eventId);
+            }
+            return events;
         }
 
-        std::string PatternAnalyzer::sequenceToSignature(const EventSequence& sequence) const
+        std::vector<std::string> PatternAnalyzer::eventTextsUnlocked() const
         {
-            std::ostringstream oss;
-            for (std::size_t i = 0; i < sequence.size(); ++i)
+            // "source:level:template", template text cut to 20 chars
+            std::vector<std::string> texts;
+            texts.reserve(m_events.size());
+            for (const auto& info : m_events)
             {
-                if (i > 0) oss << "->";
-                oss << sequence[i].source << ":" 
-                    << static_cast<int>(sequence[i].level) << ":" 
-                    << sequence[i].messagePrefix.substr(0, 20);
+                std::string text = SourceTable::global().optionalName(info.sourceId).value_or("");  // Handle optional source
+                text += ':';
+                text += std::to_string(static_cast<int>(info.level));
+                text += ':';
+                text.append(TemplateMiner::global().text(info.templateId), 0, 20);
+                texts.push_back(std::move(text));
             }
-            return oss.str();
+            return texts;
         }
 
-        void PatternAnalyzer::updatePatternUnlocked(const EventSequence& sequence, 
+        std::string PatternAnalyzer::signature(const std::vector<std::uint32_t>& events,
+                                               const std::vector<std::string>& texts)
+        {
+            std::string signature;
+            for (std::size_t i = 0; i < events.size(); ++i)
+            {
+                if (i > 0) signature += "->";
+                signature += texts[events[i]];
+            }
+            return signature;
+        }
+
+        std::uint64_t PatternAnalyzer::extendKey(std::uint64_t key, std::uint64_t fingerprint) noexcept
+        {
+            // Order-dependent mix (boost::hash_combine, 64-bit constant), so A->B and B->A differ
+            return key ^ (fingerprint + 0x9e3779b97f4a7c15ull + (key << 12) + (key >> 4));
+        }
+
+        void PatternAnalyzer::updatePatternUnlocked(std::uint64_t key, std::size_t first, std::size_t weight,
                                                   const core::LogEntry& latestEntry)
         {
-            std::string sig = sequenceToSignature(sequence);
-            
-            // Update sequence count
-            m_sequenceCounts[sig]++;
-            
+            // Weight of the earlier sighting a full-window n-gram carries into the
+            // heavy-hitter table, and how much of it the sketch has not counted yet
+            std::size_t carried = 0;
+            std::size_t uncounted = 0;
+            RarePattern rare;
+            bool promoted = false;
+            if (weight == 1 && m_patterns.find(key) == nullptr)
+            {
+                promoted = m_rare.take(key, rare);
+                if (promoted)
+                {
+                    carried = uncounted = 1;
+                }
+                else if (m_sketch && m_sketch->estimate(key) > 0)
+                {
+                    carried = 1; // aged out or evicted earlier (the sketch counted it then)
+                }
+                else
+                {
+                    // Seen once: a rare candidate until it comes back
+                    const auto forgotten =
+                        m_rare.push(key, RarePattern{windowEvents(first), m_entryCount, latestEntry.timestamp()});
+                    if (forgotten)
+                    {
+                        createSketchUnlocked();
+                        m_sketch->add(*forgotten, 1);
+                        if (m_rare.agedOut() == 1)
+                        {
+                            getLogger().warn("PatternAnalyzer: more than " + std::to_string(m_rare.capacity()) +
+                                             " patterns seen once, forgetting the oldest; rare-pattern results are approximate");
+                        }
+                    }
+                    return;
+                }
+            }
+
+            const std::uint64_t evictions = m_patterns.evictions();
+            bool added = false;
+            auto& pattern = m_patterns.add(key, weight + carried, added).value;
+            if (m_sketch)
+            {
+                m_sketch->add(key, weight + uncounted);
+            }
+            else if (m_patterns.evictions() > evictions)
+            {
+                createSketchUnlocked(); // counts the new slot too
+            }
+            if (evictions == 0 && m_patterns.evictions() == 1)
+            {
+                getLogger().warn("PatternAnalyzer: more than " + std::to_string(m_patterns.capacity()) +
+                                 " repeated patterns, evicting the rarest; frequencies are approximate");
+            }
+            if (added)
+            {
+
+                if (promoted)
+                {
+                    pattern.events = std::move(rare.events);
+                    pattern.exampleIds.push_back(rare.exampleId);
+                    pattern.firstSeen = rare.seen;
+                }
+                else
+                {
+                    pattern.events = windowEvents(first);
+                    pattern.firstSeen = latestEntry.timestamp();
+                }
+            }
+
             // Update pattern tracking
-            auto& pattern = m_patterns[sig];
-            pattern.signature = sig;
-            pattern.frequency++;
             pattern.lastSeen = latestEntry.timestamp();
             
-            if (pattern.firstSeen == TimePoint{})
+            // Keep only recent examples
+            pattern.exampleIds.push_back(m_entryCount);
+            if (pattern.exampleIds.size() > m_maxPatternExamples)
             {
-                pattern.firstSeen = latestEntry.timestamp();
+                pattern.exampleIds.erase(pattern.exampleIds.begin());
             }
-            
-            // Keep only recent examples
-            pattern.examples.push_back(latestEntry);
-            if (pattern.examples.size() > m_maxPatternExamples)
+        }
+
+        void PatternAnalyzer::createSketchUnlocked()
+        {
+            if (m_sketch)
+            {
+                return;
+            }
+            // Counts are exact up to the first eviction, except for the key that
+            // caused it (count - error is its own weight)
+            m_sketch.emplace(sketchWidth(m_patterns.capacity()));
+            for (const auto& slot : m_patterns.slots())
             {
-                pattern.examples.erase(pattern.examples.begin());
+                m_sketch->add(slot.key, slot.count - slot.error);
             }
         }
 
-        bool PatternAnalyzer::isErrorChain(const EventSequence& sequence) const
+        std::unordered_map<std::uint64_t, std::size_t> PatternAnalyzer::pendingWeightsUnlocked() const
         {
-            // Error chain: 3+ consecutive ERROR/CRITICAL events
-            if (sequence.size() < 3) return false;
-            
-            std::size_t errorCount = 0;
-            for (const auto& sig : sequence)
+            // The n-gram starting at window index 'first' was credited for
+            // first + W - size window positions that have not happened yet
+            std::unordered_map<std::uint64_t, std::size_t> pending;
+            const std::size_t size = m_recentEvents.size();
+            for (std::size_t last = 1; last < size; ++last)
             {
-                if (sig.level == core::LogLevel::Error || sig.level == core::LogLevel::Critical)
+                std::uint64_t key = m_recentEvents[last].fingerprint;
+                for (std::size_t first = last; first-- > 0;)
                 {
-                    errorCount++;
+                    key = extendKey(key, m_recentEvents[first].fingerprint);
+                    if (first + m_sequenceWindowSize > size)
+                        pending[key] += first + m_sequenceWindowSize - size;
                 }
             }
-            return errorCount >= 3;
+            return pending;
+        }
+
+        std::uint64_t PatternAnalyzer::frequencyUnlocked(
+            const PatternStore::Slot& slot, const std::unordered_map<std::uint64_t, std::size_t>& pending) const
+        {
+            // Both the slot (after evictions) and the sketch (collisions) can
+            // only overcount; the smaller one is the tighter bound
+            std::uint64_t frequency = m_sketch ? std::min(slot.count, m_sketch->estimate(slot.key)) : slot.count;
+            const auto it = pending.find(slot.key);
+            if (it != pending.end())
+            {
+                frequency -= std::min<std::uint64_t>(frequency, it->second);
+            }
+            return frequency;
         }
 
         bool PatternAnalyzer::isErrorChainFromSignature(const std::string& sig) const
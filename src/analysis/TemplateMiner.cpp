@@ -0,0 +1,315 @@
+#include "analysis/TemplateMiner.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <mutex>
+#include <stdexcept>
+
+namespace LogTool
+{
+    namespace Analysis
+    {
+        TemplateMiner::TemplateMiner(std::size_t depth, double similarity, std::size_t maxChildren)
+            : m_depth(std::max<std::size_t>(depth, 2)),
+              m_similarity(similarity),
+              m_maxChildren(std::max<std::size_t>(maxChildren, 2))
+        {
+            m_templates.emplace_back(); // slot for kNoTemplate
+        }
+
+        TemplateMiner& TemplateMiner::global()
+        {
+            static TemplateMiner miner;
+            return miner;
+        }
+
+        core::TemplateId TemplateMiner::add(std::string_view message)
+        {
+            std::unique_lock<std::shared_mutex> lock(m_mutex);
+            tokenize(message, m_tokens);
+            return addUnlocked();
+        }
+
+        void TemplateMiner::assign(core::EntryBatch& batch)
+        {
+            batch.enrich(); // tokens come from the batch's enrichment
+
+            std::unique_lock<std::shared_mutex> lock(m_mutex);
+            for (std::size_t i = 0; i < batch.size(); ++i)
+            {
+                if (batch[i].templateId() != core::kNoTemplate)
+                    continue;
+                const auto entry = batch.enriched(i);
+                m_tokens.clear();
+                for (std::size_t t = 0; t < entry.tokenCount(); ++t)
+                    m_tokens.push_back(entry.token(t));
+                batch.setTemplateId(i, addUnlocked());
+            }
+        }
+
+        core::TemplateId TemplateMiner::idOf(const core::LogEntry& entry)
+        {
+            if (entry.templateId() != core::kNoTemplate)
+                return entry.templateId();
+            return add(entry.message());
+        }
+
+        std::string TemplateMiner::text(core::TemplateId id) const
+        {
+            std::shared_lock<std::shared_mutex> lock(m_mutex);
+            std::string out;
+            if (id == core::kNoTemplate || id >= m_templates.size())
+                return out;
+            for (const auto& token : m_templates[id])
+            {
+                if (!out.empty())
+                    out += ' ';
+                out += token;
+            }
+            return out;
+        }
+
+        std::vector<std::string_view> TemplateMiner::variables(core::TemplateId id, std::string_view message) const
+        {
+            std::vector<std::string_view> tokens;
+            tokenize(message, tokens);
+
+            std::shared_lock<std::shared_mutex> lock(m_mutex);
+            std::vector<std::string_view> out;
+            if (id == core::kNoTemplate || id >= m_templates.size() || m_templates[id].size() != tokens.size())
+                return out;
+            for (std::size_t i = 0; i < tokens.size(); ++i)
+            {
+                if (m_templates[id][i] == kWildcard)
+                    out.push_back(tokens[i]);
+            }
+            return out;
+        }
+
+        std::size_t TemplateMiner::size() const
+        {
+            std::shared_lock<std::shared_mutex> lock(m_mutex);
+            return m_templates.size();
+        }
+
+        void TemplateMiner::clear()
+        {
+            std::unique_lock<std::shared_mutex> lock(m_mutex);
+            m_byLength.clear();
+            m_nodes.clear();
+            m_keys.clear();
+            m_templates.assign(1, {});
+        }
+
+        void TemplateMiner::saveState(core::StateWriter& out) const
+        {
+            std::shared_lock<std::shared_mutex> lock(m_mutex);
+            out.putSize(m_templates.size());
+            for (std::size_t id = 1; id < m_templates.size(); ++id)
+            {
+                out.putSize(m_templates[id].size());
+                for (const auto& token : m_templates[id])
+                    out.putString(token);
+            }
+
+            // The tree as is: rebuilding it from the templates would not put
+            // templates reached through "<*>" nodes back in the same leaf.
+            out.putSize(m_nodes.size());
+            for (const auto& node : m_nodes)
+            {
+                out.putSize(node.children.size());
+                for (const auto& [key, child] : node.children)
+                {
+                    out.putString(key);
+                    out.put(child);
+                }
+                out.putSize(node.templates.size());
+                for (const auto id : node.templates)
+                    out.put(id);
+            }
+
+            out.putSize(m_byLength.size());
+            for (const auto& [length, node] : m_byLength)
+            {
+                out.put<std::uint64_t>(length);
+                out.put(node);
+            }
+        }
+
+        void TemplateMiner::loadState(core::StateReader& in)
+        {
+            std::unique_lock<std::shared_mutex> lock(m_mutex);
+            m_byLength.clear();
+            m_nodes.clear();
+            m_keys.clear();
+            m_templates.assign(1, {});
+
+            const std::size_t templates = in.getSize();
+            for (std::size_t id = 1; id < templates; ++id)
+            {
+                auto& tokens = m_templates.emplace_back();
+                for (std::size_t n = in.getSize(); n > 0; --n)
+                    tokens.push_back(in.getString());
+            }
+
+            m_nodes.resize(in.getSize());
+            for (auto& node : m_nodes)
+            {
+                for (std::size_t n = in.getSize(); n > 0; --n)
+                {
+                    const auto key = keep(in.getStringView());
+                    const auto child = in.get<std::uint32_t>();
+                    if (child >= m_nodes.size())
+                        throw std::runtime_error("template tree: node out of range");
+                    node.children.emplace(key, child);
+                }
+                for (std::size_t n = in.getSize(); n > 0; --n)
+                {
+                    const auto id = in.get<core::TemplateId>();
+                    if (id == core::kNoTemplate || id >= m_templates.size())
+                        throw std::runtime_error("template tree: template out of range");
+                    node.templates.push_back(id);
+                }
+            }
+
+            for (std::size_t n = in.getSize(); n > 0; --n)
+            {
+                const auto length = static_cast<std::size_t>(in.get<std::uint64_t>());
+                const auto node = in.get<std::uint32_t>();
+                if (node >= m_nodes.size())
+                    throw std::runtime_error("template tree: node out of range");
+                m_byLength.emplace(length, node);
+            }
+        }
+
+        // --- Private implementation ---
+
+        void TemplateMiner::tokenize(std::string_view message, std::vector<std::string_view>& tokens)
+        {
+            tokens.clear();
+            std::size_t pos = 0;
+            while (pos < message.size())
+            {
+                while (pos < message.size() && std::isspace(static_cast<unsigned char>(message[pos])))
+                    ++pos;
+                const std::size_t begin = pos;
+                while (pos < message.size() && !std::isspace(static_cast<unsigned char>(message[pos])))
+                    ++pos;
+                if (pos > begin)
+                    tokens.push_back(message.substr(begin, pos - begin));
+            }
+        }
+
+        core::TemplateId TemplateMiner::addUnlocked()
+        {
+            const std::size_t n = m_tokens.size();
+            m_variable.resize(n);
+            for (std::size_t i = 0; i < n; ++i)
+                m_variable[i] = isVariable(m_tokens[i]);
+
+            // Walk the tree: token count, then the leading tokens
+            std::uint32_t node;
+            const auto length = m_byLength.find(n);
+            if (length != m_byLength.end())
+            {
+                node = length->second;
+            }
+            else
+            {
+                node = newNode();
+                m_byLength.emplace(n, node);
+            }
+            for (std::size_t i = 0; i < std::min(n, m_depth - 2); ++i)
+                node = childFor(node, m_variable[i] ? kWildcard : m_tokens[i]);
+
+            // Most similar template of the leaf; on a tie the more general one.
+            // Positions that are variable on both sides are not compared.
+            core::TemplateId best = core::kNoTemplate;
+            double bestSimilarity = 0.0;
+            std::size_t bestWild = 0;
+            for (const auto id : m_nodes[node].templates)
+            {
+                const auto& tokens = m_templates[id];
+                std::size_t equal = 0;
+                std::size_t compared = 0;
+                std::size_t wild = 0;
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    const bool wildcard = tokens[i] == kWildcard;
+                    wild += wildcard ? 1 : 0;
+                    if (wildcard && m_variable[i])
+                        continue;
+                    ++compared;
+                    equal += !wildcard && tokens[i] == m_tokens[i] ? 1 : 0;
+                }
+                const double similarity =
+                    compared > 0 ? static_cast<double>(equal) / static_cast<double>(compared) : 1.0;
+                if (best == core::kNoTemplate || similarity > bestSimilarity ||
+                    (similarity == bestSimilarity && wild > bestWild))
+                {
+                    best = id;
+                    bestSimilarity = similarity;
+                    bestWild = wild;
+                }
+            }
+
+            if (best != core::kNoTemplate && bestSimilarity >= m_similarity)
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    auto& token = m_templates[best][i];
+                    if (token != kWildcard && token != m_tokens[i])
+                        token = kWildcard;
+                }
+                return best;
+            }
+
+            const auto id = static_cast<core::TemplateId>(m_templates.size());
+            auto& tokens = m_templates.emplace_back();
+            tokens.reserve(n);
+            for (std::size_t i = 0; i < n; ++i)
+                tokens.emplace_back(m_variable[i] ? kWildcard : m_tokens[i]);
+            m_nodes[node].templates.push_back(id);
+            return id;
+        }
+
+        std::uint32_t TemplateMiner::childFor(std::uint32_t node, std::string_view token)
+        {
+            const auto& children = m_nodes[node].children;
+            const auto found = children.find(token);
+            if (found != children.end())
+                return found->second;
+
+            // The last slot is kept for "<*>", which takes every further token
+            if (token != kWildcard && children.size() + 1 >= m_maxChildren)
+            {
+                const auto wild = children.find(kWildcard);
+                if (wild != children.end())
+                    return wild->second;
+                token = kWildcard;
+            }
+
+            const auto child = newNode(); // may move m_nodes
+            m_nodes[node].children.emplace(keep(token), child);
+            return child;
+        }
+
+        std::uint32_t TemplateMiner::newNode()
+        {
+            m_nodes.emplace_back();
+            return static_cast<std::uint32_t>(m_nodes.size() - 1);
+        }
+
+        std::string_view TemplateMiner::keep(std::string_view key)
+        {
+            return m_keys.emplace_back(key);
+        }
+
+        bool TemplateMiner::isVariable(std::string_view token) noexcept
+        {
+            return std::any_of(token.begin(), token.end(),
+                               [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; });
+        }
+
+    } // namespace Analysis
+} // namespace LogTool
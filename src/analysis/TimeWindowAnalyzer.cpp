@@ -30,6 +30,13 @@ namespace LogTool
             addEventUnlocked(entry);
         }
 
+        void TimeWindowAnalyzer::addBatch(core::Span<const core::LogEntry> entries)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const auto& entry : entries)
+                addEventUnlocked(entry);
+        }
+
         TimeWindowAnalyzer::WindowStats TimeWindowAnalyzer::currentWindowStats() const
         {
             std::lock_guard<std::mutex> lock(m_mutex);
@@ -110,6 +117,60 @@ namespace LogTool
             getLogger().debug("TimeWindowAnalyzer reset");
         }
 
+        void TimeWindowAnalyzer::saveBucket(StateWriter& out, const TimeBucket& bucket)
+        {
+            out.putTime(bucket.start);
+            out.putTime(bucket.end);
+            out.putSize(bucket.events.size());
+            for (const auto& ev : bucket.events)
+            {
+                out.putTime(ev.timestamp);
+                out.put(ev.level);
+                out.put(ev.source);
+            }
+            out.putSize(bucket.sourceCounts.size());
+            for (const std::size_t c : bucket.sourceCounts)
+                out.putSize(c);
+        }
+
+        void TimeWindowAnalyzer::loadBucket(StateReader& in, TimeBucket& bucket)
+        {
+            bucket.start = in.getTime();
+            bucket.end = in.getTime();
+            bucket.events.clear();
+            for (std::size_t n = in.getSize(); n > 0; --n)
+            {
+                TimedEvent ev;
+                ev.timestamp = in.getTime();
+                ev.level = in.get<core::LogLevel>();
+                ev.source = in.get<core::SourceId>();
+                bucket.events.push_back(ev);
+            }
+            bucket.sourceCounts.assign(in.getSize(), 0);
+            for (auto& c : bucket.sourceCounts)
+                c = in.get<std::uint64_t>();
+        }
+
+        void TimeWindowAnalyzer::saveState(StateWriter& out) const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            out.put<std::uint8_t>(m_initialized ? 1 : 0);
+            saveBucket(out, m_currentWindow);
+            out.putSize(m_windowHistory.size());
+            for (const auto& bucket : m_windowHistory)
+                saveBucket(out, bucket);
+        }
+
+        void TimeWindowAnalyzer::loadState(StateReader& in)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_initialized = in.get<std::uint8_t>() != 0;
+            loadBucket(in, m_currentWindow);
+            m_windowHistory.assign(in.getSize(), TimeBucket{});
+            for (auto& bucket : m_windowHistory)
+                loadBucket(in, bucket);
+        }
+
         void TimeWindowAnalyzer::setWindowSize(seconds size) noexcept
         {
             std::lock_guard<std::mutex> lock(m_mutex);
@@ -174,12 +235,15 @@ namespace LogTool
             TimedEvent timedEvent{
                 .timestamp = entry.timestamp(),
                 .level = entry.level(),
-                .source = entry.source().value_or("") // Access source safely (default to empty string)
+                .source = entry.sourceId()
             };
 
             // Add to events deque (oldest first)
             m_currentWindow.events.push_back(timedEvent);
-            m_currentWindow.sourceCounts[entry.source().value_or("")]++; // Increment source count
+            auto& counts = m_currentWindow.sourceCounts;
+            if (timedEvent.source >= counts.size())
+                counts.resize(static_cast<std::size_t>(timedEvent.source) + 1, 0);
+            counts[timedEvent.source]++; // Increment source count
 
             // Evict old events (keep deque bounded)
             evictOldEvents(m_currentWindow);
@@ -192,10 +256,6 @@ namespace LogTool
             {
                 const auto& oldEvent = bucket.events.front();
                 bucket.sourceCounts[oldEvent.source]--;
-                if (bucket.sourceCounts[oldEvent.source] == 0)
-                {
-                    bucket.sourceCounts.erase(oldEvent.source);
-                }
                 bucket.events.pop_front();
             }
         }
@@ -219,7 +279,12 @@ namespace LogTool
             stats.errorEvents = errorCount;
             stats.errorRate = stats.totalEvents > 0 ? 
                 static_cast<double>(errorCount) / stats.totalEvents : 0.0;
-            stats.eventsBySource = bucket.sourceCounts;
+            // Names are resolved only here ("" for entries without a source)
+            for (core::SourceId id = 0; id < bucket.sourceCounts.size(); ++id)
+            {
+                if (bucket.sourceCounts[id] > 0)
+                    stats.eventsBySource[core::SourceTable::global().nameOr(id, "")] += bucket.sourceCounts[id];
+            }
 
             return stats;
         }
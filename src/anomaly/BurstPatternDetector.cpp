@@ -1,64 +1,25 @@
 #include "anomaly/BurstPatternDetector.hpp"
 
-#include <cctype>
-#include <regex>
 #include <sstream>
 
+#include "analysis/TemplateMiner.hpp"
 #include "utils/Logger.hpp"
 
 namespace LogTool
 {
 namespace Anomaly
 {
-    BurstPatternDetector::BurstPatternDetector()
+    BurstPatternDetector::BurstPatternDetector(bool announce)
     {
-        Utils::getLogger().info("BurstPatternDetector initialized (window: 60s)");
+        if (announce)
+            Utils::getLogger().info("BurstPatternDetector initialized (window: 60s)");
     }
 
-    std::string BurstPatternDetector::normalizeMessage(std::string_view msg)
-    {
-        // Normalize to reduce uniqueness:
-        // - lower-case
-        // - replace integers with <n>
-        // - replace hex/uuid-like tokens with <id>
-        std::string s(msg);
-        for (char& c : s) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
-
-        // Replace UUID-ish / hex-ish tokens
-        // (simple heuristic, avoids pulling in a heavy tokenizer)
-        static const std::regex uuidLike(R"([0-9a-f]{8,})", std::regex::icase);
-        s = std::regex_replace(s, uuidLike, "<id>");
-
-        static const std::regex numbers(R"(\b\d+\b)");
-        s = std::regex_replace(s, numbers, "<n>");
-
-        // Collapse whitespace
-        std::string out;
-        out.reserve(s.size());
-        bool inWs = false;
-        for (char c : s)
-        {
-            if (std::isspace(static_cast<unsigned char>(c)))
-            {
-                if (!inWs) out.push_back(' ');
-                inWs = true;
-            }
-            else
-            {
-                out.push_back(c);
-                inWs = false;
-            }
-        }
-        // trim
-        while (!out.empty() && out.front() == ' ') out.erase(out.begin());
-        while (!out.empty() && out.back() == ' ') out.pop_back();
-        return out;
-    }
-
-    std::string BurstPatternDetector::signature(const core::LogEntry& e)
+    std::string BurstPatternDetector::signature(const Key& key)
     {
         std::ostringstream oss;
-        oss << e.source().value_or("unknown") << "|" << static_cast<int>(e.level()) << "|" << normalizeMessage(e.message());
+        oss << core::SourceTable::global().nameOr(key.sourceId, "unknown") << "|" << static_cast<int>(key.level) << "|"
+            << Analysis::TemplateMiner::global().text(key.templateId);
         return oss.str();
     }
 
@@ -75,10 +36,22 @@ namespace Anomaly
     std::vector<BurstPatternDetector::Burst> BurstPatternDetector::processEntry(const core::LogEntry& entry)
     {
         std::lock_guard<std::mutex> lock(m_mutex);
-        std::vector<Burst> out;
+        core::ResultSink<Burst> out;
+        processEntryUnlocked(entry, 0, out);
+        return out.takeValues();
+    }
+
+    void BurstPatternDetector::processBatch(core::Span<const core::LogEntry> entries, core::ResultSink<Burst>& out)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (std::size_t i = 0; i < entries.size(); ++i)
+            processEntryUnlocked(entries[i], i, out);
+    }
 
+    void BurstPatternDetector::processEntryUnlocked(const core::LogEntry& entry, std::size_t index, core::ResultSink<Burst>& out)
+    {
         const auto now = entry.timestamp();
-        const std::string key = signature(entry);
+        const Key key{Analysis::TemplateMiner::global().idOf(entry), entry.sourceId(), entry.level()};
         auto& st = m_states[key];
 
         st.events.emplace_back(now, entry);
@@ -88,7 +61,7 @@ namespace Anomaly
         if (c >= m_minRepeats)
         {
             Burst b;
-            b.key = key;
+            b.key = signature(key);
             b.level = entry.level();
             b.source = entry.source();
             b.windowStart = st.events.front().first;
@@ -109,10 +82,8 @@ namespace Anomaly
                 while (st.events.size() > keep) st.events.pop_front();
             }
 
-            out.push_back(std::move(b));
+            out.emit(index, std::move(b));
         }
-
-        return out;
     }
 
     void BurstPatternDetector::reset()
@@ -121,5 +92,42 @@ namespace Anomaly
         m_states.clear();
     }
 
+    void BurstPatternDetector::saveState(core::StateWriter& out) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        out.putSize(m_states.size());
+        for (const auto& [key, st] : m_states)
+        {
+            out.put(key.templateId);
+            out.put(key.sourceId);
+            out.put(key.level);
+            out.putSize(st.events.size());
+            for (const auto& [tp, entry] : st.events)
+            {
+                out.putTime(tp);
+                out.putEntry(entry);
+            }
+        }
+    }
+
+    void BurstPatternDetector::loadState(core::StateReader& in)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_states.clear();
+        for (std::size_t n = in.getSize(); n > 0; --n)
+        {
+            Key key;
+            key.templateId = in.get<core::TemplateId>();
+            key.sourceId = in.get<core::SourceId>();
+            key.level = in.get<core::LogLevel>();
+            auto& st = m_states[key];
+            for (std::size_t k = in.getSize(); k > 0; --k)
+            {
+                const auto tp = in.getTime();
+                st.events.emplace_back(tp, in.getEntry());
+            }
+        }
+    }
+
 } // namespace Anomaly
 } // namespace LogTool
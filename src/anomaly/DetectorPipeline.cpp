@@ -0,0 +1,194 @@
+#include "anomaly/DetectorPipeline.hpp"
+
+#include <algorithm>
+#include <future>
+#include <stdexcept>
+
+#include "anomaly/ShardedDetector.hpp"
+#include "utils/Logger.hpp"
+
+namespace LogTool
+{
+    namespace Anomaly
+    {
+        using namespace core;
+
+        DetectorPipeline::DetectorPipeline(const Options& options, const DetectorRegistry& registry)
+        {
+            // Canonical order = registry order, whatever order the names were given in.
+            std::vector<std::size_t> ranks;
+            if (options.detectors.empty())
+            {
+                for (std::size_t r = 0; r < registry.size(); ++r)
+                    ranks.push_back(r);
+            }
+            for (const auto& name : options.detectors)
+            {
+                const std::size_t r = registry.rank(name);
+                if (r == registry.size())
+                {
+                    std::string known;
+                    for (const auto& e : registry.entries())
+                        known += (known.empty() ? "" : ", ") + e.name;
+                    throw std::invalid_argument("Unknown detector '" + name + "' (available: " + known + ")");
+                }
+                ranks.push_back(r);
+            }
+            std::sort(ranks.begin(), ranks.end());
+            ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+
+            const std::size_t shards = Utils::ThreadPool::resolveThreadCount(options.shards);
+            for (const std::size_t r : ranks)
+            {
+                const auto& entry = registry.entries()[r];
+                std::unique_ptr<IDetector> detector = entry.factory(options.settings);
+                if (shards > 1 && detector->shardableBySource())
+                {
+                    DetectorSettings extra = options.settings;
+                    extra.shardInstance = true; // the first instance already logged its settings
+                    std::vector<std::unique_ptr<IDetector>> instances;
+                    instances.push_back(std::move(detector));
+                    while (instances.size() < shards)
+                        instances.push_back(entry.factory(extra));
+                    detector = std::make_unique<ShardedDetector>(std::move(instances));
+                }
+
+                Slot slot;
+                slot.flagsEntries = detector->flagsEntries();
+                const bool streaming = detector->kind() == IDetector::Kind::Streaming;
+                slot.detector = std::move(detector);
+                (streaming ? m_streaming : m_summary).push_back(std::move(slot));
+            }
+
+            const std::size_t threads = std::min(Utils::ThreadPool::resolveThreadCount(options.threads),
+                                                 m_streaming.size() + m_summary.size());
+            if (threads > 1)
+            {
+                m_pool = std::make_unique<Utils::ThreadPool>(threads);
+            }
+
+            std::string enabled;
+            for (const auto& name : names())
+                enabled += (enabled.empty() ? "" : ", ") + name;
+            Utils::getLogger().info("Detectors enabled: " + (enabled.empty() ? std::string("none") : enabled));
+        }
+
+        DetectorPipeline::~DetectorPipeline() = default;
+
+        std::vector<std::string> DetectorPipeline::names() const
+        {
+            std::vector<std::string> out;
+            for (const auto& slot : m_streaming)
+                out.push_back(slot.detector->name());
+            for (const auto& slot : m_summary)
+                out.push_back(slot.detector->name());
+            return out;
+        }
+
+        void DetectorPipeline::processBatch(const EntryBatch& batch, Stages stages)
+        {
+            if (!batch.isEnriched())
+                throw std::logic_error("DetectorPipeline: batch was not enriched");
+
+            std::vector<Slot*> slots;
+            if (stages != Stages::Summary)
+            {
+                for (auto& slot : m_streaming)
+                {
+                    slot.sink.clear();
+                    slot.next = 0;
+                    slots.push_back(&slot);
+                }
+            }
+            if (stages != Stages::Streaming)
+            {
+                for (auto& slot : m_summary)
+                    slots.push_back(&slot);
+            }
+            runSlots(slots, batch);
+        }
+
+        void DetectorPipeline::runSlots(const std::vector<Slot*>& slots, const EntryBatch& batch)
+        {
+            if (!m_pool || slots.size() < 2)
+            {
+                for (Slot* slot : slots)
+                    slot->detector->processBatch(batch, slot->sink);
+                return;
+            }
+
+            // Detectors share no state: run them side by side, then wait for all
+            // before propagating the first failure (tasks reference 'batch').
+            std::vector<std::future<void>> pending;
+            pending.reserve(slots.size());
+            for (Slot* slot : slots)
+            {
+                pending.push_back(m_pool->submit([slot, &batch]() { slot->detector->processBatch(batch, slot->sink); }));
+            }
+            for (auto& f : pending)
+                f.wait();
+            for (auto& f : pending)
+                f.get();
+        }
+
+        std::vector<core::Anomaly> DetectorPipeline::summarize(const IDetector::SummaryContext& context)
+        {
+            std::vector<core::Anomaly> out;
+            for (auto& slot : m_summary)
+                slot.detector->summarize(context, out);
+            return out;
+        }
+
+        bool DetectorPipeline::checkpointable() const
+        {
+            const auto ok = [](const Slot& slot) { return slot.detector->checkpointable(); };
+            return std::all_of(m_streaming.begin(), m_streaming.end(), ok) &&
+                   std::all_of(m_summary.begin(), m_summary.end(), ok);
+        }
+
+        std::string DetectorPipeline::layout() const
+        {
+            std::string out;
+            for (const auto* group : {&m_streaming, &m_summary})
+            {
+                for (const auto& slot : *group)
+                {
+                    out += (out.empty() ? "" : ",") + slot.detector->name();
+                    if (const auto* sharded = dynamic_cast<const ShardedDetector*>(slot.detector.get()))
+                        out += "/" + std::to_string(sharded->shardCount());
+                }
+            }
+            return out;
+        }
+
+        void DetectorPipeline::saveState(StateWriter& out) const
+        {
+            out.putSize(m_streaming.size() + m_summary.size());
+            for (const auto* group : {&m_streaming, &m_summary})
+            {
+                for (const auto& slot : *group)
+                {
+                    out.putString(slot.detector->name());
+                    slot.detector->saveState(out);
+                }
+            }
+        }
+
+        void DetectorPipeline::loadState(StateReader& in)
+        {
+            if (in.get<std::uint64_t>() != m_streaming.size() + m_summary.size())
+                throw std::runtime_error("Saved state is for a different detector selection");
+
+            for (auto* group : {&m_streaming, &m_summary})
+            {
+                for (auto& slot : *group)
+                {
+                    if (in.getStringView() != slot.detector->name())
+                        throw std::runtime_error("Saved state is for a different detector selection");
+                    slot.detector->loadState(in);
+                }
+            }
+        }
+
+    } // namespace Anomaly
+} // namespace LogTool
@@ -0,0 +1,407 @@
+#include "anomaly/DetectorRegistry.hpp"
+
+#include <algorithm>
+#include <type_traits>
+
+#include "analysis/FrequencyAnalyzer.hpp"
+#include "analysis/PatternAnalyzer.hpp"
+#include "analysis/TimeWindowAnalyzer.hpp"
+#include "anomaly/BurstPatternDetector.hpp"
+#include "anomaly/IpFrequencyDetector.hpp"
+#include "anomaly/RuleBasedDetector.hpp"
+#include "anomaly/SpikeDetector.hpp"
+#include "anomaly/StatisticalDetector.hpp"
+#include "utils/Logger.hpp"
+
+namespace LogTool
+{
+    namespace Anomaly
+    {
+        using core::EntryBatch;
+        using core::LogEntry;
+        using core::ResultSink;
+        using core::Span;
+
+        namespace
+        {
+            // ---------- Streaming detectors ----------
+
+            class RuleStage final : public IDetector
+            {
+            public:
+                std::string name() const override { return "rules"; }
+                Kind kind() const override { return Kind::Streaming; }
+                bool flagsEntries() const override { return true; }
+
+                void processBatch(const EntryBatch& batch, ResultSink<core::Anomaly>& out) override
+                {
+                    m_matches.clear();
+                    m_detector.processBatch(batch, m_matches);
+
+                    // Matches of one entry are converted together (one anomaly per rule hit).
+                    for (std::size_t k = 0; k < m_matches.size();)
+                    {
+                        const std::size_t index = m_matches[k].index;
+                        m_entryMatches.clear();
+                        for (; k < m_matches.size() && m_matches[k].index == index; ++k)
+                            m_entryMatches.push_back(std::move(m_matches[k].value));
+
+                        for (auto& a : m_detector.matchesToAnomalies(m_entryMatches, batch[index]))
+                            out.emit(index, std::move(a));
+                    }
+                }
+
+                bool checkpointable() const override { return true; }
+                void saveState(core::StateWriter& out) const override { m_detector.saveState(out); }
+                void loadState(core::StateReader& in) override { m_detector.loadState(in); }
+
+            private:
+                RuleBasedDetector                       m_detector;
+                ResultSink<RuleBasedDetector::RuleMatch> m_matches;
+                std::vector<RuleBasedDetector::RuleMatch> m_entryMatches;
+            };
+
+            class SpikeStage final : public IDetector
+            {
+            public:
+                explicit SpikeStage(const DetectorSettings& settings) : m_detector(!settings.shardInstance) {}
+
+                std::string name() const override { return "spike"; }
+                Kind kind() const override { return Kind::Streaming; }
+                bool shardableBySource() const override { return true; }
+
+                void processBatch(const EntryBatch& batch, ResultSink<core::Anomaly>& out) override
+                {
+                    m_spikes.clear();
+                    m_detector.processBatch(batch.entries(), m_spikes);
+                    convert(out);
+                }
+
+                bool checkpointable() const override { return true; }
+                void saveState(core::StateWriter& out) const override { m_detector.saveState(out); }
+                void loadState(core::StateReader& in) override { m_detector.loadState(in); }
+
+            private:
+                void convert(ResultSink<core::Anomaly>& out)
+                {
+                    for (auto& item : m_spikes)
+                    {
+                        auto& s = item.value;
+                        out.emit(item.index,
+                                 core::Anomaly(core::AnomalyType::FrequencySpike,
+                                               s.severity >= 0.9   ? core::AnomalySeverity::Critical
+                                               : s.severity >= 0.6 ? core::AnomalySeverity::High
+                                                                   : core::AnomalySeverity::Medium,
+                                               s.stats.windowStart,
+                                               s.stats.windowEnd,
+                                               s.stats.spikeRatio,
+                                               s.description,
+                                               s.stats.source.empty() ? std::optional<std::string>{}
+                                                                      : std::optional<std::string>(s.stats.source),
+                                               std::move(s.sampleEvents)));
+                    }
+                }
+
+                SpikeDetector                        m_detector;
+                ResultSink<SpikeDetector::SpikeAnomaly> m_spikes;
+            };
+
+            class StatisticalStage final : public IDetector
+            {
+            public:
+                explicit StatisticalStage(const DetectorSettings& settings) : m_detector(!settings.shardInstance) {}
+
+                std::string name() const override { return "stats"; }
+                Kind kind() const override { return Kind::Streaming; }
+                bool shardableBySource() const override { return true; }
+
+                void processBatch(const EntryBatch& batch, ResultSink<core::Anomaly>& out) override
+                {
+                    m_anomalies.clear();
+                    m_detector.processBatch(batch.entries(), m_anomalies);
+                    convert(batch.entries(), out);
+                }
+
+                bool checkpointable() const override { return true; }
+                void saveState(core::StateWriter& out) const override { m_detector.saveState(out); }
+                void loadState(core::StateReader& in) override { m_detector.loadState(in); }
+
+            private:
+                void convert(Span<const LogEntry> entries, ResultSink<core::Anomaly>& out)
+                {
+                    for (const auto& item : m_anomalies)
+                    {
+                        const auto& st = item.value;
+                        const LogEntry& entry = entries[item.index];
+                        out.emit(item.index,
+                                 core::Anomaly(core::AnomalyType::StatisticalOutlier,
+                                               st.severity >= 0.9   ? core::AnomalySeverity::High
+                                               : st.severity >= 0.6 ? core::AnomalySeverity::Medium
+                                                                    : core::AnomalySeverity::Low,
+                                               entry.timestamp(),
+                                               entry.timestamp(),
+                                               st.zscore,
+                                               st.description,
+                                               entry.source(),
+                                               {entry}));
+                    }
+                }
+
+                StatisticalDetector                     m_detector;
+                ResultSink<StatisticalDetector::Anomaly> m_anomalies;
+            };
+
+            class BurstStage final : public IDetector
+            {
+            public:
+                explicit BurstStage(const DetectorSettings& settings) : m_detector(!settings.shardInstance) {}
+
+                std::string name() const override { return "burst"; }
+                Kind kind() const override { return Kind::Streaming; }
+                bool shardableBySource() const override { return true; } // signatures include the source
+
+                void processBatch(const EntryBatch& batch, ResultSink<core::Anomaly>& out) override
+                {
+                    m_bursts.clear();
+                    m_detector.processBatch(batch.entries(), m_bursts);
+                    convert(out);
+                }
+
+                bool checkpointable() const override { return true; }
+                void saveState(core::StateWriter& out) const override { m_detector.saveState(out); }
+                void loadState(core::StateReader& in) override { m_detector.loadState(in); }
+
+            private:
+                void convert(ResultSink<core::Anomaly>& out)
+                {
+                    for (auto& item : m_bursts)
+                    {
+                        auto& br = item.value;
+                        out.emit(item.index,
+                                 core::Anomaly(core::AnomalyType::SequenceViolation,
+                                               core::AnomalySeverity::High,
+                                               br.windowStart,
+                                               br.windowEnd,
+                                               br.score,
+                                               br.description,
+                                               br.source,
+                                               std::move(br.samples)));
+                    }
+                }
+
+                BurstPatternDetector                  m_detector;
+                ResultSink<BurstPatternDetector::Burst> m_bursts;
+            };
+
+            class IpStage final : public IDetector
+            {
+            public:
+                std::string name() const override { return "ip"; }
+                Kind kind() const override { return Kind::Streaming; }
+
+                void processBatch(const EntryBatch& batch, ResultSink<core::Anomaly>& out) override
+                {
+                    m_hits.clear();
+                    m_detector.processBatch(batch, m_hits);
+                    for (const auto& item : m_hits)
+                    {
+                        const auto& hit = item.value;
+                        out.emit(item.index,
+                                 core::Anomaly(core::AnomalyType::RarePattern,
+                                               core::AnomalySeverity::Low,
+                                               hit.entry.timestamp(),
+                                               hit.entry.timestamp(),
+                                               1.0,
+                                               "Rare IP observed (count=" + std::to_string(hit.count) + "): " + hit.ip,
+                                               hit.entry.source(),
+                                               {hit.entry}));
+                    }
+                }
+
+                bool checkpointable() const override { return true; }
+                void saveState(core::StateWriter& out) const override { m_detector.saveState(out); }
+                void loadState(core::StateReader& in) override { m_detector.loadState(in); }
+
+            private:
+                IpFrequencyDetector                  m_detector;
+                ResultSink<IpFrequencyDetector::IpHit> m_hits;
+            };
+
+            // ---------- Summary analyzers ----------
+
+            class FrequencyStage final : public IDetector
+            {
+            public:
+                std::string name() const override { return "frequency"; }
+                Kind kind() const override { return Kind::Summary; }
+
+                void processBatch(const EntryBatch& batch, ResultSink<core::Anomaly>&) override
+                {
+                    m_analyzer.addBatch(batch.entries());
+                }
+
+                void summarize(const SummaryContext& context, std::vector<core::Anomaly>& out) override
+                {
+                    Utils::getLogger().debug("Running FrequencyAnalyzer...");
+                    const auto found = m_analyzer.detectAnomalies();
+                    Utils::getLogger().info("FrequencyAnalyzer produced " + std::to_string(found.size()) + " anomalies");
+                    for (const auto& d : found)
+                    {
+                        out.emplace_back(core::AnomalyType::FrequencySpike, core::AnomalySeverity::Medium,
+                                         context.start, context.end, 1.0, d, std::nullopt,
+                                         std::vector<LogEntry>{});
+                    }
+                }
+
+                bool checkpointable() const override { return true; }
+                void saveState(core::StateWriter& out) const override { m_analyzer.saveState(out); }
+                void loadState(core::StateReader& in) override { m_analyzer.loadState(in); }
+
+            private:
+                Analysis::FrequencyAnalyzer m_analyzer;
+            };
+
+            class PatternStage final : public IDetector
+            {
+            public:
+                explicit PatternStage(const DetectorSettings& settings)
+                {
+                    if (settings.maxPatterns > 0)
+                        m_analyzer.setMaxPatterns(settings.maxPatterns);
+                }
+
+                std::string name() const override { return "pattern"; }
+                Kind kind() const override { return Kind::Summary; }
+
+                void processBatch(const EntryBatch& batch, ResultSink<core::Anomaly>&) override
+                {
+                    m_analyzer.addBatch(batch.entries());
+                }
+
+                void summarize(const SummaryContext& context, std::vector<core::Anomaly>& out) override
+                {
+                    Utils::getLogger().debug("Running PatternAnalyzer...");
+                    const auto found = m_analyzer.detectAnomalies();
+                    Utils::getLogger().info("PatternAnalyzer produced " + std::to_string(found.size()) + " anomalies");
+                    for (const auto& d : found)
+                    {
+                        out.emplace_back(core::AnomalyType::SequenceViolation, core::AnomalySeverity::Medium,
+                                         context.start, context.end, 1.0, d, std::nullopt,
+                                         std::vector<LogEntry>{});
+                    }
+                }
+
+                bool checkpointable() const override { return true; }
+                void saveState(core::StateWriter& out) const override { m_analyzer.saveState(out); }
+                void loadState(core::StateReader& in) override { m_analyzer.loadState(in); }
+
+            private:
+                Analysis::PatternAnalyzer m_analyzer;
+            };
+
+            class TimeWindowStage final : public IDetector
+            {
+            public:
+                std::string name() const override { return "timewindow"; }
+                Kind kind() const override { return Kind::Summary; }
+
+                void processBatch(const EntryBatch& batch, ResultSink<core::Anomaly>&) override
+                {
+                    m_analyzer.addBatch(batch.entries());
+                }
+
+                void summarize(const SummaryContext&, std::vector<core::Anomaly>& out) override
+                {
+                    Utils::getLogger().debug("Running TimeWindowAnalyzer detectAnomalies()...");
+                    const auto found = m_analyzer.detectAnomalies();
+                    Utils::getLogger().info("TimeWindowAnalyzer produced " + std::to_string(found.size()) + " anomalies");
+                    for (const auto& tw : found)
+                    {
+                        // Map by description (simple but effective)
+                        const core::AnomalyType type = tw.description.find("Silence") != std::string::npos
+                                                           ? core::AnomalyType::Silence
+                                                           : core::AnomalyType::FrequencySpike;
+                        const core::AnomalySeverity sev = tw.score >= 0.9   ? core::AnomalySeverity::High
+                                                          : tw.score >= 0.6 ? core::AnomalySeverity::Medium
+                                                                            : core::AnomalySeverity::Low;
+                        out.emplace_back(type, sev, tw.stats.windowStart, tw.stats.windowEnd, tw.score,
+                                         tw.description, std::nullopt, std::vector<LogEntry>{});
+                    }
+                }
+
+                bool checkpointable() const override { return true; }
+                void saveState(core::StateWriter& out) const override { m_analyzer.saveState(out); }
+                void loadState(core::StateReader& in) override { m_analyzer.loadState(in); }
+
+            private:
+                Analysis::TimeWindowAnalyzer m_analyzer;
+            };
+
+            // Stages with tunables take the settings in their constructor.
+            template <typename Stage>
+            DetectorRegistry::Factory factoryFor()
+            {
+                return [](const DetectorSettings& settings) -> std::unique_ptr<IDetector>
+                {
+                    if constexpr (std::is_constructible_v<Stage, const DetectorSettings&>)
+                        return std::make_unique<Stage>(settings);
+                    else
+                        return std::make_unique<Stage>();
+                };
+            }
+        } // namespace
+
+        void DetectorRegistry::add(std::string name, std::string description, Factory factory)
+        {
+            auto it = std::find_if(m_entries.begin(), m_entries.end(),
+                                   [&](const Entry& e) { return e.name == name; });
+            if (it != m_entries.end())
+            {
+                it->description = std::move(description);
+                it->factory = std::move(factory);
+                return;
+            }
+            m_entries.push_back(Entry{std::move(name), std::move(description), std::move(factory)});
+        }
+
+        std::unique_ptr<IDetector> DetectorRegistry::create(std::string_view name, const DetectorSettings& settings) const
+        {
+            const std::size_t r = rank(name);
+            return r < m_entries.size() ? m_entries[r].factory(settings) : nullptr;
+        }
+
+        bool DetectorRegistry::contains(std::string_view name) const
+        {
+            return rank(name) < m_entries.size();
+        }
+
+        std::size_t DetectorRegistry::rank(std::string_view name) const
+        {
+            for (std::size_t i = 0; i < m_entries.size(); ++i)
+            {
+                if (m_entries[i].name == name)
+                    return i;
+            }
+            return m_entries.size();
+        }
+
+        const DetectorRegistry& DetectorRegistry::builtin()
+        {
+            static const DetectorRegistry registry = []()
+            {
+                DetectorRegistry r;
+                r.add("rules", "Rule-based matching (keywords, regex, thresholds)", factoryFor<RuleStage>());
+                r.add("spike", "Per-source event-rate spikes against a sliding baseline", factoryFor<SpikeStage>());
+                r.add("stats", "Per-source Z-score outliers of the event rate", factoryFor<StatisticalStage>());
+                r.add("burst", "Bursts of the same normalized message", factoryFor<BurstStage>());
+                r.add("ip", "Rare client IP addresses", factoryFor<IpStage>());
+                r.add("frequency", "Whole-file message/source frequency outliers", factoryFor<FrequencyStage>());
+                r.add("pattern", "Whole-file repeated message patterns", factoryFor<PatternStage>());
+                r.add("timewindow", "Per-window error rate, bursts and silences", factoryFor<TimeWindowStage>());
+                return r;
+            }();
+            return registry;
+        }
+
+    } // namespace Anomaly
+} // namespace LogTool
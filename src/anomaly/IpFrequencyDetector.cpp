@@ -11,43 +11,85 @@ namespace Anomaly
         Utils::getLogger().info("IpFrequencyDetector initialized");
     }
 
-    std::optional<std::string> IpFrequencyDetector::extractIp(std::string_view message)
+    std::vector<IpFrequencyDetector::IpHit> IpFrequencyDetector::processEntry(const core::LogEntry& entry)
     {
-        // Very standard IPv4 regex (0-255 check is not strict; good enough for logs)
-        static const std::regex ipRe(R"((\b\d{1,3}(?:\.\d{1,3}){3}\b))");
-        std::cmatch m;
-        if (std::regex_search(message.begin(), message.end(), m, ipRe) && m.size() >= 2)
-        {
-            return std::string(m[1].str());
-        }
-        return std::nullopt;
+        core::Enrichment facts;
+        facts.compute(core::Span<const core::LogEntry>(&entry, 1));
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        core::ResultSink<IpHit> out;
+        processEntryUnlocked(core::EnrichedEntry(entry, facts, 0), 0, out);
+        return out.takeValues();
     }
 
-    std::vector<IpFrequencyDetector::IpHit> IpFrequencyDetector::processEntry(const core::LogEntry& entry)
+    void IpFrequencyDetector::processBatch(const core::EntryBatch& batch, core::ResultSink<IpHit>& out)
     {
         std::lock_guard<std::mutex> lock(m_mutex);
-        std::vector<IpHit> out;
+        for (std::size_t i = 0; i < batch.size(); ++i)
+            processEntryUnlocked(batch.enriched(i), i, out);
+    }
 
-        auto ip = extractIp(entry.message());
-        if (!ip) return out;
+    void IpFrequencyDetector::processEntryUnlocked(const core::EnrichedEntry& entry, std::size_t index, core::ResultSink<IpHit>& out)
+    {
+        // The first address of the line (scanned once by the enrichment stage)
+        if (entry.ipCount() == 0) return;
+        const core::IpAddress& ip = entry.ip(0);
 
-        const std::size_t newCount = ++m_counts[*ip];
+        const std::size_t newCount = ip.family == core::IpAddress::Family::V4 ? m_v4Counts.add(ip.v4)
+                                                                              : m_v6Counts.add(ip.v6);
         if (newCount <= m_maxCountForRare)
         {
             // Emit only on first few occurrences so the operator sees it early.
             IpHit h;
-            h.ip = *ip;
+            h.ip = ip.toString();
             h.count = newCount;
-            h.entry = entry;
-            out.push_back(std::move(h));
+            h.entry = entry.entry();
+            out.emit(index, std::move(h));
         }
-        return out;
     }
 
     void IpFrequencyDetector::reset()
     {
         std::lock_guard<std::mutex> lock(m_mutex);
-        m_counts.clear();
+        m_v4Counts.clear();
+        m_v6Counts.clear();
+    }
+
+    void IpFrequencyDetector::saveState(core::StateWriter& out) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        out.putSize(m_v4Counts.size());
+        m_v4Counts.forEach([&out](std::uint32_t ip, std::uint32_t count)
+        {
+            out.put(ip);
+            out.put(count);
+        });
+        out.putSize(m_v6Counts.size());
+        m_v6Counts.forEach([&out](const core::Ipv6Address& ip, std::uint32_t count)
+        {
+            out.put(ip.hi);
+            out.put(ip.lo);
+            out.put(count);
+        });
+    }
+
+    void IpFrequencyDetector::loadState(core::StateReader& in)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_v4Counts.clear();
+        m_v6Counts.clear();
+        for (std::size_t n = in.getSize(); n > 0; --n)
+        {
+            const auto ip = in.get<std::uint32_t>();
+            m_v4Counts.add(ip, in.get<std::uint32_t>());
+        }
+        for (std::size_t n = in.getSize(); n > 0; --n)
+        {
+            core::Ipv6Address ip;
+            ip.hi = in.get<std::uint64_t>();
+            ip.lo = in.get<std::uint64_t>();
+            m_v6Counts.add(ip, in.get<std::uint32_t>());
+        }
     }
 
 } // namespace Anomaly
@@ -16,11 +16,11 @@ namespace LogTool::Anomaly
         return v.value_or(std::string{});
     }
 
-    static std::string makeCacheKey(const core::LogEntry& entry)
+    // Cache key: message fingerprint mixed with the source ID (hits are
+    // verified against the stored source and message, see checkCache()).
+    static std::uint64_t makeCacheKey(const core::EnrichedEntry& entry)
     {
-        // source() is optional<string> in your core::LogEntry (based on your error)
-        // message() is a function (based on your earlier error)
-        return optToString(entry.source()) + "|" + entry.message();
+        return entry.fingerprint() ^ (static_cast<std::uint64_t>(entry.entry().sourceId()) * 0x9e3779b97f4a7c15ull);
     }
 
     static std::string trimLeft(std::string s)
@@ -121,27 +121,28 @@ namespace LogTool::Anomaly
 
     // ---------- cache ----------
     std::optional<std::vector<RuleBasedDetector::RuleMatch>>
-    RuleBasedDetector::checkCache(const core::LogEntry& entry) const
+    RuleBasedDetector::checkCache(const core::EnrichedEntry& entry) const
     {
         if (!m_cachingEnabled) return std::nullopt;
 
-        const std::string key = makeCacheKey(entry);
+        const std::uint64_t key = makeCacheKey(entry);
 
         std::shared_lock<std::shared_mutex> lock(m_cacheMutex);
         auto it = m_cache.find(key);
-        if (it == m_cache.end())
+        if (it == m_cache.end() || it->second.source != entry.entry().sourceId() ||
+            it->second.message != entry.message())
             return std::nullopt;
 
         m_cacheHits.fetch_add(1, std::memory_order_relaxed);
         return it->second.matches;
     }
 
-    void RuleBasedDetector::updateCache(const core::LogEntry& entry,
+    void RuleBasedDetector::updateCache(const core::EnrichedEntry& entry,
                                         const std::vector<RuleMatch>& matches)
     {
         if (!m_cachingEnabled) return;
 
-        const std::string key = makeCacheKey(entry);
+        const std::uint64_t key = makeCacheKey(entry);
 
         std::unique_lock<std::shared_mutex> lock(m_cacheMutex);
 
@@ -149,11 +150,39 @@ namespace LogTool::Anomaly
             m_cache.erase(m_cache.begin());
 
         CacheEntry ce;
+        ce.source = entry.entry().sourceId();
+        ce.message.assign(entry.message());
         ce.matches = matches;
         ce.timestamp = std::chrono::system_clock::now();
         m_cache[key] = std::move(ce);
     }
 
+    void RuleBasedDetector::saveState(core::StateWriter& out) const
+    {
+        std::shared_lock<std::shared_mutex> lock(m_trackersMutex);
+        out.putSize(m_timeTrackers.size());
+        for (const auto& [ruleId, tracker] : m_timeTrackers)
+        {
+            std::lock_guard<std::mutex> trackerLock(tracker->mutex);
+            out.putString(ruleId);
+            out.putSize(tracker->maxSize);
+            out.putTimes(tracker->events);
+        }
+    }
+
+    void RuleBasedDetector::loadState(core::StateReader& in)
+    {
+        std::unique_lock<std::shared_mutex> lock(m_trackersMutex);
+        m_timeTrackers.clear();
+        for (std::size_t n = in.getSize(); n > 0; --n)
+        {
+            auto ruleId = in.getString();
+            auto tracker = std::make_unique<TimeWindowTracker>(in.get<std::uint64_t>());
+            in.getTimes(tracker->events);
+            m_timeTrackers[std::move(ruleId)] = std::move(tracker);
+        }
+    }
+
     void RuleBasedDetector::clearCaches()
     {
         {
@@ -208,49 +237,53 @@ namespace LogTool::Anomaly
         switch (rule.type)
         {
             case RuleType::KEYWORD:
-                return [this, rule](const core::LogEntry& e, RuleMatch& m) {
-                    return checkKeywordRule(e, rule.condition, m);
+            {
+                // Matched against the entry's upper-cased view: upper-case the keywords once here.
+                const std::string upper = Utils::toUpper(rule.condition);
+                return [this, rule, upper](const core::EnrichedEntry& e, RuleMatch& m) {
+                    return checkKeywordRule(e, upper, rule.condition, m);
                 };
+            }
 
             case RuleType::SOURCE:
-                return [this, rule](const core::LogEntry& e, RuleMatch& m) {
-                    return checkSourceRule(e, rule.condition, m);
+                return [this, rule](const core::EnrichedEntry& e, RuleMatch& m) {
+                    return checkSourceRule(e.entry(), rule.condition, m);
                 };
 
             case RuleType::THRESHOLD:
-                return [this, rule](const core::LogEntry& e, RuleMatch& m) {
-                    return checkThresholdRule(e, rule, m);
+                return [this, rule](const core::EnrichedEntry& e, RuleMatch& m) {
+                    return checkThresholdRule(e.entry(), rule, m);
                 };
 
             case RuleType::TIME_WINDOW:
-                return [this, rule](const core::LogEntry& e, RuleMatch& m) {
-                    return checkTimeWindowRule(e, rule, m);
+                return [this, rule](const core::EnrichedEntry& e, RuleMatch& m) {
+                    return checkTimeWindowRule(e.entry(), rule, m);
                 };
 
             case RuleType::SEQUENCE:
-                return [this, rule](const core::LogEntry& e, RuleMatch& m) {
-                    return checkSequenceRule(e, rule, m);
+                return [this, rule](const core::EnrichedEntry& e, RuleMatch& m) {
+                    return checkSequenceRule(e.entry(), rule, m);
                 };
 
             case RuleType::PATTERN:
-                return [this, rule](const core::LogEntry& e, RuleMatch& m) {
-                    return checkPatternRule(e, rule.condition, m);
+                return [this, rule](const core::EnrichedEntry& e, RuleMatch& m) {
+                    return checkPatternRule(e.entry(), rule.condition, m);
                 };
 
             case RuleType::COMPOSITE:
-                return [this, rule](const core::LogEntry& e, RuleMatch& m) {
-                    return checkCompositeRule(e, rule, m);
+                return [this, rule](const core::EnrichedEntry& e, RuleMatch& m) {
+                    return checkCompositeRule(e.entry(), rule, m);
                 };
 
             case RuleType::CUSTOM:
-                return [this, rule](const core::LogEntry& e, RuleMatch& m) {
+                return [this, rule](const core::EnrichedEntry& e, RuleMatch& m) {
                     std::shared_lock<std::shared_mutex> plock(m_pluginsMutex);
                     for (const auto& kv : m_plugins)
                     {
                         if (!kv.second) continue;
                         if (kv.second->getPluginType() != RuleType::CUSTOM) continue;
 
-                        if (kv.second->evaluate(e, rule))
+                        if (kv.second->evaluate(e.entry(), rule))
                         {
                             m.ruleName = rule.name;
                             m.ruleId = rule.id;
@@ -271,17 +304,17 @@ namespace LogTool::Anomaly
                 const auto lvlOpt = parseLogLevelLoose(rule.condition);
                 if (!lvlOpt)
                 {
-                    return [](const core::LogEntry&, RuleMatch&) { return false; };
+                    return [](const core::EnrichedEntry&, RuleMatch&) { return false; };
                 }
 
                 const core::LogLevel lvl = *lvlOpt;
-                return [this, lvl, rule](const core::LogEntry& e, RuleMatch& m) {
-                    return checkLevelRule(e, lvl, m);
+                return [this, lvl, rule](const core::EnrichedEntry& e, RuleMatch& m) {
+                    return checkLevelRule(e.entry(), lvl, m);
                 };
             }
         }
 
-        return [](const core::LogEntry&, RuleMatch&) { return false; };
+        return [](const core::EnrichedEntry&, RuleMatch&) { return false; };
     }
 
     void RuleBasedDetector::sortRulesByPriority()
@@ -305,6 +338,16 @@ namespace LogTool::Anomaly
     // ---------- public: check ----------
     std::vector<RuleBasedDetector::RuleMatch>
     RuleBasedDetector::checkEntry(const core::LogEntry& entry)
+    {
+        core::Enrichment facts;
+        facts.compute(core::Span<const core::LogEntry>(&entry, 1));
+
+        std::shared_lock<std::shared_mutex> lock(m_rulesMutex);
+        return checkEntryLocked(core::EnrichedEntry(entry, facts, 0));
+    }
+
+    std::vector<RuleBasedDetector::RuleMatch>
+    RuleBasedDetector::checkEntryLocked(const core::EnrichedEntry& entry)
     {
         m_totalChecks.fetch_add(1, std::memory_order_relaxed);
 
@@ -315,8 +358,6 @@ namespace LogTool::Anomaly
 
         std::vector<RuleMatch> matches;
 
-        std::shared_lock<std::shared_mutex> lock(m_rulesMutex);
-
         for (const auto& cr : m_compiledRules)
         {
             if (!cr) continue;
@@ -347,15 +388,31 @@ namespace LogTool::Anomaly
     }
 
     std::vector<std::vector<RuleBasedDetector::RuleMatch>>
-    RuleBasedDetector::checkEntries(const std::vector<core::LogEntry>& entries)
+    RuleBasedDetector::checkEntries(core::Span<const core::LogEntry> entries)
     {
         std::vector<std::vector<RuleMatch>> out;
         out.reserve(entries.size());
-        for (const auto& e : entries)
-            out.push_back(checkEntry(e));
+
+        core::Enrichment facts;
+        facts.compute(entries);
+
+        std::shared_lock<std::shared_mutex> lock(m_rulesMutex);
+        for (std::size_t i = 0; i < entries.size(); ++i)
+            out.push_back(checkEntryLocked(core::EnrichedEntry(entries[i], facts, i)));
         return out;
     }
 
+    void RuleBasedDetector::processBatch(const core::EntryBatch& batch,
+                                         core::ResultSink<RuleMatch>& out)
+    {
+        std::shared_lock<std::shared_mutex> lock(m_rulesMutex);
+        for (std::size_t i = 0; i < batch.size(); ++i)
+        {
+            for (auto& m : checkEntryLocked(batch.enriched(i)))
+                out.emit(i, std::move(m));
+        }
+    }
+
     // ---------- loading rules ----------
     std::size_t RuleBasedDetector::loadRules(const Utils::ConfigLoader& config, bool merge)
     {
@@ -556,14 +613,12 @@ namespace LogTool::Anomaly
     }
 
     // ---------- rule checks ----------
-    bool RuleBasedDetector::checkKeywordRule(const core::LogEntry& entry,
+    bool RuleBasedDetector::checkKeywordRule(const core::EnrichedEntry& entry,
+                                             const std::string& keywordsUpper,
                                              const std::string& keywords,
                                              RuleMatch& match) const
     {
-        const std::string msgUp = Utils::toUpper(entry.message());
-        const std::string kwUp  = Utils::toUpper(keywords);
-
-        if (!Utils::contains(msgUp, kwUp))
+        if (entry.upper().find(keywordsUpper) == std::string_view::npos)
             return false;
 
         match.details = "KEYWORD match: " + keywords;
@@ -0,0 +1,119 @@
+#include "anomaly/ShardedDetector.hpp"
+
+#include <future>
+#include <stdexcept>
+
+#include "utils/Logger.hpp"
+
+namespace LogTool
+{
+    namespace Anomaly
+    {
+        using namespace core;
+
+        ShardedDetector::ShardedDetector(std::vector<std::unique_ptr<IDetector>> shards)
+            : m_shards(std::move(shards))
+        {
+            const std::size_t n = m_shards.size();
+            m_rows.resize(n);
+            m_batches.resize(n);
+            m_parts.resize(n);
+            if (n > 1)
+            {
+                m_pool = std::make_unique<Utils::ThreadPool>(n);
+            }
+            Utils::getLogger().info("Detector '" + name() + "' sharded by source (" + std::to_string(n) + " shards)");
+        }
+
+        ShardedDetector::~ShardedDetector() = default;
+
+        void ShardedDetector::processBatch(const EntryBatch& batch, ResultSink<core::Anomaly>& out)
+        {
+            // Partition row indices by source shard (ascending within each shard).
+            for (auto& rows : m_rows)
+            {
+                rows.clear();
+            }
+            const auto& sources = batch.sourceIds();
+            for (std::size_t i = 0; i < sources.size(); ++i)
+            {
+                m_rows[shardOf(sources[i])].push_back(static_cast<std::uint32_t>(i));
+            }
+
+            auto runShard = [this, &batch](std::size_t s)
+            {
+                auto& shardBatch = m_batches[s];
+                shardBatch.clear();
+                for (const std::uint32_t row : m_rows[s])
+                {
+                    shardBatch.append(batch, row);
+                }
+
+                m_parts[s].clear();
+                m_shards[s]->processBatch(shardBatch, m_parts[s]);
+                for (auto& item : m_parts[s])
+                {
+                    item.index = m_rows[s][item.index];
+                }
+            };
+
+            if (!m_pool)
+            {
+                runShard(0);
+            }
+            else
+            {
+                std::vector<std::future<void>> pending;
+                pending.reserve(m_shards.size());
+                for (std::size_t s = 0; s < m_shards.size(); ++s)
+                {
+                    if (!m_rows[s].empty())
+                    {
+                        pending.push_back(m_pool->submit([&runShard, s]() { runShard(s); }));
+                    }
+                }
+                for (auto& f : pending)
+                {
+                    f.wait();
+                }
+                for (auto& f : pending)
+                {
+                    f.get(); // rethrows a shard's exception
+                }
+            }
+
+            out.mergeByIndex(m_parts);
+        }
+
+        void ShardedDetector::summarize(const SummaryContext& context, std::vector<core::Anomaly>& out)
+        {
+            for (auto& shard : m_shards)
+            {
+                shard->summarize(context, out);
+            }
+        }
+
+        void ShardedDetector::saveState(StateWriter& out) const
+        {
+            out.putSize(m_shards.size());
+            for (const auto& shard : m_shards)
+            {
+                shard->saveState(out);
+            }
+        }
+
+        void ShardedDetector::loadState(StateReader& in)
+        {
+            // Sources map to shards by ID modulo the shard count.
+            if (in.get<std::uint64_t>() != m_shards.size())
+            {
+                throw std::runtime_error("Detector '" + name() + "' was saved with a different shard count");
+            }
+            for (auto& shard : m_shards)
+            {
+                shard->loadState(in);
+            }
+        }
+
+    } // namespace Anomaly
+} // namespace LogTool
@@ -13,8 +13,10 @@ namespace LogTool
         using namespace core;
         using namespace Utils;
 
-        SpikeDetector::SpikeDetector()
+        SpikeDetector::SpikeDetector(bool announce)
         {
+            if (!announce)
+                return;
             Logger& logger = getLogger();
             logger.info("SpikeDetector initialized (threshold: " + 
                        std::to_string(m_spikeThreshold) + "x, short: " + 
@@ -24,20 +26,40 @@ namespace LogTool
         std::vector<SpikeDetector::SpikeAnomaly> SpikeDetector::processEntry(const LogEntry& entry)
         {
             std::lock_guard<std::mutex> lock(m_mutex);
-            
-            std::vector<SpikeAnomaly> anomalies;
+            ResultSink<SpikeAnomaly> out;
+            processEntryUnlocked(entry, 0, out);
+            return out.takeValues();
+        }
+
+        void SpikeDetector::processBatch(Span<const LogEntry> entries, ResultSink<SpikeAnomaly>& out)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (std::size_t i = 0; i < entries.size(); ++i)
+            {
+                processEntryUnlocked(entries[i], i, out);
+            }
+        }
+
+        void SpikeDetector::processEntryUnlocked(const LogEntry& entry,
+                                                 std::size_t index,
+                                                 ResultSink<SpikeAnomaly>& out)
+        {
             auto nowTime = entry.timestamp();
             
             // Get or create source state
-            const auto srcOpt = entry.source();
-            if (!srcOpt || srcOpt->empty())
+            const SourceId id = entry.sourceId();
+            if (id == kNoSource)
             {
                 // No source -> can't track per-source spikes
-                return {};
+                return;
             }
 
-            const std::string& src = *srcOpt;
-            auto& state = m_sourceStates[src];
+            if (id >= m_sourceStates.size())
+            {
+                m_sourceStates.resize(static_cast<std::size_t>(id) + 1);
+            }
+            auto& state = m_sourceStates[id];
+            state.active = true;
 
             
             // Advance windows based on current timestamp
@@ -74,24 +96,24 @@ namespace LogTool
             }
             
             // Check for spike
-            SpikeStats stats = calculateStats(state, src, nowTime);
+            SpikeStats stats = calculateStats(state, nowTime);
             if (isSpike(stats))
             {
-                auto anomaly = createAnomaly(stats, state.samples);
-                anomalies.push_back(anomaly);
+                stats.source = *entry.source(); // resolve the name only when reporting
+                out.emit(index, createAnomaly(stats, state.samples));
             }
-            
-            return anomalies;
         }
 
         std::optional<SpikeDetector::SpikeStats> SpikeDetector::getStats(const std::string& source) const
         {
+            const auto id = SourceTable::global().find(source);
             std::lock_guard<std::mutex> lock(m_mutex);
-            auto it = m_sourceStates.find(source);
-            if (it == m_sourceStates.end())
+            if (!id || *id >= m_sourceStates.size() || !m_sourceStates[*id].active)
                 return std::nullopt;
-                
-            return calculateStats(it->second, source, now());
+
+            SpikeStats stats = calculateStats(m_sourceStates[*id], now());
+            stats.source = source;
+            return stats;
         }
 
         std::vector<SpikeDetector::SpikeAnomaly> SpikeDetector::checkAllSpikes() const
@@ -100,11 +122,16 @@ namespace LogTool
             std::vector<SpikeAnomaly> anomalies;
             auto nowTime = now();
             
-            for (const auto& [source, state] : m_sourceStates)
+            for (SourceId id = 0; id < m_sourceStates.size(); ++id)
             {
-                SpikeStats stats = calculateStats(state, source, nowTime);
+                const auto& state = m_sourceStates[id];
+                if (!state.active)
+                    continue;
+
+                SpikeStats stats = calculateStats(state, nowTime);
                 if (isSpike(stats))
                 {
+                    stats.source = SourceTable::global().nameOr(id, "");
                     SpikeAnomaly anomaly;
                     anomaly.description = "Active spike detected";
                     anomaly.severity = std::min(1.0, (stats.spikeRatio - 1.0) / (m_spikeThreshold - 1.0));
@@ -123,6 +150,40 @@ namespace LogTool
             getLogger().debug("SpikeDetector reset");
         }
 
+        void SpikeDetector::saveState(StateWriter& out) const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            out.putSize(m_sourceStates.size());
+            for (const auto& st : m_sourceStates)
+            {
+                out.put<std::uint8_t>(st.active ? 1 : 0);
+                out.putTimes(st.recentEvents);
+                out.putSize(st.currentCount);
+                out.putTimes(st.baselineEvents);
+                out.putSize(st.baselineCount);
+                out.putSize(st.previousCount);
+                out.putEntries(st.samples);
+                out.putTime(st.lastWindowAdvance);
+            }
+        }
+
+        void SpikeDetector::loadState(StateReader& in)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_sourceStates.assign(in.getSize(), SourceState{});
+            for (auto& st : m_sourceStates)
+            {
+                st.active = in.get<std::uint8_t>() != 0;
+                in.getTimes(st.recentEvents);
+                st.currentCount = in.get<std::uint64_t>();
+                in.getTimes(st.baselineEvents);
+                st.baselineCount = in.get<std::uint64_t>();
+                st.previousCount = in.get<std::uint64_t>();
+                in.getEntries(st.samples);
+                st.lastWindowAdvance = in.getTime();
+            }
+        }
+
         void SpikeDetector::setSpikeThreshold(double ratio) noexcept
         {
             std::lock_guard<std::mutex> lock(m_mutex);
@@ -156,11 +217,9 @@ namespace LogTool
         }
 
         SpikeDetector::SpikeStats SpikeDetector::calculateStats(const SourceState& state, 
-                                                              const std::string& source,
                                                               TimePoint now) const
         {
             SpikeStats stats;
-            stats.source = source;
             stats.currentCount = state.currentCount;
             stats.baselineCount = state.baselineCount ? state.baselineCount : 1;
             stats.windowStart = now - m_shortWindow;
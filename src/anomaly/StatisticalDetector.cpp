@@ -18,8 +18,10 @@ namespace LogTool
         using namespace core;
         using namespace Utils;
 
-        StatisticalDetector::StatisticalDetector()
+        StatisticalDetector::StatisticalDetector(bool announce)
         {
+            if (!announce)
+                return;
             Logger& logger = getLogger();
             logger.info("StatisticalDetector initialized (Z-threshold: " +
                         std::to_string(m_zScoreThreshold) + ")");
@@ -29,11 +31,31 @@ namespace LogTool
         StatisticalDetector::processEntry(const LogEntry& entry)
         {
             std::lock_guard<std::mutex> lock(m_mutex);
+            ResultSink<Anomaly> out;
+            processEntryUnlocked(entry, 0, out);
+            return out.takeValues();
+        }
 
-            std::vector<Anomaly> anomalies;
+        void StatisticalDetector::processBatch(Span<const LogEntry> entries, ResultSink<Anomaly>& out)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (std::size_t i = 0; i < entries.size(); ++i)
+            {
+                processEntryUnlocked(entries[i], i, out);
+            }
+        }
 
-            // LogEntry::source() is std::optional<std::string>
-            const std::string source = entry.source().value_or("<unknown>");
+        void StatisticalDetector::processEntryUnlocked(const LogEntry& entry,
+                                                       std::size_t index,
+                                                       ResultSink<Anomaly>& out)
+        {
+            // Entries without a source share slot kNoSource ("<unknown>")
+            const SourceId source = entry.sourceId();
+            if (source >= m_sourceStats.size())
+            {
+                m_sourceStats.resize(static_cast<std::size_t>(source) + 1);
+                m_recentBySource.resize(static_cast<std::size_t>(source) + 1);
+            }
 
             // Calculate event rate (events per minute) for this source using log timestamps
             double eventRate = calculateEventRate(source, entry.timestamp());
@@ -70,22 +92,21 @@ namespace LogTool
 
             if (isAnomaly(zscore))
             {
-                anomalies.push_back(createAnomaly(entry, stats, zscore));
+                out.emit(index, createAnomaly(entry, stats, zscore));
             }
-
-            return anomalies;
         }
 
         std::optional<StatisticalDetector::Stats>
         StatisticalDetector::getStats(const std::string& source) const
         {
+            const auto id = (source == "<unknown>") ? std::optional<SourceId>(kNoSource)
+                                                    : SourceTable::global().find(source);
             std::lock_guard<std::mutex> lock(m_mutex);
 
-            auto it = m_sourceStats.find(source);
-            if (it == m_sourceStats.end())
+            if (!id || *id >= m_sourceStats.size() || m_sourceStats[*id].count == 0)
                 return std::nullopt;
 
-            const auto& onlineStats = it->second;
+            const auto& onlineStats = m_sourceStats[*id];
             Stats stats;
             stats.mean = onlineStats.mean;
             stats.stddev = onlineStats.stddev();
@@ -99,13 +120,17 @@ namespace LogTool
             std::lock_guard<std::mutex> lock(m_mutex);
 
             std::unordered_map<std::string, Stats> result;
-            for (const auto& [source, onlineStats] : m_sourceStats)
+            for (SourceId id = 0; id < m_sourceStats.size(); ++id)
             {
+                const auto& onlineStats = m_sourceStats[id];
+                if (onlineStats.count == 0)
+                    continue;
+
                 Stats stats;
                 stats.mean = onlineStats.mean;
                 stats.stddev = onlineStats.stddev();
                 stats.count = onlineStats.count;
-                result[source] = stats;
+                result[SourceTable::global().nameOr(id, "<unknown>")] = stats;
             }
             return result;
         }
@@ -127,6 +152,55 @@ namespace LogTool
             getLogger().debug("StatisticalDetector reset");
         }
 
+        namespace
+        {
+            template <typename Stats>
+            void writeStats(core::StateWriter& out, const Stats& s)
+            {
+                out.put(s.mean);
+                out.put(s.m2);
+                out.putSize(s.count);
+                out.putSize(s.window.size());
+                for (const double v : s.window)
+                    out.put(v);
+            }
+
+            template <typename Stats>
+            void readStats(core::StateReader& in, Stats& s)
+            {
+                s.mean = in.get<double>();
+                s.m2 = in.get<double>();
+                s.count = in.get<std::uint64_t>();
+                s.window.clear();
+                for (std::size_t n = in.getSize(); n > 0; --n)
+                    s.window.push_back(in.get<double>());
+            }
+        } // namespace
+
+        void StatisticalDetector::saveState(core::StateWriter& out) const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            writeStats(out, m_globalStats);
+            out.putSize(m_sourceStats.size());
+            for (const auto& s : m_sourceStats)
+                writeStats(out, s);
+            out.putSize(m_recentBySource.size());
+            for (const auto& recent : m_recentBySource)
+                out.putTimes(recent);
+        }
+
+        void StatisticalDetector::loadState(core::StateReader& in)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            readStats(in, m_globalStats);
+            m_sourceStats.assign(in.getSize(), OnlineStats{});
+            for (auto& s : m_sourceStats)
+                readStats(in, s);
+            m_recentBySource.assign(in.getSize(), {});
+            for (auto& recent : m_recentBySource)
+                in.getTimes(recent);
+        }
+
         void StatisticalDetector::setZScoreThreshold(double threshold) noexcept
         {
             std::lock_guard<std::mutex> lock(m_mutex);
@@ -179,7 +253,7 @@ namespace LogTool
 
         // --- Core Detection Logic ---
 
-        double StatisticalDetector::calculateEventRate(const std::string& source, Utils::TimePoint ts)
+        double StatisticalDetector::calculateEventRate(SourceId source, Utils::TimePoint ts)
         {
             auto& dq = m_recentBySource[source];
             dq.push_back(ts);
@@ -0,0 +1,162 @@
+#include "input/Checkpoint.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include "core/StateCodec.hpp"
+#include "utils/Logger.hpp"
+
+#include <sys/stat.h>
+
+namespace LogTool
+{
+    namespace Input
+    {
+        namespace
+        {
+            constexpr std::string_view kMagic = "LOGTOOL-CHECKPOINT";
+            constexpr std::uint32_t    kVersion = 8;
+            constexpr std::uint32_t    kByteOrderMark = 0x01020304u; // native order check
+
+            // 64-bit FNV-1a.
+            std::uint64_t fnv1a(std::string_view data) noexcept
+            {
+                std::uint64_t h = 0xcbf29ce484222325ull;
+                for (const char c : data)
+                {
+                    h ^= static_cast<unsigned char>(c);
+                    h *= 0x100000001b3ull;
+                }
+                return h;
+            }
+        } // namespace
+
+        std::optional<Checkpoint::FileIdentity> Checkpoint::identify(const std::string &path)
+        {
+#if defined(_WIN32)
+            struct _stat64 st{};
+            if (_stat64(path.c_str(), &st) != 0)
+                return std::nullopt;
+#else
+            struct stat st{};
+            if (::stat(path.c_str(), &st) != 0)
+                return std::nullopt;
+#endif
+            return FileIdentity{static_cast<std::uint64_t>(st.st_dev), static_cast<std::uint64_t>(st.st_ino),
+                                static_cast<std::uint64_t>(st.st_size)};
+        }
+
+        std::uint64_t Checkpoint::fingerprintAt(std::string_view data, std::uint64_t offset) noexcept
+        {
+            const std::size_t end = static_cast<std::size_t>(std::min<std::uint64_t>(offset, data.size()));
+            const std::size_t begin = end > kFingerprintBytes ? end - kFingerprintBytes : 0;
+            return fnv1a(data.substr(begin, end - begin));
+        }
+
+        std::optional<std::uint64_t> Checkpoint::fingerprintFile(const std::string &path, std::uint64_t offset)
+        {
+            const std::uint64_t begin = offset > kFingerprintBytes ? offset - kFingerprintBytes : 0;
+            std::string bytes(static_cast<std::size_t>(offset - begin), '\0');
+            std::ifstream f(path, std::ios::binary);
+            if (!f.seekg(static_cast<std::streamoff>(begin)) ||
+                !f.read(bytes.data(), static_cast<std::streamsize>(bytes.size())))
+                return std::nullopt;
+            return fnv1a(bytes);
+        }
+
+        bool Checkpoint::save(const std::string &path) const
+        {
+            core::StateWriter out;
+            out.putString(kMagic);
+            out.put(kVersion);
+            out.put(kByteOrderMark);
+            out.putString(inputPath);
+            out.put(file.device);
+            out.put(file.inode);
+            out.put(file.size);
+            out.put(offset);
+            out.put(fingerprint);
+            out.putTime(lastTimestamp);
+            out.putString(layout);
+            out.put(fnv1a(state));
+            out.putString(state);
+
+            const std::string tmp = path + ".tmp";
+            {
+                std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+                if (!f.write(out.bytes().data(), static_cast<std::streamsize>(out.bytes().size())) || !f.flush())
+                {
+                    Utils::getLogger().error("Cannot write checkpoint: " + tmp);
+                    return false;
+                }
+            }
+#if defined(_WIN32)
+            std::remove(path.c_str()); // rename() does not replace on Windows
+#endif
+            if (std::rename(tmp.c_str(), path.c_str()) != 0)
+            {
+                Utils::getLogger().error("Cannot replace checkpoint: " + path);
+                std::remove(tmp.c_str());
+                return false;
+            }
+            return true;
+        }
+
+        std::optional<Checkpoint> Checkpoint::load(const std::string &path)
+        {
+            std::ifstream f(path, std::ios::binary);
+            if (!f.is_open())
+                return std::nullopt;
+            const std::string bytes((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+
+            try
+            {
+                core::StateReader in(bytes);
+                if (in.getStringView() != kMagic || in.get<std::uint32_t>() != kVersion ||
+                    in.get<std::uint32_t>() != kByteOrderMark)
+                {
+                    Utils::getLogger().warn("Ignoring checkpoint from another version: " + path);
+                    return std::nullopt;
+                }
+
+                Checkpoint c;
+                c.inputPath = in.getString();
+                c.file.device = in.get<std::uint64_t>();
+                c.file.inode = in.get<std::uint64_t>();
+                c.file.size = in.get<std::uint64_t>();
+                c.offset = in.get<std::uint64_t>();
+                c.fingerprint = in.get<std::uint64_t>();
+                c.lastTimestamp = in.getTime();
+                c.layout = in.getString();
+                const auto checksum = in.get<std::uint64_t>();
+                c.state = in.getString();
+                if (!in.atEnd() || fnv1a(c.state) != checksum)
+                    throw std::runtime_error("checksum mismatch");
+                return c;
+            }
+            catch (const std::exception &ex)
+            {
+                Utils::getLogger().warn("Ignoring damaged checkpoint " + path + " (" + ex.what() + ")");
+                return std::nullopt;
+            }
+        }
+
+        std::string Checkpoint::mismatch(const FileIdentity &current, std::string_view data,
+                                         const std::string &currentLayout) const
+        {
+            if (current.device != file.device || current.inode != file.inode)
+                return "input is a different file";
+            if (current.size < offset || data.size() < offset)
+                return "input was truncated";
+            if (fingerprintAt(data, offset) != fingerprint)
+                return "input was rewritten";
+            if (currentLayout != layout)
+                return "detector selection changed (was " + layout + ")";
+            return {};
+        }
+
+    } // namespace Input
+} // namespace LogTool
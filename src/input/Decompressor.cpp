@@ -0,0 +1,695 @@
+#include "input/Decompressor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(LOGTOOL_WITH_ZSTD)
+#include <zstd.h>
+#endif
+
+namespace LogTool
+{
+    namespace Input
+    {
+        namespace
+        {
+            // -------------------------
+            // CRC-32 (gzip trailer), slicing by 8 bytes
+            // -------------------------
+            using CrcTables = std::array<std::array<std::uint32_t, 256>, 8>;
+
+            const CrcTables &crcTables()
+            {
+                static const CrcTables tables = []()
+                {
+                    CrcTables t{};
+                    for (std::uint32_t i = 0; i < 256; ++i)
+                    {
+                        std::uint32_t c = i;
+                        for (int k = 0; k < 8; ++k)
+                            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                        t[0][i] = c;
+                    }
+                    for (std::size_t s = 1; s < 8; ++s)
+                    {
+                        for (std::size_t i = 0; i < 256; ++i)
+                            t[s][i] = (t[s - 1][i] >> 8) ^ t[0][t[s - 1][i] & 0xFF];
+                    }
+                    return t;
+                }();
+                return tables;
+            }
+
+            std::uint32_t load32le(const unsigned char *p) noexcept
+            {
+                return static_cast<std::uint32_t>(p[0]) | (static_cast<std::uint32_t>(p[1]) << 8) |
+                       (static_cast<std::uint32_t>(p[2]) << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+            }
+
+            std::uint32_t crc32(std::uint32_t crc, std::string_view data) noexcept
+            {
+                const auto &t = crcTables();
+                const auto *p = reinterpret_cast<const unsigned char *>(data.data());
+                std::size_t n = data.size();
+                crc = ~crc;
+                for (; n >= 8; p += 8, n -= 8)
+                {
+                    const std::uint32_t a = crc ^ load32le(p);
+                    const std::uint32_t b = load32le(p + 4);
+                    crc = t[7][a & 0xFF] ^ t[6][(a >> 8) & 0xFF] ^ t[5][(a >> 16) & 0xFF] ^ t[4][a >> 24] ^
+                          t[3][b & 0xFF] ^ t[2][(b >> 8) & 0xFF] ^ t[1][(b >> 16) & 0xFF] ^ t[0][b >> 24];
+                }
+                for (; n > 0; --n)
+                    crc = t[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+                return ~crc;
+            }
+
+            [[noreturn]] void fail(const char *what)
+            {
+                throw std::runtime_error(std::string("gzip: ") + what);
+            }
+
+            // -------------------------
+            // Bit input (LSB first, as deflate packs it)
+            // -------------------------
+            class BitReader
+            {
+            public:
+                void reset(const unsigned char *begin, const unsigned char *end) noexcept
+                {
+                    m_in    = begin;
+                    m_end   = end;
+                    m_buf   = 0;
+                    m_count = 0;
+                }
+
+                /// Top up the bit buffer to at least 57 bits (fewer at the end of the input).
+                void refill() noexcept
+                {
+                    while (m_count <= 56 && m_in < m_end)
+                    {
+                        m_buf |= static_cast<std::uint64_t>(*m_in++) << m_count;
+                        m_count += 8;
+                    }
+                }
+
+                /// Next 'n' bits without consuming them; missing input reads as zeros.
+                std::uint32_t peek(unsigned n) const noexcept
+                {
+                    return static_cast<std::uint32_t>(m_buf & ((std::uint64_t{1} << n) - 1));
+                }
+
+                void drop(unsigned n)
+                {
+                    if (n > m_count)
+                        fail("unexpected end of data");
+                    m_buf >>= n;
+                    m_count -= n;
+                }
+
+                std::uint32_t bits(unsigned n)
+                {
+                    if (m_count < n)
+                        refill();
+                    const std::uint32_t v = peek(n);
+                    drop(n);
+                    return v;
+                }
+
+                unsigned available() const noexcept { return m_count; }
+
+                void alignToByte() { drop(m_count % 8); }
+
+                /// Copy 'n' whole bytes (after alignToByte()).
+                void readBytes(char *out, std::size_t n)
+                {
+                    for (; n > 0 && m_count >= 8; --n)
+                        *out++ = static_cast<char>(bits(8));
+                    if (n > static_cast<std::size_t>(m_end - m_in))
+                        fail("unexpected end of data");
+                    std::memcpy(out, m_in, n);
+                    m_in += n;
+                }
+
+                /// First byte not consumed yet (after alignToByte()).
+                const unsigned char *position() const noexcept { return m_in - m_count / 8; }
+
+            private:
+                const unsigned char *m_in  = nullptr;
+                const unsigned char *m_end = nullptr;
+                std::uint64_t        m_buf = 0;
+                unsigned             m_count = 0;
+            };
+
+            // -------------------------
+            // Canonical Huffman code
+            // -------------------------
+            struct Huffman
+            {
+                static constexpr unsigned kMaxBits  = 15;
+                static constexpr unsigned kFastBits = 10;
+
+                std::array<std::uint16_t, kMaxBits + 1> count{};     // codes per length
+                std::array<std::uint16_t, 288>          symbol{};    // symbols by code
+                std::array<std::uint16_t, 1u << kFastBits> fast{};   // (symbol << 4) | length, 0 = longer code
+
+                void build(const std::uint8_t *lengths, unsigned n)
+                {
+                    count.fill(0);
+                    for (unsigned i = 0; i < n; ++i)
+                        ++count[lengths[i]];
+                    count[0] = 0;
+
+                    // Over-subscribed codes are invalid; incomplete ones are allowed
+                    // (a single distance code) and fail only if an unused code shows up.
+                    int left = 1;
+                    for (unsigned len = 1; len <= kMaxBits; ++len)
+                    {
+                        left = (left << 1) - count[len];
+                        if (left < 0)
+                            fail("invalid Huffman code");
+                    }
+
+                    std::array<std::uint16_t, kMaxBits + 2> offset{};
+                    for (unsigned len = 1; len <= kMaxBits; ++len)
+                        offset[len + 1] = static_cast<std::uint16_t>(offset[len] + count[len]);
+                    for (unsigned s = 0; s < n; ++s)
+                    {
+                        if (lengths[s] != 0)
+                            symbol[offset[lengths[s]]++] = static_cast<std::uint16_t>(s);
+                    }
+
+                    // Short codes also go into a direct lookup table indexed by the
+                    // next kFastBits input bits (codes arrive bit-reversed).
+                    fast.fill(0);
+                    unsigned code = 0, index = 0;
+                    for (unsigned len = 1; len <= kMaxBits; ++len, code <<= 1)
+                    {
+                        for (unsigned k = 0; k < count[len]; ++k, ++code, ++index)
+                        {
+                            if (len > kFastBits)
+                                continue;
+                            unsigned rev = 0;
+                            for (unsigned b = 0; b < len; ++b)
+                                rev |= ((code >> b) & 1u) << (len - 1 - b);
+                            const auto entry = static_cast<std::uint16_t>((symbol[index] << 4) | len);
+                            for (unsigned r = rev; r < (1u << kFastBits); r += 1u << len)
+                                fast[r] = entry;
+                        }
+                    }
+                }
+
+                unsigned decode(BitReader &in) const
+                {
+                    if (in.available() < kMaxBits)
+                        in.refill();
+                    const std::uint16_t entry = fast[in.peek(kFastBits)];
+                    if (entry != 0)
+                    {
+                        in.drop(entry & 15u);
+                        return entry >> 4;
+                    }
+
+                    // Longer code: walk the canonical code one bit at a time.
+                    int code = 0, first = 0, index = 0;
+                    for (unsigned len = 1; len <= kMaxBits; ++len)
+                    {
+                        code |= static_cast<int>(in.bits(1));
+                        const int n = count[len];
+                        if (code - n < first)
+                            return symbol[static_cast<std::size_t>(index + (code - first))];
+                        index += n;
+                        first = (first + n) << 1;
+                        code <<= 1;
+                    }
+                    fail("invalid Huffman code");
+                }
+            };
+
+            constexpr std::array<std::uint16_t, 29> kLengthBase = {
+                3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+            constexpr std::array<std::uint8_t, 29> kLengthExtra = {
+                0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+            constexpr std::array<std::uint16_t, 30> kDistBase = {
+                1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+            constexpr std::array<std::uint8_t, 30> kDistExtra = {
+                0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+            /**
+             * gzip decoder over a complete in-memory input (a mapped file).
+             * Output accumulates after a 32 KiB history window and is passed to
+             * the sink every kChunk bytes; the window then slides to the front.
+             */
+            class GzipInflater
+            {
+            public:
+                GzipInflater(std::string_view input, const DecompressSink &sink)
+                    : m_input(reinterpret_cast<const unsigned char *>(input.data())),
+                      m_size(input.size()),
+                      m_sink(sink),
+                      m_out(kWindow + kChunk + kMaxMatch)
+                {
+                }
+
+                void run()
+                {
+                    const unsigned char *p   = m_input;
+                    const unsigned char *end = m_input + m_size;
+                    bool first = true;
+                    // Members follow each other ("cat a.gz b.gz"); anything else after
+                    // the last member (e.g. zero padding) is ignored, as gzip does.
+                    while (first || (end - p >= 2 && p[0] == 0x1F && p[1] == 0x8B))
+                    {
+                        first = false;
+                        p = skipHeader(p, end);
+                        m_bits.reset(p, end);
+                        m_pos = m_flushed = 0;
+                        m_crc = 0;
+                        m_length = 0;
+
+                        if (!inflateMember() || !flush())
+                            return; // sink stopped us
+
+                        char trailer[8];
+                        m_bits.alignToByte();
+                        m_bits.readBytes(trailer, sizeof(trailer));
+                        const auto *t = reinterpret_cast<const unsigned char *>(trailer);
+                        if (load32le(t) != m_crc)
+                            fail("CRC mismatch");
+                        if (load32le(t + 4) != static_cast<std::uint32_t>(m_length))
+                            fail("length mismatch");
+                        p = m_bits.position();
+                    }
+                }
+
+            private:
+                static constexpr std::size_t kWindow   = 32768;
+                static constexpr std::size_t kChunk    = 1u << 20;
+                static constexpr std::size_t kMaxMatch = 258;
+
+                static const unsigned char *skipHeader(const unsigned char *p, const unsigned char *end)
+                {
+                    if (end - p < 18)
+                        fail("unexpected end of data");
+                    if (p[0] != 0x1F || p[1] != 0x8B)
+                        fail("not gzip data");
+                    if (p[2] != 8)
+                        fail("unknown compression method");
+                    const unsigned flags = p[3];
+                    if (flags & 0xE0)
+                        fail("reserved header flags set");
+                    p += 10;
+
+                    auto need = [&](std::ptrdiff_t n)
+                    {
+                        if (end - p < n)
+                            fail("unexpected end of data");
+                    };
+                    auto skipString = [&]()
+                    {
+                        const void *nul = std::memchr(p, 0, static_cast<std::size_t>(end - p));
+                        if (nul == nullptr)
+                            fail("unexpected end of data");
+                        p = static_cast<const unsigned char *>(nul) + 1;
+                    };
+
+                    if (flags & 0x04) // FEXTRA
+                    {
+                        need(2);
+                        const std::ptrdiff_t len = p[0] | (p[1] << 8);
+                        need(2 + len);
+                        p += 2 + len;
+                    }
+                    if (flags & 0x08) // FNAME
+                        skipString();
+                    if (flags & 0x10) // FCOMMENT
+                        skipString();
+                    if (flags & 0x02) // FHCRC
+                    {
+                        need(2);
+                        p += 2;
+                    }
+                    return p;
+                }
+
+                /// Pass pending output on and slide the history window; false if the sink stops.
+                bool flush()
+                {
+                    if (m_pos > m_flushed)
+                    {
+                        const std::string_view piece(m_out.data() + m_flushed, m_pos - m_flushed);
+                        m_crc = crc32(m_crc, piece);
+                        m_length += piece.size();
+                        if (!m_sink(piece))
+                            return false;
+                    }
+                    if (m_pos > kWindow)
+                    {
+                        std::memmove(m_out.data(), m_out.data() + m_pos - kWindow, kWindow);
+                        m_pos = kWindow;
+                    }
+                    m_flushed = m_pos;
+                    return true;
+                }
+
+                bool inflateMember()
+                {
+                    bool last = false;
+                    while (!last)
+                    {
+                        last = m_bits.bits(1) != 0;
+                        switch (m_bits.bits(2))
+                        {
+                        case 0:
+                            if (!storedBlock())
+                                return false;
+                            break;
+                        case 1:
+                            if (!codesBlock(fixedTables().first, fixedTables().second))
+                                return false;
+                            break;
+                        case 2:
+                            readDynamicTables();
+                            if (!codesBlock(m_lit, m_dist))
+                                return false;
+                            break;
+                        default:
+                            fail("invalid block type");
+                        }
+                    }
+                    return true;
+                }
+
+                bool storedBlock()
+                {
+                    m_bits.alignToByte();
+                    std::size_t len = m_bits.bits(16);
+                    if (len != (~m_bits.bits(16) & 0xFFFFu))
+                        fail("invalid stored block length");
+                    while (len > 0)
+                    {
+                        if (m_pos >= kWindow + kChunk && !flush())
+                            return false;
+                        const std::size_t n = std::min(len, m_out.size() - m_pos);
+                        m_bits.readBytes(m_out.data() + m_pos, n);
+                        m_pos += n;
+                        len -= n;
+                    }
+                    return true;
+                }
+
+                static const std::pair<Huffman, Huffman> &fixedTables()
+                {
+                    static const std::pair<Huffman, Huffman> tables = []()
+                    {
+                        std::pair<Huffman, Huffman> t;
+                        std::array<std::uint8_t, 288> lengths{};
+                        std::fill(lengths.begin(), lengths.begin() + 144, 8);
+                        std::fill(lengths.begin() + 144, lengths.begin() + 256, 9);
+                        std::fill(lengths.begin() + 256, lengths.begin() + 280, 7);
+                        std::fill(lengths.begin() + 280, lengths.end(), 8);
+                        t.first.build(lengths.data(), 288);
+                        std::fill(lengths.begin(), lengths.begin() + 30, 5);
+                        t.second.build(lengths.data(), 30);
+                        return t;
+                    }();
+                    return tables;
+                }
+
+                void readDynamicTables()
+                {
+                    static constexpr std::array<std::uint8_t, 19> kOrder = {
+                        16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+                    const unsigned nlen  = m_bits.bits(5) + 257;
+                    const unsigned ndist = m_bits.bits(5) + 1;
+                    const unsigned ncode = m_bits.bits(4) + 4;
+                    if (nlen > 286 || ndist > 30)
+                        fail("invalid code counts");
+
+                    std::array<std::uint8_t, 286 + 30> lengths{};
+                    for (unsigned i = 0; i < ncode; ++i)
+                        lengths[kOrder[i]] = static_cast<std::uint8_t>(m_bits.bits(3));
+                    Huffman lencode;
+                    lencode.build(lengths.data(), 19);
+
+                    unsigned index = 0;
+                    while (index < nlen + ndist)
+                    {
+                        const unsigned sym = lencode.decode(m_bits);
+                        if (sym < 16)
+                        {
+                            lengths[index++] = static_cast<std::uint8_t>(sym);
+                            continue;
+                        }
+                        std::uint8_t len = 0;
+                        unsigned repeat = 0;
+                        if (sym == 16)
+                        {
+                            if (index == 0)
+                                fail("repeat with no previous length");
+                            len = lengths[index - 1];
+                            repeat = 3 + m_bits.bits(2);
+                        }
+                        else if (sym == 17)
+                        {
+                            repeat = 3 + m_bits.bits(3);
+                        }
+                        else
+                        {
+                            repeat = 11 + m_bits.bits(7);
+                        }
+                        if (index + repeat > nlen + ndist)
+                            fail("too many code lengths");
+                        std::fill(lengths.begin() + index, lengths.begin() + index + repeat, len);
+                        index += repeat;
+                    }
+                    if (lengths[256] == 0)
+                        fail("missing end-of-block code");
+
+                    m_lit.build(lengths.data(), nlen);
+                    m_dist.build(lengths.data() + nlen, ndist);
+                }
+
+                bool codesBlock(const Huffman &lit, const Huffman &dist)
+                {
+                    char *out = m_out.data();
+                    for (;;)
+                    {
+                        if (m_pos >= kWindow + kChunk && !flush())
+                            return false;
+
+                        unsigned sym = lit.decode(m_bits);
+                        if (sym < 256)
+                        {
+                            out[m_pos++] = static_cast<char>(sym);
+                            continue;
+                        }
+                        if (sym == 256)
+                            return true;
+
+                        sym -= 257;
+                        if (sym >= kLengthBase.size())
+                            fail("invalid length code");
+                        const std::size_t len = kLengthBase[sym] + m_bits.bits(kLengthExtra[sym]);
+
+                        const unsigned dsym = dist.decode(m_bits);
+                        if (dsym >= kDistBase.size())
+                            fail("invalid distance code");
+                        const std::size_t distance = kDistBase[dsym] + m_bits.bits(kDistExtra[dsym]);
+                        if (distance > m_pos)
+                            fail("distance too far back");
+
+                        char *dst = out + m_pos;
+                        const char *src = dst - distance;
+                        if (distance >= len)
+                        {
+                            std::memcpy(dst, src, len);
+                        }
+                        else
+                        {
+                            for (std::size_t i = 0; i < len; ++i) // overlapping: repeats a pattern
+                                dst[i] = src[i];
+                        }
+                        m_pos += len;
+                    }
+                }
+
+                const unsigned char   *m_input;
+                std::size_t            m_size;
+                const DecompressSink  &m_sink;
+                BitReader              m_bits;
+                Huffman                m_lit;
+                Huffman                m_dist;
+                std::vector<char>      m_out;          // history window + pending output
+                std::size_t            m_pos = 0;      // end of output in m_out
+                std::size_t            m_flushed = 0;  // end of output already passed on
+                std::uint32_t          m_crc = 0;
+                std::uint64_t          m_length = 0;
+            };
+
+#if defined(LOGTOOL_WITH_ZSTD)
+            void decompressZstd(std::string_view input, const DecompressSink &sink)
+            {
+                std::unique_ptr<ZSTD_DStream, decltype(&ZSTD_freeDStream)> stream(ZSTD_createDStream(),
+                                                                                  &ZSTD_freeDStream);
+                if (!stream)
+                    throw std::runtime_error("zstd: out of memory");
+                ZSTD_initDStream(stream.get());
+
+                std::string out(ZSTD_DStreamOutSize(), '\0');
+                ZSTD_inBuffer in{input.data(), input.size(), 0};
+                std::size_t ret = 0;
+                bool outputFull = false;
+                while (in.pos < in.size || outputFull)
+                {
+                    ZSTD_outBuffer buffer{out.data(), out.size(), 0};
+                    ret = ZSTD_decompressStream(stream.get(), &buffer, &in);
+                    if (ZSTD_isError(ret))
+                        throw std::runtime_error(std::string("zstd: ") + ZSTD_getErrorName(ret));
+                    outputFull = buffer.pos == buffer.size;
+                    if (buffer.pos > 0 && !sink(std::string_view(out.data(), buffer.pos)))
+                        return;
+                }
+                if (ret != 0)
+                    throw std::runtime_error("zstd: unexpected end of data");
+            }
+#endif
+        } // namespace
+
+        Compression detectCompression(std::string_view head) noexcept
+        {
+            const auto byte = [&](std::size_t i) { return static_cast<unsigned char>(head[i]); };
+            if (head.size() >= 3 && byte(0) == 0x1F && byte(1) == 0x8B && byte(2) == 8)
+                return Compression::Gzip;
+            if (head.size() >= 4 && byte(0) == 0x28 && byte(1) == 0xB5 && byte(2) == 0x2F && byte(3) == 0xFD)
+                return Compression::Zstd;
+            return Compression::None;
+        }
+
+        const char *compressionName(Compression kind) noexcept
+        {
+            switch (kind)
+            {
+            case Compression::Gzip:
+                return "gzip";
+            case Compression::Zstd:
+                return "zstd";
+            default:
+                return "none";
+            }
+        }
+
+        bool compressionSupported(Compression kind) noexcept
+        {
+#if defined(LOGTOOL_WITH_ZSTD)
+            (void)kind;
+            return true;
+#else
+            return kind != Compression::Zstd;
+#endif
+        }
+
+        const char *compressionHint(Compression kind) noexcept
+        {
+            if (compressionSupported(kind))
+                return "";
+            return "rebuild with -DLOGTOOL_WITH_ZSTD=ON and libzstd installed, "
+                   "or decompress it with zstd -d first";
+        }
+
+        void decompress(Compression kind, std::string_view input, const DecompressSink &sink)
+        {
+            switch (kind)
+            {
+            case Compression::None:
+                sink(input);
+                return;
+            case Compression::Gzip:
+                GzipInflater(input, sink).run();
+                return;
+            case Compression::Zstd:
+#if defined(LOGTOOL_WITH_ZSTD)
+                decompressZstd(input, sink);
+                return;
+#else
+                throw std::runtime_error(std::string("zstd input is not supported by this build; ") +
+                                         compressionHint(kind));
+#endif
+            }
+        }
+
+        // -------------------------
+        // DecompressStream
+        // -------------------------
+        DecompressStream::DecompressStream(Compression kind,
+                                           std::string_view input,
+                                           std::size_t chunkBytes,
+                                           std::size_t queueDepth)
+            : m_kind(kind),
+              m_input(input),
+              m_chunkBytes(std::max<std::size_t>(chunkBytes, 4096)),
+              m_queue(std::max<std::size_t>(queueDepth, 1))
+        {
+            m_thread = std::thread([this]() { produce(); });
+        }
+
+        DecompressStream::~DecompressStream()
+        {
+            m_queue.close();
+            if (m_thread.joinable())
+                m_thread.join();
+        }
+
+        bool DecompressStream::next(std::string &chunk)
+        {
+            if (!m_queue.pop(chunk))
+                return false;
+            m_bytesOut += chunk.size();
+            return true;
+        }
+
+        void DecompressStream::produce()
+        {
+            std::string pending;
+            pending.reserve(m_chunkBytes * 2);
+            try
+            {
+                decompress(m_kind, m_input, [&](std::string_view piece)
+                           {
+                    pending.append(piece);
+                    if (pending.size() < m_chunkBytes)
+                        return true;
+
+                    // Cut after the last complete line; the rest starts the next chunk.
+                    const auto nl = pending.rfind('\n');
+                    if (nl == std::string::npos)
+                        return true; // one very long line: keep collecting
+                    std::string rest(pending, nl + 1);
+                    pending.resize(nl + 1);
+                    if (!m_queue.push(std::move(pending)))
+                        return false; // reader is gone
+                    pending = std::move(rest);
+                    pending.reserve(m_chunkBytes * 2);
+                    return true; });
+            }
+            catch (const std::exception &ex)
+            {
+                m_error = ex.what();
+            }
+            if (!pending.empty())
+                m_queue.push(std::move(pending));
+            m_queue.close();
+        }
+
+    } // namespace Input
+} // namespace LogTool
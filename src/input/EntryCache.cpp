@@ -0,0 +1,445 @@
+#include "input/EntryCache.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+#include "core/StateCodec.hpp"
+#include "input/Checkpoint.hpp"
+#include "utils/Logger.hpp"
+
+namespace LogTool
+{
+    namespace Input
+    {
+        namespace
+        {
+            constexpr std::string_view kMagic = "LOGTOOL-LCACHE";
+            constexpr std::uint32_t    kVersion = 2;
+            constexpr std::uint32_t    kByteOrderMark = 0x01020304u; // native order check
+            constexpr std::uint64_t    kFooterMagic = 0x45484341434c474cull; // "LGLCACHE"
+            constexpr std::size_t      kFooterBytes = 4 * sizeof(std::uint64_t);
+            constexpr std::size_t      kStripeHeaderBytes = 4 * sizeof(std::uint32_t);
+
+            using Clock = core::LogEntry::Clock;
+
+            std::size_t roundUp8(std::size_t n) noexcept { return (n + 7) & ~std::size_t{7}; }
+
+            // Bytes of a stripe with n entries, m malformed lines, k new sources and an h byte heap.
+            std::size_t stripeBytes(std::size_t n, std::size_t m, std::size_t k, std::size_t h) noexcept
+            {
+                return roundUp8(kStripeHeaderBytes + n * (8 + 4 + 4 + 1) + m * (4 + 4) + k * 4) + roundUp8(h);
+            }
+
+            template <typename T>
+            void appendRaw(std::string &out, const T &value)
+            {
+                out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+            }
+
+            template <typename T>
+            void appendColumn(std::string &out, const std::vector<T> &column)
+            {
+                out.append(reinterpret_cast<const char *>(column.data()), column.size() * sizeof(T));
+            }
+
+            void padTo8(std::string &out) { out.append(roundUp8(out.size()) - out.size(), '\0'); }
+
+            // Checksum of a stripe (a multiple of 8 bytes): FNV-1a over 64-bit
+            // words, with a shift to carry changes in the high bits down.
+            std::uint64_t stripeChecksum(std::string_view stripe) noexcept
+            {
+                std::uint64_t h = 0xcbf29ce484222325ull;
+                for (std::size_t i = 0; i + sizeof(std::uint64_t) <= stripe.size(); i += sizeof(std::uint64_t))
+                {
+                    std::uint64_t word;
+                    std::memcpy(&word, stripe.data() + i, sizeof(word));
+                    h = (h ^ word) * 0x100000001b3ull;
+                    h ^= h >> 32;
+                }
+                return h;
+            }
+
+            // Unaligned-safe read of a column value.
+            template <typename T>
+            T load(const char *p, std::size_t index = 0) noexcept
+            {
+                T value;
+                std::memcpy(&value, p + index * sizeof(T), sizeof(T));
+                return value;
+            }
+        } // namespace
+
+        std::optional<EntryCache::Source> EntryCache::describe(const std::string &logPath)
+        {
+            std::error_code ec;
+            const auto size = std::filesystem::file_size(logPath, ec);
+            if (ec)
+                return std::nullopt;
+            const auto mtime = std::filesystem::last_write_time(logPath, ec);
+            if (ec)
+                return std::nullopt;
+
+            const auto head = Checkpoint::fingerprintFile(logPath, std::min<std::uint64_t>(size, Checkpoint::kFingerprintBytes));
+            const auto tail = Checkpoint::fingerprintFile(logPath, size);
+            if (!head || !tail)
+                return std::nullopt;
+            return Source{static_cast<std::uint64_t>(size), static_cast<std::int64_t>(mtime.time_since_epoch().count()),
+                          *head, *tail};
+        }
+
+        // -------------------------
+        // Writer
+        // -------------------------
+        EntryCache::Writer::Writer(std::string path, const Source &source)
+            : m_path(std::move(path)),
+              m_tmpPath(m_path + ".tmp"),
+              m_out(m_tmpPath, std::ios::binary | std::ios::trunc)
+        {
+            core::StateWriter header;
+            header.putString(kMagic);
+            header.put(kVersion);
+            header.put(kByteOrderMark);
+            header.put<std::int64_t>(Clock::period::num);
+            header.put<std::int64_t>(Clock::period::den);
+            header.put(source.size);
+            header.put(source.mtime);
+            header.put(source.headPrint);
+            header.put(source.tailPrint);
+
+            // [u64 header size][header][padding], so the stripes start 8-aligned.
+            std::string out;
+            appendRaw<std::uint64_t>(out, roundUp8(sizeof(std::uint64_t) + header.bytes().size()));
+            out += header.bytes();
+            padTo8(out);
+            if (!m_out.write(out.data(), static_cast<std::streamsize>(out.size())))
+            {
+                Utils::getLogger().error("Cannot write entry cache: " + m_tmpPath);
+                m_failed = true;
+            }
+        }
+
+        EntryCache::Writer::~Writer()
+        {
+            if (m_out.is_open())
+            {
+                m_out.close();
+                std::remove(m_tmpPath.c_str());
+            }
+        }
+
+        void EntryCache::Writer::add(const LogParser::ParsedBatch &batch)
+        {
+            if (m_failed)
+                return;
+            if (m_times.size() >= kStripeEntries || m_heap.size() >= kStripeHeapBytes)
+                flushStripe();
+
+            const std::size_t base = m_times.size();
+            for (const auto &bad : batch.malformed)
+            {
+                m_badPositions.push_back(static_cast<std::uint32_t>(base + bad.position));
+                m_badErrors.push_back(bad.error);
+            }
+
+            const core::EntryBatch &entries = batch.entries;
+            for (const auto &tp : entries.timestamps())
+                m_times.push_back(static_cast<std::int64_t>(tp.time_since_epoch().count()));
+            for (const auto level : entries.levels())
+                m_levels.push_back(static_cast<std::uint8_t>(level));
+            for (const auto id : entries.sourceIds())
+            {
+                if (id == core::kNoSource)
+                {
+                    m_sources.push_back(0);
+                    continue;
+                }
+                const auto [it, added] = m_dictionary.try_emplace(id, static_cast<std::uint32_t>(m_dictionary.size() + 1));
+                if (added)
+                    m_newSources.push_back(core::SourceTable::global().nameOr(id, ""));
+                m_sources.push_back(it->second);
+            }
+            for (const auto &entry : entries.entries())
+            {
+                m_heap.append(entry.message());
+                m_messageEnds.push_back(static_cast<std::uint32_t>(m_heap.size()));
+            }
+        }
+
+        void EntryCache::Writer::flushStripe()
+        {
+            if (m_times.empty() && m_badPositions.empty())
+                return;
+
+            // Error texts and new source names follow the messages in the heap.
+            std::vector<std::uint32_t> badEnds;
+            for (const auto &error : m_badErrors)
+            {
+                m_heap += error;
+                badEnds.push_back(static_cast<std::uint32_t>(m_heap.size()));
+            }
+            std::vector<std::uint32_t> nameEnds;
+            for (const auto &name : m_newSources)
+            {
+                m_heap += name;
+                nameEnds.push_back(static_cast<std::uint32_t>(m_heap.size()));
+            }
+
+            std::string out;
+            out.reserve(stripeBytes(m_times.size(), m_badPositions.size(), m_newSources.size(), m_heap.size()));
+            appendRaw(out, static_cast<std::uint32_t>(m_times.size()));
+            appendRaw(out, static_cast<std::uint32_t>(m_badPositions.size()));
+            appendRaw(out, static_cast<std::uint32_t>(m_newSources.size()));
+            appendRaw(out, static_cast<std::uint32_t>(m_heap.size()));
+            appendColumn(out, m_times);
+            appendColumn(out, m_messageEnds);
+            appendColumn(out, m_sources);
+            appendColumn(out, m_badPositions);
+            appendColumn(out, badEnds);
+            appendColumn(out, nameEnds);
+            appendColumn(out, m_levels);
+            padTo8(out);
+            out += m_heap;
+            padTo8(out);
+
+            if (!m_out.write(out.data(), static_cast<std::streamsize>(out.size())))
+            {
+                Utils::getLogger().error("Cannot write entry cache: " + m_tmpPath);
+                m_failed = true;
+            }
+            m_checksums.push_back(stripeChecksum(out));
+
+            ++m_stripes;
+            m_entries += m_times.size();
+            m_malformed += m_badPositions.size();
+            m_times.clear();
+            m_messageEnds.clear();
+            m_sources.clear();
+            m_levels.clear();
+            m_badPositions.clear();
+            m_badErrors.clear();
+            m_newSources.clear();
+            m_heap.clear();
+        }
+
+        bool EntryCache::Writer::finish()
+        {
+            flushStripe();
+
+            // [u64 checksum per stripe][footer]
+            std::string footer;
+            appendColumn(footer, m_checksums);
+            appendRaw(footer, m_stripes);
+            appendRaw(footer, m_entries);
+            appendRaw(footer, m_malformed);
+            appendRaw(footer, kFooterMagic);
+            if (!m_failed && (!m_out.write(footer.data(), static_cast<std::streamsize>(footer.size())) || !m_out.flush()))
+            {
+                Utils::getLogger().error("Cannot write entry cache: " + m_tmpPath);
+                m_failed = true;
+            }
+            m_out.close();
+
+            if (!m_failed)
+            {
+#if defined(_WIN32)
+                std::remove(m_path.c_str()); // rename() does not replace on Windows
+#endif
+                if (std::rename(m_tmpPath.c_str(), m_path.c_str()) == 0)
+                    return true;
+                Utils::getLogger().error("Cannot replace entry cache: " + m_path);
+            }
+            std::remove(m_tmpPath.c_str());
+            return false;
+        }
+
+        // -------------------------
+        // Replay
+        // -------------------------
+        std::optional<EntryCache> EntryCache::open(const std::string &path, const Source &source, std::string &whyNot)
+        {
+            whyNot.clear();
+            std::error_code ec;
+            if (!std::filesystem::is_regular_file(path, ec))
+                return std::nullopt;
+
+            auto file = std::make_shared<FileReader>();
+            if (!file->open(path, FileReader::Mode::Mapped) || file->mode() != FileReader::Mode::Mapped)
+            {
+                whyNot = "cannot map it";
+                return std::nullopt;
+            }
+
+            const std::string_view data = file->mappedData();
+            EntryCache cache;
+            try
+            {
+                if (data.size() < sizeof(std::uint64_t) + kFooterBytes)
+                    throw std::runtime_error("truncated");
+                const std::size_t headerBytes = static_cast<std::size_t>(load<std::uint64_t>(data.data()));
+                if (headerBytes < sizeof(std::uint64_t) || headerBytes > data.size() - kFooterBytes)
+                    throw std::runtime_error("bad header size");
+
+                core::StateReader in(data.substr(sizeof(std::uint64_t), headerBytes - sizeof(std::uint64_t)));
+                if (in.getStringView() != kMagic || in.get<std::uint32_t>() != kVersion ||
+                    in.get<std::uint32_t>() != kByteOrderMark || in.get<std::int64_t>() != Clock::period::num ||
+                    in.get<std::int64_t>() != Clock::period::den)
+                {
+                    whyNot = "written by another version";
+                    return std::nullopt;
+                }
+                Source cached;
+                cached.size = in.get<std::uint64_t>();
+                cached.mtime = in.get<std::int64_t>();
+                cached.headPrint = in.get<std::uint64_t>();
+                cached.tailPrint = in.get<std::uint64_t>();
+                if (!(cached == source))
+                {
+                    whyNot = "the log has changed since it was written";
+                    return std::nullopt;
+                }
+
+                const char *footer = data.data() + data.size() - kFooterBytes;
+                if (load<std::uint64_t>(footer, 3) != kFooterMagic)
+                    throw std::runtime_error("no footer");
+                cache.m_stripes = load<std::uint64_t>(footer, 0);
+                cache.m_entries = load<std::uint64_t>(footer, 1);
+                cache.m_malformed = load<std::uint64_t>(footer, 2);
+                if (cache.m_stripes > (data.size() - kFooterBytes - headerBytes) / sizeof(std::uint64_t))
+                    throw std::runtime_error("bad stripe count");
+                const char *checksums = footer - cache.m_stripes * sizeof(std::uint64_t);
+                cache.m_stripesBegin = headerBytes;
+                cache.m_stripesEnd = static_cast<std::size_t>(checksums - data.data());
+
+                // Walk and checksum the stripes once, so run() never steps outside
+                // the file nor replays damaged columns.
+                std::size_t pos = cache.m_stripesBegin;
+                std::uint64_t entries = 0, malformed = 0;
+                for (std::uint64_t s = 0; s < cache.m_stripes; ++s)
+                {
+                    if (cache.m_stripesEnd - pos < kStripeHeaderBytes)
+                        throw std::runtime_error("stripe past the end");
+                    const char *p = data.data() + pos;
+                    const std::size_t bytes = stripeBytes(load<std::uint32_t>(p, 0), load<std::uint32_t>(p, 1),
+                                                          load<std::uint32_t>(p, 2), load<std::uint32_t>(p, 3));
+                    if (bytes > cache.m_stripesEnd - pos)
+                        throw std::runtime_error("stripe past the end");
+                    if (stripeChecksum(data.substr(pos, bytes)) != load<std::uint64_t>(checksums, s))
+                        throw std::runtime_error("stripe " + std::to_string(s) + " fails its checksum");
+                    entries += load<std::uint32_t>(p, 0);
+                    malformed += load<std::uint32_t>(p, 1);
+                    pos += bytes;
+                }
+                if (pos != cache.m_stripesEnd || entries != cache.m_entries || malformed != cache.m_malformed)
+                    throw std::runtime_error("footer does not match the stripes");
+            }
+            catch (const std::exception &ex)
+            {
+                whyNot = std::string("damaged: ") + ex.what();
+                return std::nullopt;
+            }
+
+            cache.m_text = std::make_shared<core::TextArena>(std::shared_ptr<const void>(file));
+            cache.m_file = std::move(file);
+            return cache;
+        }
+
+        void EntryCache::run(const Consumer &consume) const
+        {
+            const std::string_view data = m_file->mappedData();
+            auto &sourceTable = core::SourceTable::global();
+            std::vector<core::SourceId> sources{core::kNoSource}; // dictionary index -> ID
+
+            LogParser::ParsedBatch batch;
+            batch.entries.reserve(core::EntryBatch::kDefaultCapacity);
+            auto passOnIfFull = [&]()
+            {
+                if (batch.lineCount() >= core::EntryBatch::kDefaultCapacity)
+                {
+                    consume(batch);
+                    batch.clear();
+                }
+            };
+
+            std::size_t pos = m_stripesBegin;
+            for (std::uint64_t s = 0; s < m_stripes; ++s)
+            {
+                const char *p = data.data() + pos;
+                const std::size_t n = load<std::uint32_t>(p, 0);
+                const std::size_t m = load<std::uint32_t>(p, 1);
+                const std::size_t k = load<std::uint32_t>(p, 2);
+                const std::size_t h = load<std::uint32_t>(p, 3);
+
+                const char *times = p + kStripeHeaderBytes;
+                const char *messageEnds = times + n * 8;
+                const char *sourceIdx = messageEnds + n * 4;
+                const char *badPositions = sourceIdx + n * 4;
+                const char *badEnds = badPositions + m * 4;
+                const char *nameEnds = badEnds + m * 4;
+                const char *levels = nameEnds + k * 4;
+                const char *heap = p + roundUp8(kStripeHeaderBytes + n * (8 + 4 + 4 + 1) + m * (4 + 4) + k * 4);
+
+                auto text = [&](std::uint32_t begin, std::uint32_t end)
+                {
+                    if (begin > end || end > h)
+                        throw std::runtime_error("entry cache: text out of range");
+                    return std::string_view(heap + begin, end - begin);
+                };
+
+                // New dictionary names follow the error texts, which follow the messages.
+                const std::uint32_t textEnd = n > 0 ? load<std::uint32_t>(messageEnds, n - 1) : 0;
+                std::uint32_t start = m > 0 ? load<std::uint32_t>(badEnds, m - 1) : textEnd;
+                for (std::size_t j = 0; j < k; ++j)
+                {
+                    const std::uint32_t end = load<std::uint32_t>(nameEnds, j);
+                    sources.push_back(sourceTable.intern(text(start, end)));
+                    start = end;
+                }
+
+                std::size_t bad = 0;
+                std::uint32_t errorBegin = textEnd;
+                auto passMalformedAt = [&](std::size_t i)
+                {
+                    for (; bad < m && load<std::uint32_t>(badPositions, bad) == i; ++bad)
+                    {
+                        const std::uint32_t end = load<std::uint32_t>(badEnds, bad);
+                        batch.malformed.push_back({batch.entries.size(), std::string(text(errorBegin, end))});
+                        errorBegin = end;
+                        passOnIfFull();
+                    }
+                };
+
+                std::uint32_t messageBegin = 0;
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    passMalformedAt(i);
+
+                    const std::uint32_t source = load<std::uint32_t>(sourceIdx, i);
+                    if (source >= sources.size())
+                        throw std::runtime_error("entry cache: unknown source");
+                    const auto level = std::min<std::uint8_t>(load<std::uint8_t>(levels, i),
+                                                              static_cast<std::uint8_t>(core::LogLevel::Unknown));
+                    const std::uint32_t messageEnd = load<std::uint32_t>(messageEnds, i);
+                    batch.entries.push_back(core::LogEntry(Clock::time_point(Clock::duration(load<std::int64_t>(times, i))),
+                                                           static_cast<core::LogLevel>(level),
+                                                           sources[source],
+                                                           text(messageBegin, messageEnd),
+                                                           m_text));
+                    messageBegin = messageEnd;
+                    passOnIfFull();
+                }
+                passMalformedAt(n);
+                if (bad != m)
+                    throw std::runtime_error("entry cache: malformed lines out of order");
+
+                pos += stripeBytes(n, m, k, h);
+            }
+
+            if (batch.lineCount() > 0)
+                consume(batch);
+        }
+
+    } // namespace Input
+} // namespace LogTool
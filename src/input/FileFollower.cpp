@@ -0,0 +1,289 @@
+#include "input/FileFollower.hpp"
+
+#include <thread>
+#include <utility>
+
+#include "utils/Logger.hpp"
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+
+namespace LogTool
+{
+    namespace Input
+    {
+        namespace
+        {
+            struct FileId
+            {
+                std::uint64_t device = 0;
+                std::uint64_t inode  = 0;
+                std::uint64_t size   = 0;
+            };
+
+#if defined(_WIN32)
+            bool statPath(const std::string &path, FileId &id)
+            {
+                struct _stat64 st{};
+                if (_stat64(path.c_str(), &st) != 0)
+                    return false;
+                id = FileId{0, 0, static_cast<std::uint64_t>(st.st_size)};
+                return true;
+            }
+
+            bool statFd(int fd, FileId &id)
+            {
+                struct _stat64 st{};
+                if (_fstat64(fd, &st) != 0)
+                    return false;
+                id = FileId{0, 0, static_cast<std::uint64_t>(st.st_size)};
+                return true;
+            }
+
+            long long readAt(int fd, char *buf, std::size_t n, std::uint64_t offset)
+            {
+                if (_lseeki64(fd, static_cast<long long>(offset), SEEK_SET) < 0)
+                    return -1;
+                return _read(fd, buf, static_cast<unsigned>(n));
+            }
+#else
+            bool statPath(const std::string &path, FileId &id)
+            {
+                struct stat st{};
+                if (::stat(path.c_str(), &st) != 0)
+                    return false;
+                id = FileId{static_cast<std::uint64_t>(st.st_dev), static_cast<std::uint64_t>(st.st_ino),
+                            static_cast<std::uint64_t>(st.st_size)};
+                return true;
+            }
+
+            bool statFd(int fd, FileId &id)
+            {
+                struct stat st{};
+                if (::fstat(fd, &st) != 0)
+                    return false;
+                id = FileId{static_cast<std::uint64_t>(st.st_dev), static_cast<std::uint64_t>(st.st_ino),
+                            static_cast<std::uint64_t>(st.st_size)};
+                return true;
+            }
+
+            long long readAt(int fd, char *buf, std::size_t n, std::uint64_t offset)
+            {
+                return static_cast<long long>(::pread(fd, buf, n, static_cast<off_t>(offset)));
+            }
+#endif
+
+            std::string directoryOf(const std::string &path)
+            {
+                const auto slash = path.find_last_of("/\\");
+                if (slash == std::string::npos)
+                    return ".";
+                return slash == 0 ? path.substr(0, 1) : path.substr(0, slash);
+            }
+        } // namespace
+
+        FileFollower::FileFollower(std::string path, std::uint64_t startOffset, Options options)
+            : m_path(std::move(path)),
+              m_options(options),
+              m_offset(startOffset)
+        {
+        }
+
+        FileFollower::FileFollower(std::string path, std::uint64_t startOffset)
+            : FileFollower(std::move(path), startOffset, Options{})
+        {
+        }
+
+        FileFollower::~FileFollower()
+        {
+            closeFile();
+#if defined(__linux__)
+            if (m_watchFd >= 0)
+                ::close(m_watchFd);
+#endif
+        }
+
+        bool FileFollower::open()
+        {
+            const std::uint64_t resumeAt = m_offset;
+            if (!openFile())
+                return false;
+
+            FileId id;
+            if (statFd(m_fd, id) && resumeAt <= id.size)
+                m_offset = resumeAt;
+            else
+                m_offset = id.size;
+
+#if defined(__linux__)
+            m_watchFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (m_watchFd >= 0 &&
+                ::inotify_add_watch(m_watchFd, directoryOf(m_path).c_str(),
+                                    IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO) < 0)
+            {
+                ::close(m_watchFd);
+                m_watchFd = -1;
+            }
+            if (m_watchFd < 0)
+                Utils::getLogger().warn("inotify unavailable; following " + m_path + " by polling");
+#endif
+            return true;
+        }
+
+        std::size_t FileFollower::poll(std::string &out)
+        {
+            if (m_fd < 0)
+            {
+                // Rotated away and not recreated yet: start the new file once it appears.
+                if (!openFile())
+                {
+                    waitForChange();
+                    return 0;
+                }
+                m_offset = 0;
+            }
+
+            if (!m_backlog)
+                waitForChange();
+
+            const std::size_t before = out.size();
+            if (readMore() == 0 && checkRotation(out) && m_fd >= 0)
+                readMore();
+            takeLines(out);
+            return out.size() - before;
+        }
+
+        void FileFollower::waitForChange()
+        {
+#if defined(__linux__)
+            if (m_watchFd >= 0)
+            {
+                pollfd pfd{m_watchFd, POLLIN, 0};
+                if (::poll(&pfd, 1, static_cast<int>(m_options.pollInterval.count())) > 0)
+                {
+                    // Events only mean "look again": drain them without decoding.
+                    alignas(inotify_event) char buf[4096];
+                    while (::read(m_watchFd, buf, sizeof(buf)) > 0)
+                    {
+                    }
+                }
+                return;
+            }
+#endif
+            std::this_thread::sleep_for(m_options.pollInterval);
+        }
+
+        std::size_t FileFollower::readMore()
+        {
+            if (m_readBuffer.size() != m_options.maxReadBytes)
+                m_readBuffer.resize(m_options.maxReadBytes);
+            const long long n = readAt(m_fd, m_readBuffer.data(), m_readBuffer.size(), m_offset);
+            const std::size_t got = n > 0 ? static_cast<std::size_t>(n) : 0;
+            m_pending.append(m_readBuffer.data(), got);
+            m_offset += got;
+            m_backlog = got == m_options.maxReadBytes;
+            return got;
+        }
+
+        bool FileFollower::checkRotation(std::string &out)
+        {
+            FileId current;
+            if (!statFd(m_fd, current))
+                return false;
+
+            FileId atPath;
+            const bool pathExists = statPath(m_path, atPath);
+
+#if !defined(_WIN32)
+            if (pathExists && (atPath.device != m_device || atPath.inode != m_inode))
+            {
+                // Renamed/recreated: the old file is drained (we are at its EOF);
+                // deliver its unterminated last line, then start the new file.
+                if (!m_pending.empty())
+                {
+                    m_pending.push_back('\n');
+                    out += m_pending;
+                    m_pending.clear();
+                }
+                closeFile();
+                if (!openFile())
+                    return true; // retried on the next poll()
+                m_offset = 0;
+                ++m_rotations;
+                Utils::getLogger().info("Log rotated, following new " + m_path);
+                return true;
+            }
+#endif
+            if (current.size < m_offset || (pathExists && atPath.size < m_offset))
+            {
+                // Truncated in place (copytruncate) or replaced by a smaller file.
+                closeFile();
+                if (!openFile())
+                    return true;
+                m_offset = 0;
+                m_pending.clear();
+                ++m_rotations;
+                Utils::getLogger().info("Log truncated, restarting " + m_path + " from the beginning");
+                return true;
+            }
+            return false;
+        }
+
+        std::size_t FileFollower::takeLines(std::string &out)
+        {
+            const auto lastNewline = m_pending.rfind('\n');
+            if (lastNewline == std::string::npos)
+                return 0;
+
+            const std::size_t n = lastNewline + 1;
+            out.append(m_pending, 0, n);
+            m_pending.erase(0, n);
+            return n;
+        }
+
+        bool FileFollower::openFile()
+        {
+#if defined(_WIN32)
+            m_fd = ::_open(m_path.c_str(), _O_RDONLY | _O_BINARY);
+#else
+            m_fd = ::open(m_path.c_str(), O_RDONLY | O_CLOEXEC);
+#endif
+            if (m_fd < 0)
+                return false;
+
+            FileId id;
+            if (statFd(m_fd, id))
+            {
+                m_device = id.device;
+                m_inode = id.inode;
+            }
+            return true;
+        }
+
+        void FileFollower::closeFile() noexcept
+        {
+            if (m_fd >= 0)
+            {
+#if defined(_WIN32)
+                ::_close(m_fd);
+#else
+                ::close(m_fd);
+#endif
+                m_fd = -1;
+            }
+        }
+
+    } // namespace Input
+} // namespace LogTool
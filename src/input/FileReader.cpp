@@ -1,61 +1,148 @@
 #include "input/FileReader.hpp"
 
 #include <utility>   // std::move
+#include <cstring>   // std::memchr
+#include <filesystem>
+#include <iterator>
+
+#include "input/Decompressor.hpp"
+#include "utils/Logger.hpp"
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace LogTool
 {
     namespace Input
     {
-        FileReader::FileReader(const std::string &filePath)
+        FileReader::FileReader() = default;
+
+        FileReader::FileReader(const std::string &filePath, Mode mode)
             : m_stream(),
               m_filePath()
         {
-            open(filePath);
+            open(filePath, mode);
         }
 
         FileReader::FileReader(FileReader &&other) noexcept
             : m_stream(std::move(other.m_stream)),
-              m_filePath(std::move(other.m_filePath))
+              m_filePath(std::move(other.m_filePath)),
+              m_lineBuffer(std::move(other.m_lineBuffer)),
+              m_mode(other.m_mode),
+              m_mapData(other.m_mapData),
+              m_mapSize(other.m_mapSize),
+              m_mapPos(other.m_mapPos),
+              m_viewBegin(other.m_viewBegin),
+              m_viewEnd(other.m_viewEnd),
+              m_mapOpen(other.m_mapOpen),
+              m_compression(other.m_compression),
+              m_compressedCopy(std::move(other.m_compressedCopy)),
+              m_decompress(std::move(other.m_decompress)),
+              m_chunk(std::move(other.m_chunk)),
+              m_chunkPos(other.m_chunkPos)
+#if defined(_WIN32)
+              ,
+              m_fileHandle(other.m_fileHandle),
+              m_mappingHandle(other.m_mappingHandle)
+#endif
         {
-            // 'other' is left in a valid but unspecified state.
+            // 'other' is left in a valid but unspecified state; it no longer owns the mapping.
+            other.m_mapData = nullptr;
+            other.m_mapSize = 0;
+            other.m_mapPos  = 0;
+            other.m_viewBegin = 0;
+            other.m_viewEnd   = 0;
+            other.m_mapOpen = false;
+#if defined(_WIN32)
+            other.m_fileHandle    = nullptr;
+            other.m_mappingHandle = nullptr;
+#endif
         }
 
         FileReader &FileReader::operator=(FileReader &&other) noexcept
         {
             if (this != &other)
             {
-                // Close any currently open stream before taking over.
-                if (m_stream.is_open())
-                {
-                    m_stream.close();
-                }
+                // Close any currently open stream/mapping before taking over.
+                reset();
 
-                m_stream   = std::move(other.m_stream);
-                m_filePath = std::move(other.m_filePath);
+                m_stream     = std::move(other.m_stream);
+                m_filePath   = std::move(other.m_filePath);
+                m_lineBuffer = std::move(other.m_lineBuffer);
+                m_mode       = other.m_mode;
+                m_mapData    = other.m_mapData;
+                m_mapSize    = other.m_mapSize;
+                m_mapPos     = other.m_mapPos;
+                m_viewBegin  = other.m_viewBegin;
+                m_viewEnd    = other.m_viewEnd;
+                m_mapOpen    = other.m_mapOpen;
+                m_compression    = other.m_compression;
+                m_compressedCopy = std::move(other.m_compressedCopy);
+                m_decompress     = std::move(other.m_decompress);
+                m_chunk          = std::move(other.m_chunk);
+                m_chunkPos       = other.m_chunkPos;
+#if defined(_WIN32)
+                m_fileHandle    = other.m_fileHandle;
+                m_mappingHandle = other.m_mappingHandle;
+                other.m_fileHandle    = nullptr;
+                other.m_mappingHandle = nullptr;
+#endif
+                other.m_mapData = nullptr;
+                other.m_mapSize = 0;
+                other.m_mapPos  = 0;
+                other.m_viewBegin = 0;
+                other.m_viewEnd   = 0;
+                other.m_mapOpen = false;
             }
             return *this;
         }
 
         FileReader::~FileReader()
         {
-            // RAII: ensure file is closed on destruction.
-            if (m_stream.is_open())
-            {
-                m_stream.close();
-            }
+            // RAII: ensure file is closed / unmapped on destruction.
+            reset();
         }
 
-        bool FileReader::open(const std::string &filePath)
+        bool FileReader::open(const std::string &filePath, Mode mode)
         {
             // Close any existing file first.
-            if (m_stream.is_open())
+            reset();
+
+            // Compressed files are detected by content, not by name. Only regular
+            // files are probed: reading a pipe here would lose its first bytes.
+            std::error_code ec;
+            if (std::filesystem::is_regular_file(filePath, ec))
             {
-                m_stream.close();
+                char head[4] = {};
+                std::ifstream probe(filePath, std::ios::binary);
+                probe.read(head, sizeof(head));
+                const auto kind = detectCompression(std::string_view(head, static_cast<std::size_t>(probe.gcount())));
+                if (kind != Compression::None)
+                {
+                    return openCompressed(filePath, kind);
+                }
             }
 
-            m_filePath.clear();
+            if (mode == Mode::Mapped && mapFile(filePath))
+            {
+                m_viewBegin = 0;
+                m_viewEnd   = m_mapSize;
+                m_mode     = Mode::Mapped;
+                m_filePath = filePath;
+                return true;
+            }
 
             // Open in text mode for log files; rely on buffering of ifstream.
+            m_mode = Mode::Stream;
             m_stream.open(filePath, std::ios::in);
             if (!m_stream.is_open())
             {
@@ -71,16 +158,12 @@ namespace LogTool
 
         void FileReader::close() noexcept
         {
-            if (m_stream.is_open())
-            {
-                m_stream.close();
-            }
-            m_filePath.clear();
+            reset();
         }
 
         bool FileReader::isOpen() const noexcept
         {
-            return m_stream.is_open();
+            return m_mapOpen || m_stream.is_open() || m_mode == Mode::Compressed;
         }
 
         std::string FileReader::filePath() const
@@ -90,29 +173,142 @@ namespace LogTool
 
         std::optional<std::string> FileReader::nextLine()
         {
+            auto view = nextLineView();
+            if (!view)
+            {
+                return std::nullopt;
+            }
+            return std::string(*view);
+        }
+
+        std::optional<std::string_view> FileReader::nextLineView()
+        {
+            if (m_mode == Mode::Compressed)
+            {
+                for (;;)
+                {
+                    if (const auto line = nextLineIn(m_chunk, m_chunkPos))
+                    {
+                        return line;
+                    }
+                    m_chunkPos = 0;
+                    if (!nextChunk(m_chunk))
+                    {
+                        m_chunk.clear();
+                        return std::nullopt;
+                    }
+                }
+            }
+
+            if (m_mapOpen)
+            {
+                return nextLineIn(mappedData(), m_mapPos);
+            }
+
             if (!m_stream.is_open())
             {
                 return std::nullopt;
             }
 
-            std::string line;
-            if (!std::getline(m_stream, line))
+            if (!std::getline(m_stream, m_lineBuffer))
             {
                 // EOF or error.
                 return std::nullopt;
             }
 
             // Drop trailing '\r' for Windows-style line endings.
-            if (!line.empty() && line.back() == '\r')
+            if (!m_lineBuffer.empty() && m_lineBuffer.back() == '\r')
             {
-                line.pop_back();
+                m_lineBuffer.pop_back();
             }
 
-            return line;
+            return std::string_view(m_lineBuffer);
+        }
+
+        std::optional<std::string_view> FileReader::nextLineIn(std::string_view data,
+                                                               std::size_t &pos) noexcept
+        {
+            if (pos >= data.size())
+            {
+                return std::nullopt;
+            }
+
+            const char *begin = data.data() + pos;
+            const std::size_t remaining = data.size() - pos;
+            const void *nl = std::memchr(begin, '\n', remaining);
+
+            std::size_t len = nl ? static_cast<std::size_t>(static_cast<const char *>(nl) - begin)
+                                 : remaining;
+            pos += nl ? len + 1 : len;
+
+            // Drop trailing '\r' for Windows-style line endings.
+            if (len > 0 && begin[len - 1] == '\r')
+            {
+                --len;
+            }
+            return std::string_view(begin, len);
+        }
+
+        bool FileReader::nextChunk(std::string &chunk)
+        {
+            if (!m_decompress)
+            {
+                return false;
+            }
+            if (m_decompress->next(chunk))
+            {
+                return true;
+            }
+
+            if (!m_decompress->error().empty())
+            {
+                Utils::getLogger().error("Decompression of " + m_filePath + " stopped after " +
+                                         std::to_string(m_decompress->bytesOut()) + " bytes: " +
+                                         m_decompress->error());
+            }
+            m_decompress.reset();
+            return false;
+        }
+
+        std::string_view FileReader::mappedData() const noexcept
+        {
+            if (m_mode != Mode::Mapped || m_mapData == nullptr)
+            {
+                return {};
+            }
+            return std::string_view(m_mapData + m_viewBegin, m_viewEnd - m_viewBegin);
+        }
+
+        bool FileReader::restrictTo(std::size_t begin, std::size_t end) noexcept
+        {
+            if (m_mode != Mode::Mapped || begin > end || end > m_mapSize)
+            {
+                return false;
+            }
+            m_viewBegin = begin;
+            m_viewEnd   = end;
+            m_mapPos    = 0;
+            return true;
         }
 
         bool FileReader::rewind()
         {
+            if (m_mode == Mode::Compressed)
+            {
+                // Start decompressing again from the beginning.
+                m_decompress.reset();
+                m_decompress = std::make_unique<DecompressStream>(m_compression, compressedData());
+                m_chunk.clear();
+                m_chunkPos = 0;
+                return true;
+            }
+
+            if (m_mapOpen)
+            {
+                m_mapPos = 0;
+                return true;
+            }
+
             if (!m_stream.is_open())
             {
                 return false;
@@ -125,12 +321,190 @@ namespace LogTool
 
         void FileReader::reset() noexcept
         {
+            // Stop the decompressor before the data it reads goes away.
+            m_decompress.reset();
+            m_compressedCopy.reset();
+            m_chunk.clear();
+            m_chunkPos    = 0;
+            m_compression = Compression::None;
+
             if (m_stream.is_open())
             {
                 m_stream.close();
             }
+            unmapFile();
             m_filePath.clear();
+            m_mode = Mode::Stream;
+        }
+
+        bool FileReader::openCompressed(const std::string &filePath, Compression kind)
+        {
+            if (!compressionSupported(kind))
+            {
+                Utils::getLogger().error(std::string(compressionName(kind)) +
+                                         " input is not supported by this build: " + filePath + " (" +
+                                         compressionHint(kind) + ")");
+                return false;
+            }
+
+            if (!mapFile(filePath))
+            {
+                std::ifstream in(filePath, std::ios::binary);
+                if (!in.is_open())
+                {
+                    return false;
+                }
+                m_compressedCopy = std::make_unique<std::string>((std::istreambuf_iterator<char>(in)),
+                                                                 std::istreambuf_iterator<char>());
+            }
+
+            m_mode        = Mode::Compressed;
+            m_compression = kind;
+            m_filePath    = filePath;
+            m_decompress  = std::make_unique<DecompressStream>(kind, compressedData());
+            return true;
+        }
+
+        std::string_view FileReader::compressedData() const noexcept
+        {
+            if (m_compressedCopy)
+            {
+                return *m_compressedCopy;
+            }
+            return m_mapData ? std::string_view(m_mapData, m_mapSize) : std::string_view();
+        }
+
+        // -------------------------
+        // Memory mapping (platform specific)
+        // -------------------------
+#if defined(_WIN32)
+        bool FileReader::mapFile(const std::string &filePath)
+        {
+            HANDLE file = ::CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                        nullptr, OPEN_EXISTING,
+                                        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+            {
+                return false;
+            }
+
+            LARGE_INTEGER size{};
+            if (!::GetFileSizeEx(file, &size) || ::GetFileType(file) != FILE_TYPE_DISK)
+            {
+                ::CloseHandle(file);
+                return false;
+            }
+
+            m_fileHandle = file;
+            m_mapSize    = static_cast<std::size_t>(size.QuadPart);
+            m_mapPos     = 0;
+            m_mapOpen    = true;
+
+            // Zero-length files cannot be mapped; treat them as an empty mapping.
+            if (m_mapSize == 0)
+            {
+                return true;
+            }
+
+            HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping == nullptr)
+            {
+                unmapFile();
+                return false;
+            }
+            m_mappingHandle = mapping;
+
+            void *view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (view == nullptr)
+            {
+                unmapFile();
+                return false;
+            }
+            m_mapData = static_cast<const char *>(view);
+            return true;
+        }
+
+        void FileReader::unmapFile() noexcept
+        {
+            if (m_mapData != nullptr)
+            {
+                ::UnmapViewOfFile(m_mapData);
+            }
+            if (m_mappingHandle != nullptr)
+            {
+                ::CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+            }
+            if (m_fileHandle != nullptr)
+            {
+                ::CloseHandle(static_cast<HANDLE>(m_fileHandle));
+            }
+            m_mapData       = nullptr;
+            m_mappingHandle = nullptr;
+            m_fileHandle    = nullptr;
+            m_mapSize       = 0;
+            m_mapPos        = 0;
+            m_viewBegin     = 0;
+            m_viewEnd       = 0;
+            m_mapOpen       = false;
+        }
+#else
+        bool FileReader::mapFile(const std::string &filePath)
+        {
+            const int fd = ::open(filePath.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                return false;
+            }
+
+            struct stat st{};
+            if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+            {
+                ::close(fd);
+                return false;
+            }
+
+            m_mapSize = static_cast<std::size_t>(st.st_size);
+            m_mapPos  = 0;
+
+            // Zero-length files cannot be mapped; treat them as an empty mapping.
+            if (m_mapSize == 0)
+            {
+                ::close(fd);
+                m_mapOpen = true;
+                return true;
+            }
+
+            void *addr = ::mmap(nullptr, m_mapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+            // The mapping keeps its own reference to the file; the descriptor is no longer needed.
+            ::close(fd);
+            if (addr == MAP_FAILED)
+            {
+                m_mapSize = 0;
+                return false;
+            }
+
+            // Logs are consumed front to back: ask for aggressive read-ahead.
+            (void)::madvise(addr, m_mapSize, MADV_SEQUENTIAL);
+
+            m_mapData = static_cast<const char *>(addr);
+            m_mapOpen = true;
+            return true;
+        }
+
+        void FileReader::unmapFile() noexcept
+        {
+            if (m_mapData != nullptr)
+            {
+                ::munmap(const_cast<char *>(m_mapData), m_mapSize);
+            }
+            m_mapData = nullptr;
+            m_mapSize = 0;
+            m_mapPos  = 0;
+            m_viewBegin = 0;
+            m_viewEnd   = 0;
+            m_mapOpen = false;
         }
+#endif
 
     } // namespace Input
 } // namespace LogTool
@@ -0,0 +1,149 @@
+#include "input/IngestPipeline.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "input/ParallelParser.hpp"
+#include "utils/SpscQueue.hpp"
+
+namespace LogTool
+{
+    namespace Input
+    {
+        IngestPipeline::IngestPipeline(const LogParser &parser,
+                                       std::size_t parserThreads,
+                                       std::size_t queueDepth,
+                                       std::size_t chunkBytes)
+            : m_parser(parser),
+              m_parserThreads(std::max<std::size_t>(parserThreads, 1)),
+              m_queueDepth(std::max<std::size_t>(queueDepth, 1)),
+              m_chunkBytes(std::max<std::size_t>(chunkBytes, 4096))
+        {
+        }
+
+        void IngestPipeline::run(FileReader &reader, const Consumer &consume)
+        {
+            using ChunkQueue = Utils::SpscQueue<Chunk>;
+            using BatchQueue = Utils::SpscQueue<Batch>;
+
+            const std::size_t n = m_parserThreads;
+            std::vector<std::unique_ptr<ChunkQueue>> toParser;
+            std::vector<std::unique_ptr<BatchQueue>> fromParser;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                toParser.push_back(std::make_unique<ChunkQueue>(m_queueDepth));
+                fromParser.push_back(std::make_unique<BatchQueue>(m_queueDepth));
+            }
+
+            std::vector<std::thread> threads;
+
+            // Closing every queue unblocks all stages; used at the end and if the consumer throws.
+            struct Shutdown
+            {
+                std::vector<std::unique_ptr<ChunkQueue>> &in;
+                std::vector<std::unique_ptr<BatchQueue>> &out;
+                std::vector<std::thread> &threads;
+                ~Shutdown()
+                {
+                    for (auto &q : in) q->close();
+                    for (auto &q : out) q->close();
+                    for (auto &t : threads)
+                    {
+                        if (t.joinable()) t.join();
+                    }
+                }
+            } shutdown{toParser, fromParser, threads};
+
+            // Parser stage: chunk -> batch, one SPSC edge in and one out per thread.
+            for (std::size_t w = 0; w < n; ++w)
+            {
+                threads.emplace_back([this, &in = *toParser[w], &out = *fromParser[w]]() {
+                    Chunk chunk;
+                    while (in.pop(chunk))
+                    {
+                        auto batch = std::make_shared<LogParser::ParsedBatch>();
+                        batch->entries.reserve(chunk.text.size() / 64);
+                        if (!chunk.owned)
+                        {
+                            batch->inputBegin = chunk.offset;
+                            batch->inputEnd   = chunk.offset + chunk.text.size();
+                        }
+                        std::size_t pos = 0;
+                        while (const auto line = FileReader::nextLineIn(chunk.text, pos))
+                        {
+                            if (line->empty())
+                                continue;
+                            m_parser.parseInto(*line, *batch);
+                        }
+                        chunk = Chunk{};
+                        if (!out.push(std::move(batch)))
+                            return; // consumer is gone
+                    }
+                    out.close();
+                });
+            }
+
+            // Reader stage: cut the input into line-aligned chunks, dealt round-robin.
+            threads.emplace_back([this, &reader, &toParser, n]() {
+                std::size_t next = 0;
+                auto send = [&](Chunk chunk) { return toParser[next++ % n]->push(std::move(chunk)); };
+
+                if (reader.mode() == FileReader::Mode::Mapped)
+                {
+                    const std::string_view data = reader.mappedData();
+                    for (const auto range : ParallelParser::splitRanges(data, m_chunkBytes))
+                    {
+                        if (!send(Chunk{range, nullptr, static_cast<std::size_t>(range.data() - data.data())}))
+                            break;
+                    }
+                }
+                else if (reader.mode() == FileReader::Mode::Compressed)
+                {
+                    // Decompressed blocks are line-aligned already: pass them on whole.
+                    auto owned = std::make_shared<std::string>();
+                    while (reader.nextChunk(*owned))
+                    {
+                        const std::string_view text(*owned);
+                        if (!send(Chunk{text, std::move(owned)}))
+                            break;
+                        owned = std::make_shared<std::string>();
+                    }
+                }
+                else
+                {
+                    auto owned = std::make_shared<std::string>();
+                    owned->reserve(m_chunkBytes + 4096);
+                    while (const auto line = reader.nextLineView())
+                    {
+                        owned->append(*line).push_back('\n');
+                        if (owned->size() >= m_chunkBytes)
+                        {
+                            const std::string_view text(*owned);
+                            if (!send(Chunk{text, std::move(owned)}))
+                                break;
+                            owned = std::make_shared<std::string>();
+                            owned->reserve(m_chunkBytes + 4096);
+                        }
+                    }
+                    if (!owned->empty())
+                    {
+                        const std::string_view text(*owned);
+                        send(Chunk{text, std::move(owned)});
+                    }
+                }
+
+                for (auto &q : toParser) q->close();
+            });
+
+            // Consumer stage (this thread): batch k comes back from parser k % n.
+            Batch batch;
+            for (std::size_t k = 0; fromParser[k % n]->pop(batch); ++k)
+            {
+                consume(batch);
+                batch.reset();
+            }
+        }
+
+    } // namespace Input
+} // namespace LogTool
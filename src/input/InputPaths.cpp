@@ -0,0 +1,184 @@
+#include "input/InputPaths.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <set>
+#include <system_error>
+
+namespace LogTool
+{
+    namespace Input
+    {
+        namespace
+        {
+            namespace fs = std::filesystem;
+
+            bool hasWildcard(std::string_view s) noexcept
+            {
+                return s.find_first_of("*?[") != std::string_view::npos;
+            }
+
+            // Match one character against the class starting at pattern[p] == '['.
+            // Sets 'next' past the closing ']'; returns false in 'valid' if unterminated.
+            bool matchClass(std::string_view pattern, std::size_t p, char c, std::size_t &next, bool &valid) noexcept
+            {
+                std::size_t i = p + 1;
+                const bool negate = i < pattern.size() && (pattern[i] == '!' || pattern[i] == '^');
+                if (negate)
+                    ++i;
+
+                bool matched = false;
+                const std::size_t first = i;
+                for (; i < pattern.size() && (pattern[i] != ']' || i == first); ++i)
+                {
+                    if (i + 2 < pattern.size() && pattern[i + 1] == '-' && pattern[i + 2] != ']')
+                    {
+                        matched = matched || (pattern[i] <= c && c <= pattern[i + 2]);
+                        i += 2;
+                    }
+                    else
+                    {
+                        matched = matched || pattern[i] == c;
+                    }
+                }
+
+                valid = i < pattern.size();
+                next = i + 1;
+                return matched != negate;
+            }
+
+            // The tool's own sidecar files next to a log (time index, entry cache).
+            bool isSidecar(std::string_view name) noexcept
+            {
+                const auto endsWith = [&](std::string_view suffix)
+                { return name.size() > suffix.size() && name.substr(name.size() - suffix.size()) == suffix; };
+                return endsWith(".idx") || endsWith(".lcache");
+            }
+
+            // Regular files in 'dir' whose name matches 'pattern' (all when empty), sorted.
+            std::vector<std::string> listDirectory(const fs::path &dir, std::string_view pattern)
+            {
+                std::vector<std::string> files;
+                std::error_code ec;
+                for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec))
+                {
+                    const std::string name = it->path().filename().string();
+                    if (name.empty() || name[0] == '.' || isSidecar(name))
+                        continue;
+                    if (!pattern.empty() && !globMatch(pattern, name))
+                        continue;
+                    std::error_code typeEc;
+                    if (it->is_regular_file(typeEc))
+                        files.push_back(it->path().string());
+                }
+                std::sort(files.begin(), files.end());
+                return files;
+            }
+        } // namespace
+
+        bool globMatch(std::string_view pattern, std::string_view name) noexcept
+        {
+            // Iterative matcher; on a mismatch, retry from the last '*' with one
+            // more character consumed by it.
+            std::size_t p = 0, n = 0;
+            std::size_t starP = std::string_view::npos, starN = 0;
+            while (n < name.size())
+            {
+                if (p < pattern.size())
+                {
+                    const char pc = pattern[p];
+                    if (pc == '*')
+                    {
+                        starP = p++;
+                        starN = n;
+                        continue;
+                    }
+                    if (pc == '?')
+                    {
+                        ++p;
+                        ++n;
+                        continue;
+                    }
+                    if (pc == '[')
+                    {
+                        std::size_t next = 0;
+                        bool valid = false;
+                        const bool hit = matchClass(pattern, p, name[n], next, valid);
+                        if (valid && hit)
+                        {
+                            p = next;
+                            ++n;
+                            continue;
+                        }
+                        if (!valid && name[n] == '[') // unterminated: a literal '['
+                        {
+                            ++p;
+                            ++n;
+                            continue;
+                        }
+                    }
+                    else if (pc == name[n])
+                    {
+                        ++p;
+                        ++n;
+                        continue;
+                    }
+                }
+                if (starP == std::string_view::npos)
+                    return false;
+                p = starP + 1;
+                n = ++starN;
+            }
+            while (p < pattern.size() && pattern[p] == '*')
+                ++p;
+            return p == pattern.size();
+        }
+
+        std::vector<std::string> expandInputPaths(const std::vector<std::string> &args,
+                                                  std::vector<std::string> &unmatched)
+        {
+            std::vector<std::string> files;
+            std::set<std::string> seen;
+            auto add = [&](const std::string &path)
+            {
+                std::error_code ec;
+                const auto key = fs::weakly_canonical(fs::path(path), ec);
+                if (seen.insert(ec ? path : key.string()).second)
+                    files.push_back(path);
+            };
+
+            for (const auto &arg : args)
+            {
+                const fs::path path(arg);
+                std::error_code ec;
+                std::vector<std::string> found;
+                if (fs::is_directory(path, ec))
+                {
+                    found = listDirectory(path, {});
+                }
+                else if (hasWildcard(path.filename().string()) && !fs::exists(path, ec))
+                {
+                    const fs::path dir = path.has_parent_path() ? path.parent_path() : fs::path(".");
+                    found = listDirectory(dir, path.filename().string());
+                    if (!path.has_parent_path())
+                    {
+                        for (auto &f : found) // "./name" -> "name", as the user wrote it
+                            f = fs::path(f).filename().string();
+                    }
+                }
+                else
+                {
+                    add(arg);
+                    continue;
+                }
+
+                if (found.empty())
+                    unmatched.push_back(arg);
+                for (const auto &f : found)
+                    add(f);
+            }
+            return files;
+        }
+
+    } // namespace Input
+} // namespace LogTool
@@ -0,0 +1,331 @@
+#include "input/JsonScanner.hpp"
+
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LOGTOOL_JSON_SSE2 1
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace LogTool
+{
+    namespace Input
+    {
+        namespace
+        {
+            inline bool isJsonSpace(char c) noexcept
+            {
+                return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+            }
+
+#if defined(LOGTOOL_JSON_SSE2)
+            inline unsigned lowestBit(unsigned mask) noexcept
+            {
+#if defined(_MSC_VER)
+                unsigned long idx = 0;
+                _BitScanForward(&idx, mask);
+                return static_cast<unsigned>(idx);
+#else
+                return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+            }
+#endif
+
+            /// Cursor over one JSON line.
+            struct Cursor
+            {
+                const char *p;
+                const char *end;
+
+                void skipSpace() noexcept
+                {
+                    while (p < end && isJsonSpace(*p)) ++p;
+                }
+
+                bool consume(char c) noexcept
+                {
+                    skipSpace();
+                    if (p < end && *p == c)
+                    {
+                        ++p;
+                        return true;
+                    }
+                    return false;
+                }
+
+                /// p is just past an opening quote; capture the body and step past the closing quote.
+                bool string(std::string_view &body, bool &hasEscapes) noexcept
+                {
+                    const char *start = p;
+                    hasEscapes = false;
+                    for (;;)
+                    {
+                        p = JsonScanner::findQuoteOrBackslash(p, end);
+                        if (p >= end)
+                        {
+                            return false;
+                        }
+                        if (*p == '"')
+                        {
+                            body = std::string_view(start, static_cast<std::size_t>(p - start));
+                            ++p;
+                            return true;
+                        }
+                        // Backslash: skip it and the escaped character.
+                        hasEscapes = true;
+                        p += 2;
+                    }
+                }
+
+                /// p is on '{' or '['; skip the whole nested value.
+                bool nested() noexcept
+                {
+                    int depth = 0;
+                    while (p < end)
+                    {
+                        const char c = *p++;
+                        if (c == '"')
+                        {
+                            std::string_view ignored;
+                            bool esc = false;
+                            if (!string(ignored, esc))
+                                return false;
+                        }
+                        else if (c == '{' || c == '[')
+                        {
+                            ++depth;
+                        }
+                        else if (c == '}' || c == ']')
+                        {
+                            if (--depth == 0)
+                                return true;
+                        }
+                    }
+                    return false;
+                }
+            };
+
+            void appendUtf8(std::uint32_t cp, std::string &out)
+            {
+                if (cp < 0x80)
+                {
+                    out.push_back(static_cast<char>(cp));
+                }
+                else if (cp < 0x800)
+                {
+                    out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+                    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+                }
+                else if (cp < 0x10000)
+                {
+                    out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+                    out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+                    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+                }
+                else
+                {
+                    out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+                    out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+                    out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+                    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+                }
+            }
+
+            /// Parse 4 hex digits at s[i..i+4); returns false if they are not hex.
+            bool parseHex4(std::string_view s, std::size_t i, std::uint32_t &cp) noexcept
+            {
+                if (i + 4 > s.size())
+                {
+                    return false;
+                }
+                cp = 0;
+                for (std::size_t k = i; k < i + 4; ++k)
+                {
+                    const char c = s[k];
+                    cp <<= 4;
+                    if (c >= '0' && c <= '9')      cp |= static_cast<std::uint32_t>(c - '0');
+                    else if (c >= 'a' && c <= 'f') cp |= static_cast<std::uint32_t>(c - 'a' + 10);
+                    else if (c >= 'A' && c <= 'F') cp |= static_cast<std::uint32_t>(c - 'A' + 10);
+                    else return false;
+                }
+                return true;
+            }
+
+            constexpr std::uint32_t kReplacementChar = 0xFFFD;
+        } // anonymous namespace
+
+        const char *JsonScanner::findQuoteOrBackslash(const char *p, const char *end) noexcept
+        {
+#if defined(LOGTOOL_JSON_SSE2)
+            const __m128i quote = _mm_set1_epi8('"');
+            const __m128i slash = _mm_set1_epi8('\\');
+            while (end - p >= 16)
+            {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+                const __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, slash));
+                const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+                if (mask != 0)
+                {
+                    return p + lowestBit(mask);
+                }
+                p += 16;
+            }
+#endif
+            while (p < end && *p != '"' && *p != '\\') ++p;
+            return p;
+        }
+
+        bool JsonScanner::scanObject(std::string_view json,
+                                     const std::string_view *keys,
+                                     std::size_t keyCount,
+                                     Value *out) noexcept
+        {
+            Cursor cur{json.data(), json.data() + json.size()};
+
+            if (!cur.consume('{'))
+            {
+                return false;
+            }
+            if (cur.consume('}'))
+            {
+                return true;
+            }
+
+            for (;;)
+            {
+                // Key
+                if (!cur.consume('"'))
+                    return false;
+                std::string_view key;
+                bool keyEscaped = false;
+                if (!cur.string(key, keyEscaped))
+                    return false;
+                if (!cur.consume(':'))
+                    return false;
+
+                // Value
+                cur.skipSpace();
+                if (cur.p >= cur.end)
+                    return false;
+
+                Value v;
+                v.found = true;
+                const char c = *cur.p;
+                if (c == '"')
+                {
+                    ++cur.p;
+                    v.isString = true;
+                    if (!cur.string(v.raw, v.hasEscapes))
+                        return false;
+                }
+                else if (c == '{' || c == '[')
+                {
+                    const char *start = cur.p;
+                    if (!cur.nested())
+                        return false;
+                    v.raw = std::string_view(start, static_cast<std::size_t>(cur.p - start));
+                }
+                else
+                {
+                    // Number / true / false / null
+                    const char *start = cur.p;
+                    while (cur.p < cur.end && *cur.p != ',' && *cur.p != '}' && !isJsonSpace(*cur.p)) ++cur.p;
+                    v.raw = std::string_view(start, static_cast<std::size_t>(cur.p - start));
+                }
+
+                // Escaped keys never match the plain-ASCII names callers ask for.
+                if (!keyEscaped)
+                {
+                    for (std::size_t i = 0; i < keyCount; ++i)
+                    {
+                        if (!out[i].found && keys[i] == key)
+                        {
+                            out[i] = v;
+                            break;
+                        }
+                    }
+                }
+
+                if (cur.consume(','))
+                    continue;
+                return cur.consume('}');
+            }
+        }
+
+        std::string JsonScanner::decode(const Value &value)
+        {
+            if (!value.isString || !value.hasEscapes)
+            {
+                return std::string(value.raw);
+            }
+            std::string out;
+            out.reserve(value.raw.size());
+            appendUnescaped(value.raw, out);
+            return out;
+        }
+
+        void JsonScanner::appendUnescaped(std::string_view body, std::string &out)
+        {
+            std::size_t i = 0;
+            while (i < body.size())
+            {
+                const char c = body[i++];
+                if (c != '\\' || i >= body.size())
+                {
+                    out.push_back(c);
+                    continue;
+                }
+
+                const char e = body[i++];
+                switch (e)
+                {
+                case 'b': out.push_back('\b'); break;
+                case 'f': out.push_back('\f'); break;
+                case 'n': out.push_back('\n'); break;
+                case 'r': out.push_back('\r'); break;
+                case 't': out.push_back('\t'); break;
+                case 'u':
+                {
+                    std::uint32_t cp = 0;
+                    if (!parseHex4(body, i, cp))
+                    {
+                        appendUtf8(kReplacementChar, out);
+                        break;
+                    }
+                    i += 4;
+
+                    if (cp >= 0xD800 && cp <= 0xDBFF)
+                    {
+                        // High surrogate: combine with a following \uDC00-\uDFFF.
+                        std::uint32_t lo = 0;
+                        if (i + 1 < body.size() && body[i] == '\\' && body[i + 1] == 'u' &&
+                            parseHex4(body, i + 2, lo) && lo >= 0xDC00 && lo <= 0xDFFF)
+                        {
+                            i += 6;
+                            cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                        }
+                        else
+                        {
+                            cp = kReplacementChar;
+                        }
+                    }
+                    else if (cp >= 0xDC00 && cp <= 0xDFFF)
+                    {
+                        cp = kReplacementChar; // unpaired low surrogate
+                    }
+                    appendUtf8(cp, out);
+                    break;
+                }
+                default:
+                    // '"', '\\', '/' and (leniently) anything else map to themselves.
+                    out.push_back(e);
+                    break;
+                }
+            }
+        }
+
+    } // namespace Input
+} // namespace LogTool
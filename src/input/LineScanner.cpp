@@ -0,0 +1,115 @@
+#include "input/LineScanner.hpp"
+#include "utils/StringUtils.hpp"   // Utils::iequals
+#include "utils/TimeUtils.hpp"     // Utils::timestampLength
+
+namespace LogTool
+{
+    namespace Input
+    {
+        namespace
+        {
+            inline bool isAlpha(char c) noexcept
+            {
+                return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+            }
+        } // anonymous namespace
+
+        ScannedLine LineScanner::scan(std::string_view line) noexcept
+        {
+            ScannedLine s;
+            s.line = line;
+            s.bodyBegin = line.size();
+
+            const std::size_t tsLen = matchTimestamp(line);
+            if (tsLen == 0)
+            {
+                return s;
+            }
+            s.timestamp = line.substr(0, tsLen);
+
+            std::size_t pos = tsLen;
+            const std::size_t gapStart = pos;
+            while (pos < line.size() && isSpace(line[pos])) ++pos;
+            if (pos == gapStart)
+            {
+                return s;
+            }
+
+            std::string_view level;
+            const std::size_t lvlLen = matchLevel(line.substr(pos), level);
+            if (lvlLen == 0)
+            {
+                return s;
+            }
+            pos += lvlLen;
+
+            const std::size_t bodyGap = pos;
+            while (pos < line.size() && isSpace(line[pos])) ++pos;
+            if (pos == bodyGap)
+            {
+                // "INFOxyz" or a level with nothing after it: no usable prefix.
+                return s;
+            }
+
+            s.level = level;
+            s.bodyBegin = pos;
+            return s;
+        }
+
+        std::size_t LineScanner::matchTimestamp(std::string_view s) noexcept
+        {
+            return Utils::timestampLength(s);
+        }
+
+        std::size_t LineScanner::matchLevel(std::string_view s, std::string_view &token) noexcept
+        {
+            const bool bracketed = !s.empty() && s.front() == '[';
+            const std::size_t b = bracketed ? 1 : 0;
+            std::size_t e = b;
+            while (e < s.size() && isAlpha(s[e])) ++e;
+            if (e == b)
+            {
+                return 0;
+            }
+            if (bracketed)
+            {
+                if (e >= s.size() || s[e] != ']')
+                {
+                    return 0;
+                }
+                token = s.substr(b, e - b);
+                return e + 1;
+            }
+            token = s.substr(0, e);
+            return e;
+        }
+
+        std::optional<core::LogLevel> LineScanner::levelFromToken(std::string_view token) noexcept
+        {
+            static const struct
+            {
+                std::string_view levelStr;
+                core::LogLevel level;
+            } levelMap[] = {
+                {"TRACE",    core::LogLevel::Trace},
+                {"DEBUG",    core::LogLevel::Debug},
+                {"INFO",     core::LogLevel::Info},
+                {"WARN",     core::LogLevel::Warn},
+                {"WARNING",  core::LogLevel::Warn},
+                {"ERROR",    core::LogLevel::Error},
+                {"FATAL",    core::LogLevel::Critical},
+                {"CRITICAL", core::LogLevel::Critical},
+            };
+
+            for (const auto &mapping : levelMap)
+            {
+                if (Utils::iequals(token, mapping.levelStr))
+                {
+                    return mapping.level;
+                }
+            }
+            return std::nullopt;
+        }
+
+    } // namespace Input
+} // namespace LogTool
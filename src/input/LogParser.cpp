@@ -1,7 +1,8 @@
 #include "input/LogParser.hpp"
-#include "utils/Utils.hpp"   // Utils::trim/ltrim/rtrim/split/contains/toUpper/parseTimestamp
+#include "input/JsonScanner.hpp"
+#include "input/LineScanner.hpp"
+#include "utils/Utils.hpp"   // Utils::iequals/parseLogTimestamp
 
-#include <regex>
 #include <algorithm>
 #include <vector>
 
@@ -31,21 +32,34 @@ namespace LogTool
             {
                 return Core::LogEntry::Clock::now();
             }
+
+            /// Arena holding the text of entries parsed on this thread.
+            inline Core::TextArenaWriter &threadArena()
+            {
+                thread_local Core::TextArenaWriter arena;
+                return arena;
+            }
         } // anonymous namespace
 
 LogParser::LogParser()
         {
-            // Pre-configure common log patterns the parser will try
-            m_patterns = {
-                // Apache/Nginx style: [timestamp] level source: message
+            // Pre-configure common log patterns the parser will try (in priority order)
+            const char *defaults[] = {
+                // Apache/Nginx style: timestamp level source: message
                 "%timestamp% %level% %source%: %message%",
+                // This tool's own format: timestamp [level] source - message
+                "%timestamp% %level% %source% - %message%",
                 // Syslog style: timestamp level source message
                 "%timestamp% %level% %source% %message%",
                 // Custom bracketed: [timestamp] level[source] message
                 "\\[%timestamp%] %level%\\[%source%] %message%",
-                // Simple timestamp level message
-                "%timestamp% %level% %message%"
+                // No source: timestamp level - message
+                "%timestamp% %level% - %message%"
             };
+            for (const char *p : defaults)
+            {
+                addPattern(p);
+            }
         }
 
         std::optional<Core::LogEntry> LogParser::parseLine(std::string_view rawLine) const
@@ -82,9 +96,11 @@ LogParser::LogParser()
                 return r;
             }
 
-            for (const auto &pattern : m_patterns)
+            // One pass finds the timestamp/level/body offsets; every template reuses it.
+            const ScannedLine scan = LineScanner::scan(trimmed);
+            for (const std::size_t idx : m_order)
             {
-                auto entry = tryParsePattern(trimmed, pattern);
+                auto entry = tryParsePattern(scan, m_matchers[idx]);
                 if (entry)
                 {
                     r.entry = std::move(entry);
@@ -97,9 +113,27 @@ LogParser::LogParser()
             return r;
         }
 
+        void LogParser::parseInto(std::string_view rawLine, ParsedBatch &out) const
+        {
+            ParseResult r = parseLineDetailed(rawLine);
+            if (r.entry)
+            {
+                const auto ts = r.entry->timestamp();
+                out.outOfRange = (m_since && ts < *m_since) || (m_until && ts >= *m_until);
+                if (!out.outOfRange)
+                {
+                    out.entries.push_back(std::move(*r.entry));
+                }
+            }
+            else if (!out.outOfRange)
+            {
+                out.malformed.push_back({out.entries.size(), std::move(r.error)});
+            }
+        }
+
         std::optional<Core::LogEntry> LogParser::parseNext(FileReader &reader) const
         {
-            auto lineOpt = reader.nextLine();
+            auto lineOpt = reader.nextLineView();
             if (!lineOpt)
             {
                 return std::nullopt;
@@ -107,14 +141,24 @@ LogParser::LogParser()
             return parseLine(*lineOpt);
         }
 
-        void LogParser::addPattern(std::string pattern)
+        bool LogParser::addPattern(std::string pattern)
         {
+            auto matcher = PatternMatcher::compile(pattern);
+            if (!matcher)
+            {
+                return false;
+            }
             m_patterns.push_back(std::move(pattern));
+            m_matchers.push_back(std::move(*matcher));
+            resetOrder();
+            return true;
         }
 
         void LogParser::clearPatterns()
         {
             m_patterns.clear();
+            m_matchers.clear();
+            m_order.clear();
         }
 
         const std::vector<std::string> &LogParser::patterns() const noexcept
@@ -122,280 +166,201 @@ LogParser::LogParser()
             return m_patterns;
         }
 
-        std::optional<Core::LogEntry> LogParser::tryParsePattern(
-            std::string_view line,
-            std::string_view /*pattern*/) const
+        void LogParser::resetOrder()
         {
-            // Heuristic parsing (robust to format differences)
-            auto timestamp = extractTimestamp(line);
-            auto level     = extractLevel(line);
-            auto source    = extractSource(line);
-            auto message   = extractMessage(line);
-
-            if (!timestamp || !level || !message)
+            m_order.resize(m_matchers.size());
+            for (std::size_t i = 0; i < m_order.size(); ++i)
             {
-                return std::nullopt;
+                m_order[i] = i;
             }
-
-            // NOTE: This constructor call must match your Core::LogEntry API from include/core/LogEntry.hpp.
-            // If your LogEntry uses a different constructor/setters, adjust here accordingly.
-            return Core::LogEntry(timestamp.value(),
-                                  level.value(),
-                                  source.value_or("unknown"),
-                                  std::move(*message),
-                                  std::string(line));
         }
 
-        // -------------------------
-        // JSON parsing (best-effort, no external dependency)
-        // -------------------------
-        std::optional<Core::LogEntry> LogParser::tryParseJsonLine(std::string_view line, std::string* errOut) const
+        std::optional<std::size_t> LogParser::detectFormat(std::string_view sample, std::size_t maxLines)
         {
-            // Expected keys (flexible): timestamp/time/@timestamp, level/severity, service/component/source, message/msg
-            auto tsStr = extractJsonString(line, "timestamp");
-            if (!tsStr) tsStr = extractJsonString(line, "time");
-            if (!tsStr) tsStr = extractJsonString(line, "@timestamp");
-
-            auto lvlStr = extractJsonString(line, "level");
-            if (!lvlStr) lvlStr = extractJsonString(line, "severity");
-
-            auto msgStr = extractJsonString(line, "message");
-            if (!msgStr) msgStr = extractJsonString(line, "msg");
-
-            auto srcStr = extractJsonString(line, "service");
-            if (!srcStr) srcStr = extractJsonString(line, "component");
-            if (!srcStr) srcStr = extractJsonString(line, "source");
-
-            if (!tsStr || !lvlStr || !msgStr)
+            resetOrder();
+            if (m_matchers.empty())
             {
-                if (errOut)
-                {
-                    std::ostringstream oss;
-                    oss << "JSON missing required fields:"
-                        << (tsStr ? "" : " timestamp")
-                        << (lvlStr ? "" : " level")
-                        << (msgStr ? "" : " message");
-                    *errOut = oss.str();
-                }
                 return std::nullopt;
             }
 
-            // Timestamp: accept either ISO-8601 or "YYYY-MM-DD HH:MM:SS" prefix
-            Utils::TimePoint ts;
-            bool okTs = false;
+            // Count, per pattern, the sampled lines it would win in priority order.
+            std::vector<std::size_t> wins(m_matchers.size(), 0);
+            std::size_t pos = 0;
+            std::size_t seen = 0;
+            while (seen < maxLines)
             {
-                std::string_view tsv(*tsStr);
-                // try first 19 chars if contains space format
-                if (tsv.size() >= 19)
-                {
-                    if (auto p = Utils::parseTimestamp(tsv.substr(0, 19)))
-                    {
-                        ts = *p;
-                        okTs = true;
-                    }
-                }
-                if (!okTs)
+                const auto raw = FileReader::nextLineIn(sample, pos);
+                if (!raw)
+                    break;
+                const auto line = trimSv(*raw);
+                if (line.empty() || line.front() == '{')
+                    continue;
+                ++seen;
+
+                const ScannedLine scan = LineScanner::scan(line);
+                for (std::size_t i = 0; i < m_matchers.size(); ++i)
                 {
-                    // Try ISO: "YYYY-MM-DDTHH:MM:SS" (use first 19, replace 'T' with ' ')
-                    if (tsv.size() >= 19)
+                    if (tryParsePattern(scan, m_matchers[i]))
                     {
-                        std::string tmp(tsv.substr(0, 19));
-                        for (char& c : tmp) if (c == 'T') c = ' ';
-                        if (auto p = Utils::parseTimestamp(std::string_view(tmp)))
-                        {
-                            ts = *p;
-                            okTs = true;
-                        }
+                        ++wins[i];
+                        break;
                     }
                 }
             }
-            if (!okTs)
+
+            const auto best = static_cast<std::size_t>(
+                std::max_element(wins.begin(), wins.end()) - wins.begin());
+            if (wins[best] == 0)
             {
-                if (errOut) *errOut = "Invalid timestamp format";
                 return std::nullopt;
             }
 
-            // Level mapping
-            const std::string upperLvl = Utils::toUpper(*lvlStr);
-            Core::LogLevel lvl = Core::LogLevel::Unknown;
-            if (upperLvl.find("TRACE") != std::string::npos) lvl = Core::LogLevel::Trace;
-            else if (upperLvl.find("DEBUG") != std::string::npos) lvl = Core::LogLevel::Debug;
-            else if (upperLvl.find("INFO") != std::string::npos) lvl = Core::LogLevel::Info;
-            else if (upperLvl.find("WARN") != std::string::npos) lvl = Core::LogLevel::Warn;
-            else if (upperLvl.find("ERROR") != std::string::npos) lvl = Core::LogLevel::Error;
-            else if (upperLvl.find("CRIT") != std::string::npos || upperLvl.find("FATAL") != std::string::npos) lvl = Core::LogLevel::Critical;
-
-            return Core::LogEntry(ts, lvl, srcStr ? std::optional<std::string>(*srcStr) : std::optional<std::string>("unknown"), *msgStr, std::string(line));
+            std::rotate(m_order.begin(), m_order.begin() + static_cast<std::ptrdiff_t>(best),
+                        m_order.begin() + static_cast<std::ptrdiff_t>(best) + 1);
+            return best;
         }
 
-        std::string_view LogParser::trimSv(std::string_view s)
-        {
-            while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front()))) s.remove_prefix(1);
-            while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back()))) s.remove_suffix(1);
-            return s;
-        }
-
-        std::optional<std::string> LogParser::extractJsonRaw(std::string_view json, std::string_view key)
+        std::optional<Core::LogEntry> LogParser::tryParsePattern(
+            const ScannedLine &scan,
+            const PatternMatcher &matcher) const
         {
-            // Find "key" : ... (very small best-effort parser)
-            const std::string needle = std::string("\"") + std::string(key) + "\"";
-            auto pos = json.find(needle);
-            if (pos == std::string_view::npos) return std::nullopt;
-            pos = json.find(':', pos + needle.size());
-            if (pos == std::string_view::npos) return std::nullopt;
-            ++pos;
-            while (pos < json.size() && std::isspace(static_cast<unsigned char>(json[pos]))) ++pos;
-            if (pos >= json.size()) return std::nullopt;
-
-            // If string value
-            if (json[pos] == '"')
+            PatternMatcher::Fields f;
+            if (!matcher.match(scan, f))
             {
-                ++pos;
-                std::string out;
-                while (pos < json.size())
-                {
-                    const char c = json[pos++];
-                    if (c == '\\')
-                    {
-                        if (pos < json.size())
-                        {
-                            // basic escape handling
-                            out.push_back(json[pos++]);
-                        }
-                        continue;
-                    }
-                    if (c == '"') break;
-                    out.push_back(c);
-                }
-                return out;
+                return std::nullopt;
             }
 
-            // Non-string: read until comma or end brace
-            std::size_t end = pos;
-            while (end < json.size() && json[end] != ',' && json[end] != '}') ++end;
-            std::string out(json.substr(pos, end - pos));
-            // trim
-            std::string_view sv(out);
-            sv = trimSv(sv);
-            return std::string(sv);
-        }
-
-        std::optional<std::string> LogParser::extractJsonString(std::string_view json, std::string_view key)
-        {
-            return extractJsonRaw(json, key);
-        }
-
-        std::optional<Utils::TimePoint> LogParser::extractTimestamp(std::string_view line) const
-        {
-            std::string_view prefix = Utils::ltrim(line);
-            if (prefix.size() < 19)
+            // Cheap checks first: the level lookup never allocates.
+            const auto level = LineScanner::levelFromToken(f.level);
+            if (!level)
             {
                 return std::nullopt;
             }
-
-            // Try "YYYY-MM-DD HH:MM:SS" at start (first 19 chars)
-            if (auto tp = Utils::parseTimestamp(prefix.substr(0, 19)))
+            const auto timestamp = extractTimestamp(f.timestamp);
+            if (!timestamp)
             {
-                return tp;
+                return std::nullopt;
             }
 
-            // TODO: add more formats if needed
-            return std::nullopt;
+            // The source is interned straight from the line and the text is copied
+            // into the thread's arena, so a parsed line costs no allocation.
+            return Core::LogEntry(*timestamp,
+                                  *level,
+                                  Core::SourceTable::global().intern(f.source.empty() ? "unknown" : f.source),
+                                  f.message,
+                                  m_keepRawLines ? std::optional<std::string_view>(scan.line) : std::nullopt,
+                                  threadArena());
         }
 
-        std::optional<Core::LogLevel> LogParser::extractLevel(std::string_view line) const
+        // -------------------------
+        // JSON parsing (best-effort, no external dependency)
+        // -------------------------
+        std::optional<Core::LogEntry> LogParser::tryParseJsonLine(std::string_view line, std::string* errOut) const
         {
-            // FIXED: enum values match include/core/LogEntry.hpp:
-            // Trace, Debug, Info, Warn, Error, Critical, Unknown
-            static const struct
+            // Expected keys (flexible), in preference order per field:
+            // timestamp/time/@timestamp, level/severity, message/msg, service/component/source
+            static constexpr std::string_view kKeys[] = {
+                "timestamp", "time", "@timestamp",
+                "level", "severity",
+                "message", "msg",
+                "service", "component", "source"};
+            constexpr std::size_t kKeyCount = sizeof(kKeys) / sizeof(kKeys[0]);
+
+            // One structural pass resolves every key (best effort on malformed objects).
+            JsonScanner::Value v[kKeyCount];
+            JsonScanner::scanObject(line, kKeys, kKeyCount, v);
+
+            auto pick = [&v](std::size_t first, std::size_t last) -> const JsonScanner::Value *
             {
-                std::string_view levelStr;
-                Core::LogLevel level;
-            } levelMap[] = {
-                {"TRACE",    Core::LogLevel::Trace},
-                {"DEBUG",    Core::LogLevel::Debug},
-                {"INFO",     Core::LogLevel::Info},
-                {"WARN",     Core::LogLevel::Warn},
-                {"WARNING",  Core::LogLevel::Warn},
-                {"ERROR",    Core::LogLevel::Error},
-                {"FATAL",    Core::LogLevel::Critical},
-                {"CRITICAL", Core::LogLevel::Critical},
+                for (std::size_t i = first; i <= last; ++i)
+                {
+                    if (v[i].found)
+                        return &v[i];
+                }
+                return nullptr;
             };
+            const JsonScanner::Value *tsVal  = pick(0, 2);
+            const JsonScanner::Value *lvlVal = pick(3, 4);
+            const JsonScanner::Value *msgVal = pick(5, 6);
+            const JsonScanner::Value *srcVal = pick(7, 9);
 
-            // IMPORTANT: Utils::toUpper likely returns std::string.
-            // Keep it alive to avoid dangling references.
-            const std::string upperLine = Utils::toUpper(line);
-
-            for (const auto &mapping : levelMap)
+            if (!tsVal || !lvlVal || !msgVal)
             {
-                if (Utils::contains(upperLine, mapping.levelStr))
+                if (errOut)
                 {
-                    return mapping.level;
+                    std::ostringstream oss;
+                    oss << "JSON missing required fields:"
+                        << (tsVal ? "" : " timestamp")
+                        << (lvlVal ? "" : " level")
+                        << (msgVal ? "" : " message");
+                    *errOut = oss.str();
                 }
+                return std::nullopt;
             }
 
-            return Core::LogLevel::Unknown; // default if not detected
-        }
-
-        std::optional<std::string> LogParser::extractSource(std::string_view line) const
-        {
-            std::string_view trimmed = Utils::trim(line);
-
-            // Pattern 1: source: message
-            auto colonPos = trimmed.find(':');
-            if (colonPos != std::string_view::npos)
+            // Timestamp: log/ISO-8601 text (with optional fraction and zone) or epoch number
+            const auto ts = Utils::parseLogTimestamp(tsVal->raw);
+            if (!ts)
             {
-                std::string_view potentialSource = Utils::rtrim(trimmed.substr(0, colonPos));
-                if (potentialSource.find(' ') == std::string_view::npos)
-                {
-                    return std::string(potentialSource);
-                }
+                if (errOut) *errOut = "Invalid timestamp format";
+                return std::nullopt;
             }
 
-            // Pattern 2: [source]
-            if (auto start = trimmed.find('['); start != std::string_view::npos)
+            // Level mapping (substring match, case-insensitive, no allocation)
+            auto has = [lv = lvlVal->raw](std::string_view word)
             {
-                auto end = trimmed.find(']', start);
-                if (end != std::string_view::npos)
+                for (std::size_t i = 0; i + word.size() <= lv.size(); ++i)
                 {
-                    return std::string(trimmed.substr(start + 1, end - start - 1));
+                    if (Utils::iequals(lv.substr(i, word.size()), word))
+                        return true;
                 }
+                return false;
+            };
+            Core::LogLevel lvl = Core::LogLevel::Unknown;
+            if (has("TRACE")) lvl = Core::LogLevel::Trace;
+            else if (has("DEBUG")) lvl = Core::LogLevel::Debug;
+            else if (has("INFO")) lvl = Core::LogLevel::Info;
+            else if (has("WARN")) lvl = Core::LogLevel::Warn;
+            else if (has("ERROR")) lvl = Core::LogLevel::Error;
+            else if (has("CRIT") || has("FATAL")) lvl = Core::LogLevel::Critical;
+
+            // Intern the source straight from the line unless it needs unescaping.
+            auto &sources = Core::SourceTable::global();
+            const Core::SourceId source = !srcVal             ? sources.intern("unknown")
+                                          : srcVal->hasEscapes ? sources.intern(JsonScanner::decode(*srcVal))
+                                                               : sources.intern(srcVal->raw);
+
+            // Unescaped messages are views into the line; escaped ones are decoded
+            // into a reused scratch buffer. Either way the arena takes the copy.
+            std::string_view message = msgVal->raw;
+            if (msgVal->isString && msgVal->hasEscapes)
+            {
+                thread_local std::string scratch;
+                scratch.clear();
+                JsonScanner::appendUnescaped(msgVal->raw, scratch);
+                message = scratch;
             }
 
-            return std::nullopt;
+            return Core::LogEntry(*ts,
+                                  lvl,
+                                  source,
+                                  message,
+                                  m_keepRawLines ? std::optional<std::string_view>(line) : std::nullopt,
+                                  threadArena());
         }
 
-        std::optional<std::string> LogParser::extractMessage(std::string_view line) const
+        std::string_view LogParser::trimSv(std::string_view s)
         {
-            std::string message;
-
-            // Skip timestamp prefix (first ~20 chars)
-            std::string_view remaining = Utils::trim(line);
-            if (remaining.size() > 20)
-            {
-                remaining.remove_prefix(20);
-            }
-
-            // Skip level + maybe source
-            remaining = Utils::trim(remaining);
-            std::vector<std::string_view> words = Utils::split(remaining, ' ', true);
-
-            if (words.size() > 2)
-            {
-                message.reserve(remaining.size());
-                for (std::size_t i = 2; i < words.size(); ++i)
-                {
-                    if (i > 2) message += ' ';
-                    message.append(words[i]);
-                }
-            }
-
-            if (message.empty())
-            {
-                return std::nullopt;
-            }
+            while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front()))) s.remove_prefix(1);
+            while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back()))) s.remove_suffix(1);
+            return s;
+        }
 
-            return message; // NRVO/move
+        std::optional<Utils::TimePoint> LogParser::extractTimestamp(std::string_view field) const
+        {
+            // PatternMatcher sliced exactly one timestamp (Utils::timestampLength), so the
+            // whole field must convert; out-of-range dates are rejected here.
+            return Utils::parseLogTimestamp(field);
         }
 
     } // namespace Input
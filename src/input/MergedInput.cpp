@@ -0,0 +1,340 @@
+#include "input/MergedInput.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+#include "input/FileReader.hpp"
+#include "utils/Logger.hpp"
+#include "utils/ThreadPool.hpp"
+
+namespace LogTool
+{
+    namespace Input
+    {
+        namespace
+        {
+            using Batch = std::shared_ptr<LogParser::ParsedBatch>;
+            using TimePoint = core::LogEntry::TimePoint;
+            constexpr std::size_t kBatchLines = core::EntryBatch::kDefaultCapacity;
+
+            /// Open 'path' the way the merge reads it, with 'parser' set to its format.
+            bool openFile(const std::string &path, FileReader &reader, LogParser &parser)
+            {
+                if (!reader.open(path, FileReader::Mode::Mapped))
+                    return false;
+                if (reader.mode() == FileReader::Mode::Mapped)
+                    parser.detectFormat(reader.mappedData());
+                return true;
+            }
+
+            /**
+             * Where the merge has to start reading 'path': the timestamp of its
+             * first entry, or the very beginning when malformed lines come
+             * first (they follow whatever entry the merge emitted last) or the
+             * file has no entries at all.
+             */
+            TimePoint firstTimestamp(const LogParser &templateParser, const std::string &path)
+            {
+                FileReader reader;
+                LogParser parser(templateParser);
+                if (!openFile(path, reader, parser))
+                    throw std::runtime_error("Cannot open input file: " + path);
+
+                LogParser::ParsedBatch batch;
+                while (const auto line = reader.nextLineView())
+                {
+                    if (line->empty())
+                        continue;
+                    parser.parseInto(*line, batch);
+                    if (!batch.malformed.empty())
+                        break;
+                    if (!batch.entries.empty())
+                        return batch.entries.timestamps().front();
+                }
+                return TimePoint::min();
+            }
+
+            /**
+             * The parsing side of the merge: files are parsed a batch at a
+             * time by tasks on a shared pool, each file at most 'depth'
+             * batches ahead of the merge. Only files that were activated are
+             * open; a file releases its reader and parser once exhausted.
+             */
+            class FileParsers
+            {
+            public:
+                FileParsers(const LogParser &parser, const std::vector<std::string> &paths,
+                            std::size_t depth, std::size_t threads)
+                    : m_parser(parser), m_files(paths.size()), m_depth(depth), m_pool(threads)
+                {
+                    for (std::size_t i = 0; i < paths.size(); ++i)
+                        m_files[i].path = paths[i];
+                }
+
+                /// Let in-flight tasks finish without scheduling new ones.
+                ~FileParsers()
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_stopping = true;
+                    m_cv.wait(lock, [this]() { return m_busy == 0; });
+                }
+
+                Utils::ThreadPool &pool() noexcept { return m_pool; }
+
+                /// Start parsing file 'i' ahead of the merge.
+                void activate(std::size_t i)
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    scheduleLocked(i);
+                }
+
+                /// Next parsed batch of file 'i' (waits for it); false once the file is exhausted.
+                bool next(std::size_t i, Batch &out)
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    File &file = m_files[i];
+                    m_cv.wait(lock, [&]() { return !file.ready.empty() || file.done || m_error; });
+                    if (m_error)
+                        std::rethrow_exception(m_error);
+                    if (file.ready.empty())
+                        return false;
+                    out = std::move(file.ready.front());
+                    file.ready.pop_front();
+                    scheduleLocked(i);
+                    return true;
+                }
+
+            private:
+                struct File
+                {
+                    std::string                path;
+                    FileReader                 reader; // open while the file is being parsed
+                    std::unique_ptr<LogParser> parser; // likewise
+                    std::deque<Batch>          ready;  // parsed, not yet merged
+                    bool                       queued = false; // a parse task is pending or running
+                    bool                       done   = false; // every line has been parsed
+                };
+
+                /// Queue the next batch of file 'i' if it is not already ahead by 'depth'.
+                void scheduleLocked(std::size_t i)
+                {
+                    File &file = m_files[i];
+                    if (file.queued || file.done || m_stopping || file.ready.size() >= m_depth)
+                        return;
+                    file.queued = true;
+                    ++m_busy;
+                    m_pool.submit([this, i]() { parseBatch(i); });
+                }
+
+                /// Pool task: parse one batch of file 'i'.
+                void parseBatch(std::size_t i)
+                {
+                    File &file = m_files[i];
+                    auto batch = std::make_shared<LogParser::ParsedBatch>();
+                    bool end = false;
+                    std::exception_ptr error;
+                    try
+                    {
+                        if (!file.parser)
+                        {
+                            file.parser = std::make_unique<LogParser>(m_parser);
+                            if (!openFile(file.path, file.reader, *file.parser))
+                                throw std::runtime_error("Cannot open input file: " + file.path);
+                        }
+                        batch->entries.reserve(kBatchLines);
+                        while (batch->lineCount() < kBatchLines)
+                        {
+                            const auto line = file.reader.nextLineView();
+                            if (!line)
+                            {
+                                end = true;
+                                break;
+                            }
+                            if (!line->empty())
+                                file.parser->parseInto(*line, *batch);
+                        }
+                        if (end)
+                        {
+                            file.reader.close();
+                            file.parser.reset();
+                        }
+                    }
+                    catch (...)
+                    {
+                        error = std::current_exception();
+                        end = true;
+                    }
+
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (batch->lineCount() > 0)
+                        file.ready.push_back(std::move(batch));
+                    if (error && !m_error)
+                        m_error = error;
+                    file.done = end;
+                    file.queued = false;
+                    --m_busy;
+                    scheduleLocked(i);
+                    m_cv.notify_all();
+                }
+
+                const LogParser   &m_parser;
+                std::vector<File>  m_files;
+                std::size_t        m_depth;
+
+                std::mutex              m_mutex; // guards the queue state of every file
+                std::condition_variable m_cv;
+                std::size_t             m_busy = 0;
+                bool                    m_stopping = false;
+                std::exception_ptr      m_error;
+
+                Utils::ThreadPool m_pool; // last: its workers are joined before the files go
+            };
+        } // namespace
+
+        MergedInput::MergedInput(const LogParser &parser,
+                                 std::vector<std::string> paths,
+                                 std::size_t queueDepth,
+                                 std::size_t threads)
+            : m_parser(parser),
+              m_paths(std::move(paths)),
+              m_queueDepth(std::max<std::size_t>(queueDepth, 1)),
+              m_threads(Utils::ThreadPool::resolveThreadCount(threads))
+        {
+        }
+
+        bool MergedInput::open()
+        {
+            bool ok = true;
+            m_totalBytes = 0;
+            for (const auto &path : m_paths)
+            {
+                if (!std::ifstream(path, std::ios::binary).is_open())
+                {
+                    Utils::getLogger().error("Cannot open input file: " + path);
+                    ok = false;
+                }
+                std::error_code ec;
+                const auto size = std::filesystem::file_size(path, ec);
+                if (!ec)
+                    m_totalBytes += static_cast<std::uint64_t>(size);
+            }
+            return ok;
+        }
+
+        void MergedInput::run(const Consumer &consume)
+        {
+            const std::size_t k = m_paths.size();
+            FileParsers parsers(m_parser, m_paths, m_queueDepth, std::min(m_threads, std::max<std::size_t>(k, 1)));
+
+            // Where each file joins the merge, found in parallel.
+            std::vector<TimePoint> starts(k);
+            {
+                std::vector<std::future<TimePoint>> probes;
+                probes.reserve(k);
+                for (const auto &path : m_paths)
+                    probes.push_back(parsers.pool().submit([this, &path]() { return firstTimestamp(m_parser, path); }));
+                for (std::size_t i = 0; i < k; ++i)
+                    starts[i] = probes[i].get();
+            }
+
+            struct Cursor
+            {
+                Batch       batch;
+                std::size_t entry     = 0; // next entry of 'batch'
+                std::size_t malformed = 0; // next malformed line of 'batch'
+            };
+            std::vector<Cursor> cursors(k);
+            std::vector<bool>   active(k, false);
+
+            LogParser::ParsedBatch out;
+            out.entries.reserve(kBatchLines);
+            auto flushIfFull = [&]()
+            {
+                if (out.lineCount() >= kBatchLines)
+                {
+                    consume(out);
+                    out.clear();
+                }
+            };
+
+            // Move file i to its next entry, passing on the malformed lines before
+            // it; false once the file is exhausted.
+            auto advance = [&](std::size_t i) -> bool
+            {
+                Cursor &c = cursors[i];
+                for (;;)
+                {
+                    if (c.batch)
+                    {
+                        auto &bad = c.batch->malformed;
+                        for (; c.malformed < bad.size() && bad[c.malformed].position <= c.entry; ++c.malformed)
+                        {
+                            out.malformed.push_back({out.entries.size(), std::move(bad[c.malformed].error)});
+                            flushIfFull();
+                        }
+                        if (c.entry < c.batch->entries.size())
+                            return true;
+                    }
+                    c = Cursor{};
+                    if (!parsers.next(i, c.batch))
+                        return false;
+                }
+            };
+            auto headTime = [&](std::size_t i) { return cursors[i].batch->entries.timestamps()[cursors[i].entry]; };
+
+            // Min-heap of (timestamp of the file's next entry, file index). A file
+            // that is not active yet sits there with its first timestamp, which
+            // is exactly the head it will have once opened.
+            using Head = std::pair<TimePoint, std::size_t>;
+            std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heap;
+            for (std::size_t i = 0; i < k; ++i)
+                heap.emplace(starts[i], i);
+
+            while (!heap.empty())
+            {
+                const std::size_t i = heap.top().second;
+                heap.pop();
+
+                if (!active[i])
+                {
+                    active[i] = true;
+                    parsers.activate(i);
+                    if (advance(i))
+                        heap.emplace(headTime(i), i);
+                    continue;
+                }
+
+                // Take entries from file i while it stays ahead of every other file:
+                // runs are long (rotated siblings do not overlap), so the heap is
+                // touched once per run rather than once per entry.
+                bool more = true;
+                do
+                {
+                    Cursor &c = cursors[i];
+                    out.entries.push_back(c.batch->entries[c.entry]);
+                    ++c.entry;
+                    flushIfFull();
+                    more = advance(i);
+                } while (more && (heap.empty() || Head(headTime(i), i) < heap.top()));
+
+                if (more)
+                    heap.emplace(headTime(i), i);
+            }
+
+            if (out.lineCount() > 0)
+                consume(out);
+        }
+
+    } // namespace Input
+} // namespace LogTool
@@ -0,0 +1,101 @@
+#include "input/ParallelParser.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <future>
+
+#include "input/FileReader.hpp"
+
+namespace LogTool
+{
+    namespace Input
+    {
+        ParallelParser::ParallelParser(const LogParser &parser,
+                                       std::size_t threads,
+                                       std::size_t chunkBytes)
+            : m_parser(parser),
+              m_chunkBytes(std::max<std::size_t>(chunkBytes, 4096)),
+              m_pool(threads)
+        {
+        }
+
+        std::vector<std::string_view> ParallelParser::splitRanges(std::string_view data,
+                                                                  std::size_t chunkBytes)
+        {
+            std::vector<std::string_view> ranges;
+            if (data.empty())
+            {
+                return ranges;
+            }
+
+            chunkBytes = std::max<std::size_t>(chunkBytes, 1);
+            ranges.reserve(data.size() / chunkBytes + 1);
+
+            std::size_t begin = 0;
+            while (begin < data.size())
+            {
+                std::size_t end = std::min(data.size(), begin + chunkBytes);
+                if (end < data.size())
+                {
+                    // Extend to the next newline so the range ends on a line boundary.
+                    const std::size_t nl = data.find('\n', end - 1);
+                    end = (nl == std::string_view::npos) ? data.size() : nl + 1;
+                }
+                ranges.push_back(data.substr(begin, end - begin));
+                begin = end;
+            }
+            return ranges;
+        }
+
+        void ParallelParser::parse(std::string_view data, const Consumer &consume)
+        {
+            using Results = LogParser::ParsedBatch;
+
+            const auto ranges = splitRanges(data, m_chunkBytes);
+
+            // Keep every worker busy while the consumer drains the oldest range.
+            const std::size_t lookahead = m_pool.size() * 2;
+
+            std::deque<std::future<Results>> inFlight;
+            std::size_t next = 0;
+
+            auto submitNext = [&]() {
+                const std::string_view range = ranges[next++];
+                const std::size_t offset = static_cast<std::size_t>(range.data() - data.data());
+                inFlight.push_back(m_pool.submit([this, range, offset]() {
+                    Results out;
+                    out.entries.reserve(range.size() / 64);
+                    out.inputBegin = offset;
+                    out.inputEnd   = offset + range.size();
+                    std::size_t pos = 0;
+                    while (const auto line = FileReader::nextLineIn(range, pos))
+                    {
+                        if (line->empty())
+                            continue;
+                        m_parser.parseInto(*line, out);
+                    }
+                    return out;
+                }));
+            };
+
+            while (next < ranges.size() && inFlight.size() < lookahead)
+            {
+                submitNext();
+            }
+
+            while (!inFlight.empty())
+            {
+                Results results = inFlight.front().get();
+                inFlight.pop_front();
+
+                if (next < ranges.size())
+                {
+                    submitNext();
+                }
+
+                consume(results);
+            }
+        }
+
+    } // namespace Input
+} // namespace LogTool
@@ -0,0 +1,185 @@
+#include "input/PatternMatcher.hpp"
+
+namespace LogTool
+{
+    namespace Input
+    {
+        std::optional<PatternMatcher> PatternMatcher::compile(std::string_view pattern)
+        {
+            PatternMatcher m;
+            m.m_pattern = std::string(pattern);
+
+            bool haveTimestamp = false;
+            auto appendLiteral = [&m](char c)
+            {
+                if (m.m_tokens.empty() || m.m_tokens.back().kind != TokenKind::Literal)
+                {
+                    m.m_tokens.push_back({TokenKind::Literal, std::string()});
+                }
+                m.m_tokens.back().text.push_back(c);
+            };
+
+            for (std::size_t i = 0; i < pattern.size(); ++i)
+            {
+                const char c = pattern[i];
+
+                if (!m.m_tokens.empty() && m.m_tokens.back().kind == TokenKind::Message)
+                {
+                    // %message% swallows the rest of the line; nothing may follow it.
+                    return std::nullopt;
+                }
+
+                if (c == '\\' && i + 1 < pattern.size())
+                {
+                    appendLiteral(pattern[++i]);
+                }
+                else if (c == ' ')
+                {
+                    if (m.m_tokens.empty() || m.m_tokens.back().kind != TokenKind::Space)
+                    {
+                        m.m_tokens.push_back({TokenKind::Space, std::string()});
+                    }
+                }
+                else if (c == '%')
+                {
+                    const auto close = pattern.find('%', i + 1);
+                    if (close == std::string_view::npos)
+                    {
+                        return std::nullopt;
+                    }
+                    const auto name = pattern.substr(i + 1, close - i - 1);
+                    TokenKind kind;
+                    if (name == "timestamp")      kind = TokenKind::Timestamp;
+                    else if (name == "level")     kind = TokenKind::Level;
+                    else if (name == "source")    kind = TokenKind::Source;
+                    else if (name == "message")   kind = TokenKind::Message;
+                    else return std::nullopt;
+
+                    haveTimestamp = haveTimestamp || kind == TokenKind::Timestamp;
+                    m.m_tokens.push_back({kind, std::string()});
+                    i = close;
+                }
+                else
+                {
+                    appendLiteral(c);
+                }
+            }
+
+            if (!haveTimestamp)
+            {
+                return std::nullopt;
+            }
+
+            // "%timestamp% %level% ..." can reuse LineScanner's prefix scan.
+            m.m_scanPrefix = m.m_tokens.size() > 4 &&
+                             m.m_tokens[0].kind == TokenKind::Timestamp &&
+                             m.m_tokens[1].kind == TokenKind::Space &&
+                             m.m_tokens[2].kind == TokenKind::Level &&
+                             m.m_tokens[3].kind == TokenKind::Space;
+            return m;
+        }
+
+        bool PatternMatcher::match(const ScannedLine &scan, Fields &out) const
+        {
+            if (!m_scanPrefix)
+            {
+                return matchFrom(scan.line, 0, 0, Fields{}, out);
+            }
+            if (!scan.hasPrefix())
+            {
+                return false;
+            }
+
+            Fields f;
+            f.timestamp = scan.timestamp;
+            f.level     = scan.level;
+            return matchFrom(scan.line, scan.bodyBegin, 4, f, out);
+        }
+
+        bool PatternMatcher::matchFrom(std::string_view line,
+                                       std::size_t pos,
+                                       std::size_t firstToken,
+                                       Fields f,
+                                       Fields &out) const
+        {
+            for (std::size_t t = firstToken; t < m_tokens.size(); ++t)
+            {
+                const Token &tok = m_tokens[t];
+                const std::string_view rest = line.substr(pos);
+
+                switch (tok.kind)
+                {
+                case TokenKind::Literal:
+                    if (rest.compare(0, tok.text.size(), tok.text) != 0)
+                        return false;
+                    pos += tok.text.size();
+                    break;
+
+                case TokenKind::Space:
+                {
+                    std::size_t n = 0;
+                    while (n < rest.size() && LineScanner::isSpace(rest[n])) ++n;
+                    if (n == 0)
+                        return false;
+                    pos += n;
+                    break;
+                }
+
+                case TokenKind::Timestamp:
+                {
+                    const std::size_t n = LineScanner::matchTimestamp(rest);
+                    if (n == 0)
+                        return false;
+                    f.timestamp = rest.substr(0, n);
+                    pos += n;
+                    break;
+                }
+
+                case TokenKind::Level:
+                {
+                    const std::size_t n = LineScanner::matchLevel(rest, f.level);
+                    if (n == 0)
+                        return false;
+                    pos += n;
+                    break;
+                }
+
+                case TokenKind::Source:
+                {
+                    // Runs until whitespace or the first character of the next literal.
+                    const char stop = (t + 1 < m_tokens.size() && m_tokens[t + 1].kind == TokenKind::Literal)
+                                          ? m_tokens[t + 1].text.front()
+                                          : '\0';
+                    std::size_t e = 0;
+                    while (e < rest.size() && !LineScanner::isSpace(rest[e]) && rest[e] != stop) ++e;
+                    const auto src = rest.substr(0, e);
+                    if (src.empty() || src == "-")
+                        return false;
+                    f.source = src;
+                    pos += e;
+                    break;
+                }
+
+                case TokenKind::Message:
+                {
+                    std::size_t e = rest.size();
+                    while (e > 0 && LineScanner::isSpace(rest[e - 1])) --e;
+                    if (e == 0)
+                        return false;
+                    f.message = rest.substr(0, e);
+                    pos = line.size();
+                    break;
+                }
+                }
+            }
+
+            if (pos != line.size())
+            {
+                return false;
+            }
+            out = f;
+            return true;
+        }
+
+    } // namespace Input
+} // namespace LogTool
@@ -0,0 +1,380 @@
+#include "input/TimeIndex.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include "core/StateCodec.hpp"
+#include "input/Checkpoint.hpp"
+#include "input/FileReader.hpp"
+#include "utils/Logger.hpp"
+
+namespace LogTool
+{
+    namespace Input
+    {
+        namespace
+        {
+            constexpr std::string_view kMagic = "LOGTOOL-INDEX";
+            constexpr std::uint32_t    kVersion = 1;
+            constexpr std::uint32_t    kByteOrderMark = 0x01020304u; // native order check
+
+            // searchSorted(): timestamps sampled to check the order, lines tried
+            // per probe, and the byte distance at which the search stops.
+            constexpr std::size_t kOrderSamples = 64;
+            constexpr std::size_t kProbeLines   = 64;
+            constexpr std::size_t kResolution   = 64 * 1024;
+        } // namespace
+
+        // -------------------------
+        // Builder
+        // -------------------------
+        TimeIndex::Builder::Builder(std::uint64_t blockBytes)
+            : m_blockBytes(std::max<std::uint64_t>(blockBytes, 4096))
+        {
+        }
+
+        void TimeIndex::Builder::add(std::uint64_t begin, std::string_view text, const LogParser::ParsedBatch &batch)
+        {
+            // Walk the lines as the parser did: every non-empty line became the
+            // next entry or, where a malformed line sits, the next malformed line.
+            const auto &times = batch.entries.timestamps();
+            const auto &malformed = batch.malformed;
+            std::size_t entry = 0;
+            std::size_t bad = 0;
+            std::size_t pos = 0;
+            while (pos < text.size())
+            {
+                const std::size_t lineBegin = pos;
+                const auto line = FileReader::nextLineIn(text, pos);
+                if (!line)
+                    break;
+
+                const TimePoint *time = nullptr;
+                if (!line->empty())
+                {
+                    if (bad < malformed.size() && malformed[bad].position <= entry)
+                        ++bad;
+                    else if (entry < times.size())
+                        time = &times[entry++];
+                }
+                addLine(begin + lineBegin, begin + pos, time);
+            }
+        }
+
+        void TimeIndex::Builder::addLine(std::uint64_t begin, std::uint64_t end, const TimePoint *time)
+        {
+            if (!m_open || m_blocks.back().end - m_blocks.back().begin >= m_blockBytes)
+            {
+                closeBlock();
+                m_blocks.push_back(Block{begin, end, {}, {}});
+                m_open = true;
+                m_hasTime = false;
+
+                // The parser keeps or drops malformed lines by the last entry
+                // before them, so a block starting with such lines covers that
+                // entry's time as well.
+                if (!time && m_lastTime)
+                {
+                    m_blocks.back().minTs = m_blocks.back().maxTs = *m_lastTime;
+                    m_hasTime = true;
+                }
+            }
+
+            Block &block = m_blocks.back();
+            block.end = end;
+            if (time)
+            {
+                block.minTs = m_hasTime ? std::min(block.minTs, *time) : *time;
+                block.maxTs = m_hasTime ? std::max(block.maxTs, *time) : *time;
+                m_hasTime = true;
+                m_lastTime = *time;
+            }
+        }
+
+        void TimeIndex::Builder::closeBlock()
+        {
+            // Only blocks before the first entry of the file can be without a
+            // time; finish() gives them the time of the first block with one.
+            if (m_open && !m_hasTime)
+                m_blocks.back().minTs = TimePoint::max();
+        }
+
+        TimeIndex TimeIndex::Builder::finish(std::string_view data)
+        {
+            closeBlock();
+
+            TimeIndex index;
+            index.m_blocks = std::move(m_blocks);
+            index.m_covered = data.size();
+            index.m_fingerprint = Checkpoint::fingerprintAt(data, data.size());
+
+            // Give the entry-less blocks at the start of the file the time of the
+            // first block with entries, so they never break the order.
+            auto &blocks = index.m_blocks;
+            const auto timed = [](const Block &b) { return b.minTs != TimePoint::max(); };
+            const auto firstTimed = std::find_if(blocks.begin(), blocks.end(), timed);
+            TimePoint last = firstTimed != blocks.end() ? firstTimed->minTs : TimePoint{};
+            for (auto &b : blocks)
+            {
+                if (!timed(b))
+                    b.minTs = b.maxTs = last;
+                last = b.maxTs;
+            }
+
+            index.m_sorted = true;
+            for (std::size_t i = 1; i < blocks.size(); ++i)
+            {
+                if (blocks[i].minTs < blocks[i - 1].minTs || blocks[i].maxTs < blocks[i - 1].maxTs)
+                {
+                    index.m_sorted = false;
+                    break;
+                }
+            }
+
+            m_blocks.clear();
+            m_open = false;
+            return index;
+        }
+
+        // -------------------------
+        // Persistence
+        // -------------------------
+        bool TimeIndex::save(const std::string &path) const
+        {
+            core::StateWriter out;
+            out.putString(kMagic);
+            out.put(kVersion);
+            out.put(kByteOrderMark);
+            out.put(m_covered);
+            out.put(m_fingerprint);
+            out.put<std::uint8_t>(m_sorted ? 1 : 0);
+            out.putSize(m_blocks.size());
+            for (const auto &b : m_blocks)
+            {
+                out.put(b.begin);
+                out.put(b.end);
+                out.putTime(b.minTs);
+                out.putTime(b.maxTs);
+            }
+
+            const std::string tmp = path + ".tmp";
+            {
+                std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+                if (!f.write(out.bytes().data(), static_cast<std::streamsize>(out.bytes().size())) || !f.flush())
+                {
+                    Utils::getLogger().error("Cannot write index: " + tmp);
+                    return false;
+                }
+            }
+#if defined(_WIN32)
+            std::remove(path.c_str()); // rename() does not replace on Windows
+#endif
+            if (std::rename(tmp.c_str(), path.c_str()) != 0)
+            {
+                Utils::getLogger().error("Cannot replace index: " + path);
+                std::remove(tmp.c_str());
+                return false;
+            }
+            return true;
+        }
+
+        std::optional<TimeIndex> TimeIndex::load(const std::string &path)
+        {
+            std::ifstream f(path, std::ios::binary);
+            if (!f.is_open())
+                return std::nullopt;
+            const std::string bytes((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+
+            try
+            {
+                core::StateReader in(bytes);
+                if (in.getStringView() != kMagic || in.get<std::uint32_t>() != kVersion ||
+                    in.get<std::uint32_t>() != kByteOrderMark)
+                {
+                    Utils::getLogger().warn("Ignoring index from another version: " + path);
+                    return std::nullopt;
+                }
+
+                TimeIndex index;
+                index.m_covered = in.get<std::uint64_t>();
+                index.m_fingerprint = in.get<std::uint64_t>();
+                index.m_sorted = in.get<std::uint8_t>() != 0;
+                for (std::size_t n = in.getSize(); n > 0; --n)
+                {
+                    Block b;
+                    b.begin = in.get<std::uint64_t>();
+                    b.end = in.get<std::uint64_t>();
+                    b.minTs = in.getTime();
+                    b.maxTs = in.getTime();
+                    if (b.begin > b.end || b.end > index.m_covered)
+                        throw std::runtime_error("block out of range");
+                    index.m_blocks.push_back(b);
+                }
+                if (!in.atEnd())
+                    throw std::runtime_error("unexpected trailing data");
+                return index;
+            }
+            catch (const std::exception &ex)
+            {
+                Utils::getLogger().warn("Ignoring damaged index " + path + " (" + ex.what() + ")");
+                return std::nullopt;
+            }
+        }
+
+        bool TimeIndex::matches(std::string_view data) const noexcept
+        {
+            return data.size() >= m_covered && Checkpoint::fingerprintAt(data, m_covered) == m_fingerprint;
+        }
+
+        // -------------------------
+        // Queries
+        // -------------------------
+        std::pair<std::uint64_t, std::uint64_t> TimeIndex::range(std::optional<TimePoint> since,
+                                                                 std::optional<TimePoint> until,
+                                                                 std::uint64_t fileSize) const
+        {
+            const auto endsBefore = [&](const Block &b) { return since && b.maxTs < *since; };
+            const auto startsBefore = [&](const Block &b) { return !until || b.minTs < *until; };
+
+            // Blocks [first, last) can hold matching entries.
+            std::size_t first = m_blocks.size();
+            std::size_t last = 0;
+            if (m_sorted)
+            {
+                first = static_cast<std::size_t>(
+                    std::partition_point(m_blocks.begin(), m_blocks.end(), endsBefore) - m_blocks.begin());
+                last = static_cast<std::size_t>(
+                    std::partition_point(m_blocks.begin(), m_blocks.end(), startsBefore) - m_blocks.begin());
+            }
+            else
+            {
+                for (std::size_t i = 0; i < m_blocks.size(); ++i)
+                {
+                    if (!endsBefore(m_blocks[i]) && startsBefore(m_blocks[i]))
+                    {
+                        first = std::min(first, i);
+                        last = i + 1;
+                    }
+                }
+            }
+
+            std::uint64_t begin = m_covered;
+            std::uint64_t end = m_covered;
+            if (first < last)
+            {
+                begin = m_blocks[first].begin;
+                end = m_blocks[last - 1].end;
+            }
+
+            // Lines appended since the index was built: read them too, unless the
+            // range ends before the latest indexed entry (the log only grows forward).
+            if (fileSize > m_covered)
+            {
+                std::optional<TimePoint> latest;
+                for (const auto &b : m_blocks)
+                    latest = latest ? std::max(*latest, b.maxTs) : b.maxTs;
+                if (!until || !latest || *until > *latest)
+                {
+                    if (first >= last)
+                        begin = m_covered;
+                    end = fileSize;
+                }
+            }
+            return {std::min(begin, fileSize), std::min(end, fileSize)};
+        }
+
+        std::optional<std::pair<std::size_t, std::size_t>> TimeIndex::searchSorted(std::string_view data,
+                                                                                 const LogParser &parser,
+                                                                                 std::optional<TimePoint> since,
+                                                                                 std::optional<TimePoint> until)
+        {
+            const std::size_t size = data.size();
+
+            // Start of the first line at or after 'offset'.
+            const auto lineStartAt = [&](std::size_t offset) -> std::size_t
+            {
+                if (offset == 0 || offset >= size)
+                    return std::min(offset, size);
+                const auto nl = data.find('\n', offset - 1);
+                return nl == std::string_view::npos ? size : nl + 1;
+            };
+
+            // Timestamp of the first parseable line at or after 'offset'.
+            const auto timeAt = [&](std::size_t offset) -> std::optional<TimePoint>
+            {
+                std::size_t pos = lineStartAt(offset);
+                for (std::size_t n = 0; n < kProbeLines; ++n)
+                {
+                    const auto line = FileReader::nextLineIn(data, pos);
+                    if (!line)
+                        break;
+                    if (line->empty())
+                        continue;
+                    if (const auto entry = parser.parseLine(*line))
+                        return entry->timestamp();
+                }
+                return std::nullopt;
+            };
+
+            // Only trust a binary search if evenly spaced samples are in order.
+            std::optional<TimePoint> previous;
+            for (std::size_t i = 0; i < kOrderSamples; ++i)
+            {
+                const auto ts = timeAt(size / kOrderSamples * i);
+                if (!ts)
+                    continue;
+                if (previous && *ts < *previous)
+                    return std::nullopt;
+                previous = ts;
+            }
+            if (!previous)
+                return std::nullopt;
+
+            // Narrow [lo, hi) around the first line at or after 't'. Probes that
+            // find no timestamp go to the side that widens the final range.
+            const auto search = [&](TimePoint t, bool unknownIsBefore)
+            {
+                std::size_t lo = 0, hi = size;
+                while (hi - lo > kResolution)
+                {
+                    const std::size_t mid = lo + (hi - lo) / 2;
+                    const auto ts = timeAt(mid);
+                    if (ts ? *ts < t : unknownIsBefore)
+                        lo = mid;
+                    else
+                        hi = mid;
+                }
+                return std::make_pair(lo, hi);
+            };
+
+            const std::size_t begin = since ? lineStartAt(search(*since, false).first) : 0;
+            const std::size_t end = std::max(begin, until ? lineStartAt(search(*until, true).second) : size);
+
+            // The samples cannot see a few lines out of place (a late write, a
+            // merged file), and the search would silently drop them: check the
+            // lines outside the range and give up if any of them belongs in it.
+            const auto holdsRangeEntry = [&](std::size_t from, std::size_t to)
+            {
+                for (std::size_t pos = from; pos < to;)
+                {
+                    const auto line = FileReader::nextLineIn(data, pos);
+                    if (!line)
+                        break;
+                    if (line->empty())
+                        continue;
+                    const auto entry = parser.parseLine(*line);
+                    if (entry && (!since || entry->timestamp() >= *since) && (!until || entry->timestamp() < *until))
+                        return true;
+                }
+                return false;
+            };
+            if (holdsRangeEntry(0, begin) || holdsRangeEntry(end, size))
+                return std::nullopt;
+            return std::make_pair(begin, end);
+        }
+
+    } // namespace Input
+} // namespace LogTool
@@ -3,57 +3,116 @@
 #include <string>
 #include <optional>
 #include <chrono>
+#include <csignal>
 #include <filesystem>
 #include <limits>
 #include <map>
 #include <iomanip>
 #include <sstream>
 #include <ctime>
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <thread>
+#include <memory>
 
 // Core models
 #include "core/LogEntry.hpp"
 #include "core/Report.hpp"
+#include "core/EntryBatch.hpp"
+#include "core/ResultSink.hpp"
+#include "core/Span.hpp"
 #include "core/Anomaly.hpp"
+#include "core/SourceTable.hpp"
+#include "core/StateCodec.hpp"
 
 // Input
 #include "input/LogParser.hpp"
+#include "input/ParallelParser.hpp"
+#include "input/IngestPipeline.hpp"
+#include "input/FileFollower.hpp"
+#include "input/Checkpoint.hpp"
+#include "input/InputPaths.hpp"
+#include "input/MergedInput.hpp"
+#include "input/Decompressor.hpp"
+#include "input/TimeIndex.hpp"
+#include "input/EntryCache.hpp"
 
 // Utils
 #include "utils/Logger.hpp"
 #include "utils/ConfigLoader.hpp"
+#include "utils/ThreadPool.hpp"
+#include "utils/SpscQueue.hpp"
 
 // Analysis
-#include "analysis/FrequencyAnalyzer.hpp"
-#include "analysis/TimeWindowAnalyzer.hpp"
-#include "analysis/PatternAnalyzer.hpp"
+#include "analysis/TemplateMiner.hpp"
 
 // Anomaly detection
-#include "anomaly/RuleBasedDetector.hpp"
-#include "anomaly/SpikeDetector.hpp"
-#include "anomaly/StatisticalDetector.hpp"
-#include "anomaly/BurstPatternDetector.hpp"
-#include "anomaly/IpFrequencyDetector.hpp"
+#include "anomaly/DetectorPipeline.hpp"
+#include "anomaly/DetectorRegistry.hpp"
 
 // Reporting
 #include "report/ReportGenerator.hpp"
 #include "report/ConsoleReporter.hpp"
 #include "report/JsonReporter.hpp"
 #include "report/CsvReporter.hpp"
+#include "report/AsyncWriter.hpp"
+#include "report/ExportSink.hpp"
 
 // -------------------------
 // CLI
 // -------------------------
 struct CliOptions
 {
-    std::string inputFile;
+    std::vector<std::string> inputs; // files, directories or glob patterns
     std::string configFile = "config/default_config.json";
     std::string outputDir = ".";
     bool verbose = false;
     bool json = false;
     bool csv = false;
     bool graphs = false;
+    std::size_t threads = 1; // parser threads; 0 = hardware concurrency
+    bool pipeline = false;   // staged reader/parser/detector ingestion
+    std::size_t queueDepth = LogTool::Input::IngestPipeline::kDefaultQueueDepth;
+    std::size_t detectorShards = 1; // per-source detector shards; 0 = hardware concurrency
+    std::optional<std::string> detectors; // comma-separated names; overrides the config
+    std::optional<std::size_t> maxPatterns; // pattern detector table size; overrides the config
+    bool listDetectors = false;
+    bool follow = false;                 // keep reading appended lines (tail -F)
+    std::size_t followPollMs = 250;      // longest wait between checks in follow mode
+    std::optional<std::string> checkpointFile; // incremental mode: state saved/restored here
+    std::optional<std::string> since;    // only entries at or after this time
+    std::optional<std::string> until;    // only entries before this time
+    bool writeIndex = false;             // write/refresh the "<log>.idx" time index
+    bool indexCommand = false;           // 'index FILE...': only build the time indexes
+    bool cache = false;                  // replay parsed entries from "<log>.lcache" (written when stale)
 };
 
+// Set by SIGINT/SIGTERM to end --follow.
+static volatile std::sig_atomic_t g_stopRequested = 0;
+
+extern "C" void onStopSignal(int)
+{
+    g_stopRequested = 1;
+}
+
+// "a, b,c" -> {"a", "b", "c"}
+static std::vector<std::string> splitNames(const std::string &list)
+{
+    std::vector<std::string> names;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ','))
+    {
+        const auto first = item.find_first_not_of(" \t");
+        if (first == std::string::npos)
+            continue;
+        const auto last = item.find_last_not_of(" \t");
+        names.push_back(item.substr(first, last - first + 1));
+    }
+    return names;
+}
+
 static CliOptions parseArgs(int argc, char *argv[])
 {
     CliOptions opts;
@@ -88,46 +147,272 @@ static CliOptions parseArgs(int argc, char *argv[])
         {
             opts.graphs = true;
         }
+        else if (arg == "--threads" || arg == "-j")
+        {
+            if (++i < argc)
+            {
+                try
+                {
+                    opts.threads = static_cast<std::size_t>(std::stoul(argv[i]));
+                }
+                catch (...)
+                { /* keep default */
+                }
+            }
+        }
+        else if (arg == "--pipeline")
+        {
+            opts.pipeline = true;
+        }
+        else if (arg == "--queue-depth")
+        {
+            if (++i < argc)
+            {
+                try
+                {
+                    opts.queueDepth = std::max<std::size_t>(1, std::stoul(argv[i]));
+                }
+                catch (...)
+                { /* keep default */
+                }
+            }
+        }
+        else if (arg == "--detector-shards")
+        {
+            if (++i < argc)
+            {
+                try
+                {
+                    opts.detectorShards = static_cast<std::size_t>(std::stoul(argv[i]));
+                }
+                catch (...)
+                { /* keep default */
+                }
+            }
+        }
+        else if (arg == "--max-patterns")
+        {
+            if (++i < argc)
+            {
+                try
+                {
+                    opts.maxPatterns = static_cast<std::size_t>(std::stoul(argv[i]));
+                }
+                catch (...)
+                { /* keep default */
+                }
+            }
+        }
+        else if (arg == "--detectors")
+        {
+            if (++i < argc)
+                opts.detectors = argv[i];
+        }
+        else if (arg == "--follow" || arg == "-f")
+        {
+            opts.follow = true;
+        }
+        else if (arg == "--follow-poll-ms")
+        {
+            if (++i < argc)
+            {
+                try
+                {
+                    opts.followPollMs = std::max<std::size_t>(10, std::stoul(argv[i]));
+                }
+                catch (...)
+                { /* keep default */
+                }
+            }
+        }
+        else if (arg == "--checkpoint")
+        {
+            if (++i < argc)
+                opts.checkpointFile = argv[i];
+        }
+        else if (arg == "--since")
+        {
+            if (++i < argc)
+                opts.since = argv[i];
+        }
+        else if (arg == "--until")
+        {
+            if (++i < argc)
+                opts.until = argv[i];
+        }
+        else if (arg == "--index")
+        {
+            opts.writeIndex = true;
+        }
+        else if (arg == "--cache")
+        {
+            opts.cache = true;
+        }
+        else if (arg == "--list-detectors")
+        {
+            opts.listDetectors = true;
+        }
+        else if (arg == "index" && i == 1)
+        {
+            opts.indexCommand = true;
+        }
         else if (!arg.empty() && arg[0] != '-')
         {
-            opts.inputFile = arg;
+            opts.inputs.push_back(arg);
         }
     }
 
     return opts;
 }
 
+// --since/--until value: a log timestamp, or "YYYY-MM-DD HH:MM" / "YYYY-MM-DD" (local time).
+static std::optional<LogTool::Utils::TimePoint> parseTimeBound(std::string text)
+{
+    if (text.size() == 10 && text[4] == '-')
+        text += " 00:00:00";
+    else if (text.size() == 16 && text[4] == '-')
+        text += ":00";
+    return LogTool::Utils::parseLogTimestamp(text);
+}
+
+// 'index FILE...': build the sidecar time index of every file and exit.
+static int buildTimeIndexes(const std::vector<std::string> &files, std::size_t threads)
+{
+    using LogTool::Input::FileReader;
+    using LogTool::Input::TimeIndex;
+    auto &logger = LogTool::Utils::getLogger();
+
+    int status = 0;
+    for (const auto &file : files)
+    {
+        FileReader reader;
+        if (!reader.open(file, FileReader::Mode::Mapped) || reader.mode() != FileReader::Mode::Mapped)
+        {
+            logger.error("Cannot index " + file + ": needs an uncompressed, memory-mappable file");
+            status = 1;
+            continue;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const std::string_view data = reader.mappedData();
+        LogTool::Input::LogParser parser;
+        parser.detectFormat(data);
+        TimeIndex::Builder builder;
+        LogTool::Input::ParallelParser(parser, threads)
+            .parse(data, [&](LogTool::Input::LogParser::ParsedBatch &batch)
+                   { builder.add(batch.inputBegin, data.substr(batch.inputBegin, batch.inputEnd - batch.inputBegin), batch); });
+        const TimeIndex index = builder.finish(data);
+
+        const std::string path = TimeIndex::sidecarPath(file);
+        if (!index.save(path))
+        {
+            status = 1;
+            continue;
+        }
+        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        std::cout << path << ": " << index.blocks().size() << " blocks over " << data.size() << " bytes"
+                  << (index.sorted() ? "" : " (not in time order)") << ", " << ms << " ms\n";
+    }
+    return status;
+}
+
 static void printUsage(const char *progName)
 {
     std::cout
-        << "Usage: " << progName << " [OPTIONS] input.log\n\n"
+        << "Usage: " << progName << " [OPTIONS] INPUT...\n"
+        << "       " << progName << " index [-j N] FILE...   (write the FILE.idx time indexes)\n\n"
+        << "INPUT is a log file, a directory (the files in it) or a glob pattern such as 'logs/app*.log'.\n"
+        << "Several inputs are parsed in parallel (see -j) and analysed as one stream in timestamp order.\n\n"
         << "OPTIONS:\n"
         << "  -c, --config FILE        Config file (default: config/default_config.json)\n"
         << "  -o, --output DIR         Output directory (default: .)\n"
         << "  -v, --verbose            Verbose logging\n"
         << "  --json                   Export JSON report\n"
         << "  --csv                    Export CSV report\n"
-        << "  --graphs                 Export time-series CSV + Python plotting script\n\n";
+        << "  --graphs                 Export time-series CSV + Python plotting script\n"
+        << "  -j, --threads N          Parse and run detectors with N threads (0 = all cores, default: 1)\n"
+        << "  --pipeline               Overlap reading, parsing, analysis and detection in stages\n"
+        << "  --queue-depth N          Batches in flight between pipeline stages (default: 4)\n"
+        << "  --detector-shards N      Run per-source detectors on N source shards (0 = all cores, default: 1)\n"
+        << "  --detectors LIST         Comma-separated detectors to run (default: all, or 'detectors' in config)\n"
+        << "  --list-detectors         List available detectors and exit\n"
+        << "  --max-patterns N         Patterns the 'pattern' detector tracks, per table: seen once and\n"
+        << "                           repeated (default: 1048576, or 'max_patterns' in config)\n"
+        << "  -f, --follow             Keep following appended lines (rotation-aware) until Ctrl+C\n"
+        << "  --follow-poll-ms N       Longest wait between checks in follow mode (default: 250)\n"
+        << "  --checkpoint FILE        Save the analysis state in FILE; later runs on the grown file\n"
+        << "                           resume from it and only analyse the appended lines\n"
+        << "  --since TIME             Only analyse entries at or after TIME ('YYYY-MM-DD[ HH:MM[:SS]]')\n"
+        << "  --until TIME             Only analyse entries before TIME; with --since, only the part of\n"
+        << "                           the file in range is analysed (via FILE.idx, or a binary search\n"
+        << "                           when the file is in time order; otherwise it is scanned whole)\n"
+        << "  --index                  Write or refresh the FILE.idx time index during the run\n"
+        << "  --cache                  Reuse the entries parsed by an earlier run from FILE.lcache\n"
+        << "                           (written when missing or out of date), skipping the text parse\n\n";
 }
 
 int main(int argc, char *argv[])
 {
     const auto opts = parseArgs(argc, argv);
 
-    if (opts.inputFile.empty())
+    if (opts.listDetectors)
+    {
+        for (const auto &d : LogTool::Anomaly::DetectorRegistry::builtin().entries())
+            std::cout << "  " << std::left << std::setw(12) << d.name << d.description << "\n";
+        return 0;
+    }
+
+    if (opts.inputs.empty())
     {
         std::cerr << "Error: input file required.\n\n";
         printUsage(argv[0]);
         return 1;
     }
 
+    std::vector<std::string> unmatched;
+    const auto inputFiles = LogTool::Input::expandInputPaths(opts.inputs, unmatched);
+    for (const auto &arg : unmatched)
+        std::cerr << "Error: no input files match " << arg << "\n";
+    if (!unmatched.empty() || inputFiles.empty())
+        return 1;
+
+    if (opts.indexCommand)
+        return buildTimeIndexes(inputFiles, LogTool::Utils::ThreadPool::resolveThreadCount(opts.threads));
+
+    // Time range (--since/--until); the end is exclusive.
+    std::optional<LogTool::Utils::TimePoint> since;
+    std::optional<LogTool::Utils::TimePoint> until;
+    if (opts.since && !(since = parseTimeBound(*opts.since)))
+    {
+        std::cerr << "Error: cannot parse --since time: " << *opts.since << "\n";
+        return 1;
+    }
+    if (opts.until && !(until = parseTimeBound(*opts.until)))
+    {
+        std::cerr << "Error: cannot parse --until time: " << *opts.until << "\n";
+        return 1;
+    }
+    const bool timeRange = since || until;
+
+    // More than one file: read them all and merge their entries by timestamp.
+    const bool merged = inputFiles.size() > 1;
+    const std::string &inputFile = inputFiles.front();
+    if (merged && opts.follow)
+    {
+        std::cerr << "Error: --follow takes a single input file.\n";
+        return 1;
+    }
+
     // Logger
     auto &logger = LogTool::Utils::getLogger();
     if (opts.verbose)
         logger.setLevel(LogTool::Utils::LogLevel::DEBUG);
 
     logger.info("Starting Log Analysis Tool");
-    logger.info("Input: " + opts.inputFile);
+    std::string inputList;
+    for (const auto &arg : opts.inputs)
+        inputList += (inputList.empty() ? "" : ", ") + arg;
+    logger.info("Input: " + inputList + (merged ? " (" + std::to_string(inputFiles.size()) + " files)" : ""));
     logger.info("Output dir: " + opts.outputDir);
 
     // Output directory
@@ -139,47 +424,63 @@ int main(int argc, char *argv[])
     { /* ignore */
     }
 
-    // ConfigLoader in your project currently default-constructs.
-    // (You can extend it later with loadFromFile(path).)
+    // Optional key = value config; "detectors = a, b, ..." selects the detectors.
     LogTool::Utils::ConfigLoader config;
+    if (!config.loadFromFile(opts.configFile))
+        logger.debug("No config loaded from " + opts.configFile + "; using defaults");
 
     // Pipeline components
     LogTool::Input::LogParser parser;
 
-    LogTool::Analysis::FrequencyAnalyzer freq;
-    LogTool::Analysis::TimeWindowAnalyzer timeWindow;
-    LogTool::Analysis::PatternAnalyzer pattern;
-
-    LogTool::Anomaly::RuleBasedDetector ruleDetector;
-    LogTool::Anomaly::SpikeDetector spikeDetector;
-    LogTool::Anomaly::StatisticalDetector statDetector;
-    LogTool::Anomaly::BurstPatternDetector burstDetector;
-    LogTool::Anomaly::IpFrequencyDetector ipDetector;
+    // Only the enabled detectors are constructed (all of them by default).
+    LogTool::Anomaly::DetectorPipeline::Options detectorOptions;
+    detectorOptions.detectors = splitNames(opts.detectors ? *opts.detectors : config.getStringOr("detectors", ""));
+    detectorOptions.shards = opts.detectorShards;
+    detectorOptions.threads = opts.threads;
+    detectorOptions.settings.maxPatterns =
+        opts.maxPatterns ? *opts.maxPatterns
+                         : static_cast<std::size_t>(std::max(config.getIntOr("max_patterns", 0), 0));
+    std::unique_ptr<LogTool::Anomaly::DetectorPipeline> detectorPipeline;
+    try
+    {
+        detectorPipeline = std::make_unique<LogTool::Anomaly::DetectorPipeline>(detectorOptions);
+    }
+    catch (const std::invalid_argument &ex)
+    {
+        logger.error(ex.what());
+        return 1;
+    }
+    auto &detectors = *detectorPipeline;
 
     core::Report report;
-    report.setProcessedFile(opts.inputFile);
-
-    // Process file
-    std::ifstream file(opts.inputFile);
-    if (!file.is_open())
+    report.setProcessedFile(merged ? inputList : inputFile);
+
+    // Process file (memory-mapped: lines are views into the mapping, no per-line copies)
+    // The entry cache identifies the log as it is before it is opened, so
+    // lines appended during the run only make the cache stale.
+    using LogTool::Input::EntryCache;
+    std::optional<EntryCache::Source> cacheSource;
+    if (opts.cache && !merged)
+        cacheSource = EntryCache::describe(inputFile);
+
+    LogTool::Input::FileReader reader;
+    LogTool::Input::MergedInput mergedInput(parser, inputFiles, opts.queueDepth, opts.threads);
+    if (merged)
+    {
+        if (!mergedInput.open())
+            return 1;
+    }
+    else if (!reader.open(inputFile, LogTool::Input::FileReader::Mode::Mapped))
     {
-        logger.error("Cannot open input file: " + opts.inputFile);
+        logger.error("Cannot open input file: " + inputFile);
         return 1;
     }
 
-    logger.info("Batch processing mode");
-    const auto wallStart = std::chrono::steady_clock::now();
-
-    std::string line;
     std::uint64_t parsedCount = 0;
     std::uint64_t malformedCount = 0;
     std::uint64_t emittedCount = 0;
 
-    struct MinuteStats
-    {
-        std::uint64_t total = 0, trace = 0, debug = 0, info = 0, warn = 0, error = 0, critical = 0, unknown = 0, anomalies = 0, malformed = 0;
-    };
-    std::map<std::time_t, MinuteStats> ts;
+    LogTool::Report::MinuteSeries ts;
     auto bucketOf = [](const core::LogEntry::TimePoint &tp) -> std::time_t
     {
         const std::time_t t = core::LogEntry::Clock::to_time_t(tp);
@@ -191,18 +492,258 @@ int main(int argc, char *argv[])
     core::LogEntry::TimePoint minTs{};
     core::LogEntry::TimePoint maxTs{};
 
-    while (std::getline(file, line))
+
+    // Checkpointed run state: the source names (so IDs are re-interned in the
+    // same order), the message templates, the run totals, the time series,
+    // the report and the detector state. Everything else is derived from these.
+    auto &templates = LogTool::Analysis::TemplateMiner::global();
+    auto saveRunState = [&]() -> std::string
     {
-        if (line.empty())
-            continue;
+        core::StateWriter out;
+        const auto &sources = core::SourceTable::global();
+        out.putSize(sources.size());
+        for (core::SourceId id = 1; id < sources.size(); ++id)
+            out.putString(sources.nameOr(id, ""));
+        templates.saveState(out);
+
+        out.put(parsedCount);
+        out.put(malformedCount);
+        out.put(emittedCount);
+        out.put<std::int64_t>(lastBucket);
+        out.put<std::uint8_t>(haveTimeRange ? 1 : 0);
+        out.putTime(minTs);
+        out.putTime(maxTs);
+
+        out.putSize(ts.size());
+        for (const auto &[minute, counts] : ts)
+        {
+            out.put<std::int64_t>(minute);
+            out.put(counts);
+        }
+
+        report.saveState(out);
+        detectors.saveState(out);
+        return out.take();
+    };
 
-        auto pr = parser.parseLineDetailed(line);
-        if (!pr.entry.has_value())
+    auto restoreRunState = [&](std::string_view state)
+    {
+        core::StateReader in(state);
+        auto &sources = core::SourceTable::global();
+        const std::size_t sourceCount = in.getSize();
+        for (core::SourceId id = 1; id < sourceCount; ++id)
+        {
+            if (sources.intern(in.getStringView()) != id)
+                throw std::runtime_error("source IDs already assigned");
+        }
+        templates.loadState(in);
+
+        parsedCount = in.get<std::uint64_t>();
+        malformedCount = in.get<std::uint64_t>();
+        emittedCount = in.get<std::uint64_t>();
+        lastBucket = static_cast<std::time_t>(in.get<std::int64_t>());
+        haveTimeRange = in.get<std::uint8_t>() != 0;
+        minTs = in.getTime();
+        maxTs = in.getTime();
+
+        ts.clear();
+        for (std::size_t n = in.getSize(); n > 0; --n)
         {
+            const auto minute = static_cast<std::time_t>(in.get<std::int64_t>());
+            ts[minute] = in.get<LogTool::Report::MinuteCounts>();
+        }
+
+        report.loadState(in);
+        detectors.loadState(in);
+        if (!in.atEnd())
+            throw std::runtime_error("unexpected trailing data");
+    };
+
+    // -------------------------
+    // Incremental mode: with --checkpoint, a run on a file that has only grown
+    // since the last run restores that run's state and analyses just the
+    // appended lines; the report is the same as for a full re-run.
+    // -------------------------
+    using LogTool::Input::Checkpoint;
+    std::optional<Checkpoint::FileIdentity> inputIdentity;
+    bool checkpointing = false;
+    bool resumed = false;
+    if (opts.checkpointFile)
+    {
+        inputIdentity = Checkpoint::identify(inputFile);
+        if (merged)
+            logger.warn("Checkpointing needs a single input file; running without it");
+        else if (timeRange)
+            logger.warn("Checkpointing does not combine with --since/--until; running without it");
+        else if (!detectors.checkpointable())
+            logger.warn("Checkpointing disabled: not every enabled detector supports it");
+        else if (reader.mode() != LogTool::Input::FileReader::Mode::Mapped || !inputIdentity)
+            logger.warn("Checkpointing needs an uncompressed, memory-mappable input file; running without it");
+        else
+            checkpointing = true;
+    }
+    if (checkpointing)
+    {
+        const std::string_view data = reader.mappedData();
+        std::size_t begin = 0;
+        if (const auto ckpt = Checkpoint::load(*opts.checkpointFile))
+        {
+            const std::string why = ckpt->mismatch(*inputIdentity, data, detectors.layout());
+            if (!why.empty())
+            {
+                logger.info("Checkpoint not used (" + why + "); analysing the whole file");
+            }
+            else
+            {
+                try
+                {
+                    restoreRunState(ckpt->state);
+                }
+                catch (const std::exception &ex)
+                {
+                    logger.error("Cannot restore checkpoint " + *opts.checkpointFile + ": " + ex.what() +
+                                 " (delete it to start over)");
+                    return 1;
+                }
+                begin = static_cast<std::size_t>(ckpt->offset);
+                resumed = true;
+                logger.info("Resuming from checkpoint at byte " + std::to_string(begin) +
+                            " (last entry " + LogTool::Utils::toIso8601(ckpt->lastTimestamp) + ")");
+            }
+        }
+        reader.restrictTo(begin, data.size());
+    }
+
+    // When a later pass continues where this one ends (the next checkpointed
+    // run, or the follower), stop at the last complete line: a line still
+    // being written is analysed once, by that pass, when its newline is there.
+    if ((checkpointing || opts.follow) && reader.mode() == LogTool::Input::FileReader::Mode::Mapped)
+    {
+        const std::string_view data = reader.mappedData();
+        const std::size_t begin = reader.mappedOffset();
+        const auto lastNewline = data.rfind('\n');
+        reader.restrictTo(begin, lastNewline == std::string_view::npos ? begin : begin + lastNewline + 1);
+    }
+
+    // Sniff the dominant line format so its template is tried first for the whole file
+    // (merged input does this per file).
+    if (!merged)
+    {
+        std::string streamSample;
+        std::string_view sample = reader.mappedData();
+        if (reader.mode() != LogTool::Input::FileReader::Mode::Mapped)
+        {
+            for (std::size_t n = 0; n < LogTool::Input::LogParser::kDetectSampleLines; ++n)
+            {
+                const auto line = reader.nextLineView();
+                if (!line)
+                    break;
+                streamSample.append(*line).push_back('\n');
+            }
+            reader.rewind();
+            sample = streamSample;
+        }
+
+        if (const auto fmt = parser.detectFormat(sample))
+        {
+            logger.debug("Detected log format: " + parser.patterns()[*fmt]);
+        }
+    }
+
+    // -------------------------
+    // Time range: the parser drops entries outside it, and of a single mapped
+    // file only the bytes that can hold such entries are read, located with
+    // the sidecar time index or, without a usable one, by binary search.
+    // -------------------------
+    using LogTool::Input::TimeIndex;
+    const std::string indexPath = TimeIndex::sidecarPath(inputFile);
+    if (timeRange)
+    {
+        parser.setTimeRange(since, until);
+        logger.info("Time range: " + (since ? LogTool::Utils::toIso8601(*since) : std::string("start")) + " .. " +
+                    (until ? LogTool::Utils::toIso8601(*until) : std::string("end")));
+    }
+    if (timeRange && !merged && reader.mode() == LogTool::Input::FileReader::Mode::Mapped)
+    {
+        const std::string_view data = reader.mappedData();
+        std::optional<std::pair<std::size_t, std::size_t>> range;
+        std::string method;
+        if (const auto index = TimeIndex::load(indexPath))
+        {
+            if (index->matches(data))
+            {
+                const auto [begin, end] = index->range(since, until, data.size());
+                range.emplace(static_cast<std::size_t>(begin), static_cast<std::size_t>(end));
+                method = "time index " + indexPath;
+            }
+            else
+            {
+                logger.info("Time index " + indexPath + " does not match the file; rebuild it with 'index' or --index");
+            }
+        }
+        if (!range && (range = TimeIndex::searchSorted(data, parser, since, until)))
+            method = "binary search; no line outside it is in range";
+
+        if (range)
+        {
+            reader.restrictTo(range->first, range->second);
+            logger.info("Reading bytes " + std::to_string(range->first) + ".." + std::to_string(range->second) +
+                        " of " + std::to_string(data.size()) + " (" + method + ")");
+        }
+        else
+        {
+            logger.info("Input is not in time order; scanning the whole file for the time range");
+        }
+    }
+
+    // -------------------------
+    // Entry cache (--cache): replay the columns of an earlier parse of this
+    // file instead of parsing it, or write them during this run.
+    // -------------------------
+    const std::string cachePath = EntryCache::sidecarPath(inputFile);
+    std::optional<EntryCache> entryCache;
+    std::optional<EntryCache::Writer> cacheWriter;
+    if (opts.cache)
+    {
+        if (merged || timeRange || checkpointing || opts.follow || !cacheSource)
+        {
+            logger.warn("Entry cache not used: --cache needs a full run over one readable input file");
+        }
+        else
+        {
+            std::string whyNot;
+            entryCache = EntryCache::open(cachePath, *cacheSource, whyNot);
+            if (!entryCache)
+            {
+                if (!whyNot.empty())
+                    logger.info("Entry cache " + cachePath + " not used (" + whyNot + "); rewriting it");
+                cacheWriter.emplace(cachePath, *cacheSource);
+            }
+        }
+    }
+
+    // --index: record the time range of every block while the whole file is parsed.
+    std::optional<TimeIndex::Builder> indexBuilder;
+    if (opts.writeIndex)
+    {
+        if (merged || timeRange || entryCache || reader.mode() != LogTool::Input::FileReader::Mode::Mapped ||
+            reader.mappedOffset() != 0)
+            logger.warn("Time index not written: --index needs a full run over one uncompressed file");
+        else
+            indexBuilder.emplace();
+    }
+
+    logger.info("Batch processing mode");
+    const auto wallStart = std::chrono::steady_clock::now();
+
+    // Malformed lines are treated as anomalies and counted in the minute of the
+    // line before them ('bucket'), since they carry no usable timestamp.
+    auto handleMalformed = [&](const std::string &error, std::time_t bucket)
+    {
             ++malformedCount;
             // Treat malformed lines as anomalies (test: "Malformed log handling")
             const auto nowTp = core::Report::Clock::now();
-            const std::time_t b = (lastBucket != 0) ? lastBucket : bucketOf(nowTp);
+            const std::time_t b = (bucket != 0) ? bucket : bucketOf(nowTp);
             ts[b].malformed++;
 
             core::Anomaly a(core::AnomalyType::Other,
@@ -210,202 +751,365 @@ int main(int argc, char *argv[])
                             nowTp,
                             nowTp,
                             1.0,
-                            "Malformed log line: " + (pr.error.empty() ? std::string("parse failure") : pr.error),
+                            "Malformed log line: " + (error.empty() ? std::string("parse failure") : error),
                             std::optional<std::string>("parser"),
                             {});
             report.addAnomaly(std::move(a));
             ++emittedCount;
-            continue;
-        }
+    };
+
+    // Report the detector results of entry 'i' of the current batch, in
+    // canonical detector order ('b' is the entry's minute bucket).
+    auto emitEntryAnomalies = [&](std::size_t i, const core::LogEntry &entry, std::time_t b)
+    {
+            detectors.drainEntry(i, [&](core::Anomaly &&a, bool flagsEntry)
+                                 {
+                report.addAnomaly(std::move(a));
+                if (flagsEntry)
+                    report.incrementLevelCount(entry.level(), /*isAnomaly=*/true);
+                ++ts[b].anomalies;
+                ++emittedCount; });
+    };
 
-        const core::LogEntry &entry = *pr.entry;
-        ++parsedCount;
+    // Export sinks attach to the single ingest pass; all formatting and file
+    // writes run on one writer thread, overlapping with the analysis.
+    LogTool::Report::AsyncWriter writer;
+    std::vector<std::unique_ptr<LogTool::Report::IExportSink>> exportSinks;
+    if (opts.json)
+        exportSinks.push_back(std::make_unique<LogTool::Report::JsonReportSink>(writer, opts.outputDir + "/analysis-report.json"));
+    if (opts.csv)
+        exportSinks.push_back(std::make_unique<LogTool::Report::CsvReportSink>(writer, opts.outputDir + "/analysis-report.csv"));
+    if (opts.graphs)
+    {
+        exportSinks.push_back(std::make_unique<LogTool::Report::TimeSeriesCsvSink>(writer, opts.outputDir + "/timeseries_per_minute.csv"));
+        exportSinks.push_back(std::make_unique<LogTool::Report::EntriesCsvSink>(writer, opts.outputDir + "/entries.csv", resumed));
+    }
 
-        // Time-series bucket (for graphs)
-        const std::time_t b = bucketOf(entry.timestamp());
-        lastBucket = b;
-        auto &m = ts[b];
-        ++m.total;
-        switch (entry.level())
-        {
-        case core::LogLevel::Trace:
-            ++m.trace;
-            break;
-        case core::LogLevel::Debug:
-            ++m.debug;
-            break;
-        case core::LogLevel::Info:
-            ++m.info;
-            break;
-        case core::LogLevel::Warn:
-            ++m.warn;
-            break;
-        case core::LogLevel::Error:
-            ++m.error;
-            break;
-        case core::LogLevel::Critical:
-            ++m.critical;
-            break;
-        default:
-            ++m.unknown;
-            break;
-        }
+    // Per-entry message facts (core::Enrichment) and templates, computed once for
+    // every detector. Templates are mined on one thread, in file order.
+    auto prepareBatch = [&](core::EntryBatch &entries)
+    {
+        entries.enrich();
+        templates.assign(entries);
+    };
 
-        // Track analysis time range based on parsed timestamps
-        if (!haveTimeRange)
+    // Batch processing shared by the serial, parallel and pipelined ingest paths.
+    // Batches must arrive in file order: malformed lines inherit the last bucket,
+    // and prepareBatch() mines templates in arrival order.
+    // 'stages' is Streaming when the pipeline runs the summary detectors on their own stage.
+    std::vector<std::time_t> buckets; // minute bucket per entry of the current batch
+    auto handleBatch = [&](LogTool::Input::LogParser::ParsedBatch &batch,
+                           LogTool::Anomaly::DetectorPipeline::Stages stages)
+    {
+        prepareBatch(batch.entries); // no-op when the pipeline already did it
+
+        const core::EntryBatch &entries = batch.entries;
+        const std::size_t n = entries.size();
+        const auto &times = entries.timestamps();
+        const auto &levels = entries.levels();
+
+        if (indexBuilder && batch.inputEnd > batch.inputBegin)
+            indexBuilder->add(reader.mappedOffset() + batch.inputBegin,
+                              reader.mappedData().substr(batch.inputBegin, batch.inputEnd - batch.inputBegin), batch);
+        if (cacheWriter)
+            cacheWriter->add(batch);
+
+        // Column scans: minute buckets, time range, per-minute and per-level counts.
+        buckets.resize(n);
+        for (std::size_t i = 0; i < n; ++i)
+            buckets[i] = bucketOf(times[i]);
+
+        if (n > 0)
         {
-            minTs = entry.timestamp();
-            maxTs = entry.timestamp();
+            const auto [lo, hi] = std::minmax_element(times.begin(), times.end());
+            minTs = haveTimeRange ? std::min(minTs, *lo) : *lo;
+            maxTs = haveTimeRange ? std::max(maxTs, *hi) : *hi;
             haveTimeRange = true;
         }
-        else
+
+        // Consecutive entries almost always share a minute: count each run
+        // locally and touch the time-series map once per run.
+        for (std::size_t i = 0; i < n;)
         {
-            if (entry.timestamp() < minTs)
-                minTs = entry.timestamp();
-            if (entry.timestamp() > maxTs)
-                maxTs = entry.timestamp();
+            std::array<std::uint64_t, static_cast<std::size_t>(core::LogLevel::Unknown) + 1> perLevel{};
+            std::size_t j = i;
+            for (; j < n && buckets[j] == buckets[i]; ++j)
+                ++perLevel[static_cast<std::size_t>(levels[j])];
+
+            auto &m = ts[buckets[i]];
+            m.total += j - i;
+            m.trace += perLevel[static_cast<std::size_t>(core::LogLevel::Trace)];
+            m.debug += perLevel[static_cast<std::size_t>(core::LogLevel::Debug)];
+            m.info += perLevel[static_cast<std::size_t>(core::LogLevel::Info)];
+            m.warn += perLevel[static_cast<std::size_t>(core::LogLevel::Warn)];
+            m.error += perLevel[static_cast<std::size_t>(core::LogLevel::Error)];
+            m.critical += perLevel[static_cast<std::size_t>(core::LogLevel::Critical)];
+            m.unknown += perLevel[static_cast<std::size_t>(core::LogLevel::Unknown)];
+            i = j;
         }
 
         // Update stats in Report
-        report.incrementLevelCount(entry.level(), /*isAnomaly=*/false);
-        report.updateSourceStats(entry.source().value_or("unknown"), entry.level());
-
-        // Feed analyzers (kept for future/report enrichment)
-        freq.addEntry(entry);
-        timeWindow.addEntry(entry);
-        pattern.addEntry(entry);
+        report.addEntryCounts(entries);
+        parsedCount += n;
 
-        // -------------------------
-        // Real-time anomaly detectors
-        // -------------------------
+        for (auto &sink : exportSinks)
+            sink->onBatch(entries);
 
-        // Rule-based anomalies
-        auto matches = ruleDetector.checkEntry(entry);
-        auto anomalies = ruleDetector.matchesToAnomalies(matches, entry);
+        // Enabled detectors: one call (one lock) per batch each.
+        detectors.processBatch(entries, stages);
 
-        for (auto &a : anomalies)
+        // Report in file order, with malformed lines interleaved where they occurred.
+        std::size_t next = 0;
+        for (const auto &bad : batch.malformed)
         {
-            report.addAnomaly(std::move(a));
-            report.incrementLevelCount(entry.level(), /*isAnomaly=*/true);
-            ++ts[b].anomalies;
-            ++emittedCount;
+            for (; next < bad.position; ++next)
+                emitEntryAnomalies(next, entries[next], buckets[next]);
+            handleMalformed(bad.error, bad.position > 0 ? buckets[bad.position - 1] : lastBucket);
         }
+        for (; next < n; ++next)
+            emitEntryAnomalies(next, entries[next], buckets[next]);
+
+        if (n > 0)
+            lastBucket = buckets[n - 1];
+    };
 
-        // Spike detector (sliding window)
-        for (const auto &s : spikeDetector.processEntry(entry))
+    const std::size_t parseThreads = LogTool::Utils::ThreadPool::resolveThreadCount(opts.threads);
+    const bool compressed = reader.mode() == LogTool::Input::FileReader::Mode::Compressed;
+    if (compressed && !entryCache)
+        logger.info(std::string("Decompressing ") + LogTool::Input::compressionName(reader.compression()) +
+                    " input on a background thread");
+    if (entryCache)
+    {
+        logger.info("Replaying " + std::to_string(entryCache->entryCount()) + " parsed entries from " + cachePath);
+        try
         {
-            core::Anomaly a(
-                core::AnomalyType::FrequencySpike,
-                s.severity >= 0.9 ? core::AnomalySeverity::Critical : (s.severity >= 0.6 ? core::AnomalySeverity::High : core::AnomalySeverity::Medium),
-                s.stats.windowStart,
-                s.stats.windowEnd,
-                s.stats.spikeRatio,
-                s.description,
-                s.stats.source.empty() ? std::optional<std::string>{} : std::optional<std::string>(s.stats.source),
-                s.sampleEvents);
-            report.addAnomaly(std::move(a));
-            ++ts[b].anomalies;
-            ++emittedCount;
+            entryCache->run([&](LogTool::Input::LogParser::ParsedBatch &batch)
+                            { handleBatch(batch, LogTool::Anomaly::DetectorPipeline::Stages::All); });
         }
-
-        // Statistical detector (Z-score)
-        for (const auto &st : statDetector.processEntry(entry))
+        catch (const std::exception &ex)
         {
-            core::Anomaly a(
-                core::AnomalyType::StatisticalOutlier,
-                st.severity >= 0.9 ? core::AnomalySeverity::High : (st.severity >= 0.6 ? core::AnomalySeverity::Medium : core::AnomalySeverity::Low),
-                entry.timestamp(),
-                entry.timestamp(),
-                st.zscore,
-                st.description,
-                entry.source(),
-                {entry});
-            report.addAnomaly(std::move(a));
-            ++ts[b].anomalies;
-            ++emittedCount;
+            logger.error(std::string(ex.what()) + " (delete " + cachePath + " to rebuild it)");
+            return 1;
         }
-
-        // Burst pattern recognition (repeated normalized messages)
-        for (const auto &br : burstDetector.processEntry(entry))
+    }
+    else if (merged)
+    {
+        // Files are parsed on up to -j threads; the k-way merge runs on this thread.
+        logger.info("Merging " + std::to_string(inputFiles.size()) + " input files by timestamp (" +
+                    std::to_string(mergedInput.totalBytes() / (1024 * 1024)) + " MiB, " +
+                    std::to_string(std::min(parseThreads, inputFiles.size())) + " parser thread(s))");
+        mergedInput.run([&](LogTool::Input::LogParser::ParsedBatch &batch)
+                        { handleBatch(batch, LogTool::Anomaly::DetectorPipeline::Stages::All); });
+    }
+    else if (opts.pipeline || (compressed && parseThreads > 1))
+    {
+        // Compressed input cannot be split by offset, so several parser threads
+        // always take the staged path, fed with the decompressed blocks.
+        // Stages: reader -> parsers -> { summary detectors (own thread), streaming detectors (this thread) }.
+        // Every edge is a bounded SPSC queue, so a slow stage throttles the ones before it.
+        using SharedBatch = std::shared_ptr<const LogTool::Input::LogParser::ParsedBatch>;
+        logger.info("Pipelined ingestion with " + std::to_string(parseThreads) +
+                    " parser thread(s), queue depth " + std::to_string(opts.queueDepth));
+
+        // The summary stage only exists when a summary detector is enabled.
+        LogTool::Utils::SpscQueue<SharedBatch> analyzerQueue(opts.queueDepth);
+        std::thread analyzerStage;
+        if (detectors.hasSummary())
         {
-            core::Anomaly a(
-                core::AnomalyType::SequenceViolation,
-                core::AnomalySeverity::High,
-                br.windowStart,
-                br.windowEnd,
-                br.score,
-                br.description,
-                br.source,
-                br.samples);
-            report.addAnomaly(std::move(a));
-            ++ts[b].anomalies;
-            ++emittedCount;
+            analyzerStage = std::thread([&]()
+                                        {
+                SharedBatch batch;
+                while (analyzerQueue.pop(batch))
+                {
+                    detectors.processBatch(batch->entries, LogTool::Anomaly::DetectorPipeline::Stages::Summary);
+                    batch.reset();
+                } });
         }
+        auto stopAnalyzerStage = [&]()
+        {
+            analyzerQueue.close();
+            if (analyzerStage.joinable())
+                analyzerStage.join();
+        };
 
-        // Rare IP detection (IP extracted from message)
-        for (const auto &iphit : ipDetector.processEntry(entry))
+        try
         {
-            core::Anomaly a(
-                core::AnomalyType::RarePattern,
-                core::AnomalySeverity::Low,
-                iphit.entry.timestamp(),
-                iphit.entry.timestamp(),
-                1.0,
-                "Rare IP observed (count=" + std::to_string(iphit.count) + "): " + iphit.ip,
-                iphit.entry.source(),
-                {iphit.entry});
-            report.addAnomaly(std::move(a));
-            ++ts[b].anomalies;
-            ++emittedCount;
+            LogTool::Input::IngestPipeline pipeline(parser, parseThreads, opts.queueDepth);
+            pipeline.run(reader, [&](const LogTool::Input::IngestPipeline::Batch &batch)
+                         {
+                prepareBatch(batch->entries); // before the summary stage sees the batch
+                if (detectors.hasSummary())
+                    analyzerQueue.push(batch);
+                handleBatch(*batch, LogTool::Anomaly::DetectorPipeline::Stages::Streaming); });
+        }
+        catch (...)
+        {
+            stopAnalyzerStage();
+            throw;
+        }
+        stopAnalyzerStage();
+    }
+    else if (parseThreads > 1 && reader.mode() == LogTool::Input::FileReader::Mode::Mapped)
+    {
+        logger.info("Parallel parsing with " + std::to_string(parseThreads) + " threads");
+        LogTool::Input::ParallelParser parallel(parser, parseThreads);
+        parallel.parse(reader.mappedData(), [&](LogTool::Input::LogParser::ParsedBatch &batch)
+                       { handleBatch(batch, LogTool::Anomaly::DetectorPipeline::Stages::All); });
+    }
+    else
+    {
+        LogTool::Input::LogParser::ParsedBatch batch;
+        batch.entries.reserve(core::EntryBatch::kDefaultCapacity);
+        batch.inputBegin = reader.mappedPosition();
+        while (const auto line = reader.nextLineView())
+        {
+            if (line->empty())
+                continue;
+
+            parser.parseInto(*line, batch);
+            if (batch.lineCount() >= core::EntryBatch::kDefaultCapacity)
+            {
+                batch.inputEnd = reader.mappedPosition();
+                handleBatch(batch, LogTool::Anomaly::DetectorPipeline::Stages::All);
+                batch.clear();
+                batch.inputBegin = reader.mappedPosition();
+            }
         }
+        batch.inputEnd = reader.mappedPosition();
+        handleBatch(batch, LogTool::Anomaly::DetectorPipeline::Stages::All);
+    }
+
+    if (cacheWriter)
+    {
+        if (cacheWriter->finish())
+            logger.info("Entry cache saved: " + cachePath);
+        cacheWriter.reset();
+    }
+
+    if (indexBuilder)
+    {
+        const TimeIndex index = indexBuilder->finish(reader.mappedData());
+        indexBuilder.reset();
+        if (index.save(indexPath))
+            logger.info("Time index saved: " + indexPath + " (" + std::to_string(index.blocks().size()) + " blocks)");
+    }
+
+    // End of the analysed input: follow mode and the checkpoint continue from here.
+    std::uint64_t analysedUpTo = reader.mappedOffset() + reader.mappedData().size();
+    if (reader.mode() != LogTool::Input::FileReader::Mode::Mapped)
+    {
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(inputFile, ec);
+        analysedUpTo = ec ? 0 : static_cast<std::uint64_t>(size);
     }
 
     // -------------------------
-    // Offline analyzer summaries (produce anomalies after seeing the whole file)
-    // This also proves whether analyzers are actually wired into the pipeline.
+    // Follow mode: keep feeding appended lines to the streaming detectors until
+    // interrupted, then fall through to the summaries and reports below.
     // -------------------------
-    logger.debug("Running FrequencyAnalyzer on " + std::to_string(parsedCount) + " events...");
-    const auto freqAnoms = freq.detectAnomalies();
-    logger.info("FrequencyAnalyzer produced " + std::to_string(freqAnoms.size()) + " anomalies");
-    for (const auto &d : freqAnoms)
+    if (opts.follow && compressed)
     {
-        core::Anomaly a(core::AnomalyType::FrequencySpike, core::AnomalySeverity::Medium,
-                        haveTimeRange ? minTs : core::Report::Clock::now(),
-                        haveTimeRange ? maxTs : core::Report::Clock::now(),
-                        1.0, d, std::nullopt, {});
-        report.addAnomaly(std::move(a));
-        ++emittedCount;
+        logger.warn("Not following " + inputFile + ": compressed files are not appended to");
     }
+    else if (opts.follow)
+    {
+        LogTool::Input::FileFollower::Options followOptions;
+        followOptions.pollInterval = std::chrono::milliseconds(opts.followPollMs);
+        LogTool::Input::FileFollower follower(inputFile, analysedUpTo, followOptions);
+        if (!follower.open())
+        {
+            logger.error("Cannot follow input file: " + inputFile);
+        }
+        else
+        {
+            logger.info("Following " + inputFile + " (Ctrl+C to stop and write the report)");
+            std::signal(SIGINT, onStopSignal);
+            std::signal(SIGTERM, onStopSignal);
+
+            LogTool::Report::ConsoleReporter live(LogTool::Report::ConsoleReporter::Verbosity::NORMAL);
+            std::string chunk;
+            LogTool::Input::LogParser::ParsedBatch batch;
+            batch.entries.reserve(core::EntryBatch::kDefaultCapacity);
+            while (!g_stopRequested)
+            {
+                chunk.clear();
+                if (follower.poll(chunk) == 0)
+                    continue;
+
+                const std::size_t reported = report.anomalies().size();
+                std::size_t pos = 0;
+                while (const auto line = LogTool::Input::FileReader::nextLineIn(chunk, pos))
+                {
+                    if (line->empty())
+                        continue;
+                    parser.parseInto(*line, batch);
+                    if (batch.lineCount() >= core::EntryBatch::kDefaultCapacity)
+                    {
+                        handleBatch(batch, LogTool::Anomaly::DetectorPipeline::Stages::All);
+                        batch.clear();
+                    }
+                }
+                handleBatch(batch, LogTool::Anomaly::DetectorPipeline::Stages::All);
+                batch.clear();
+
+                // Live alerts for what the new lines triggered.
+                for (std::size_t i = reported; i < report.anomalies().size(); ++i)
+                    live.reportAnomaly(report.anomalies()[i]);
+            }
+
+            std::signal(SIGINT, SIG_DFL);
+            std::signal(SIGTERM, SIG_DFL);
+            logger.info("Follow stopped after " + std::to_string(follower.rotations()) + " rotation(s)");
 
-    logger.debug("Running PatternAnalyzer on " + std::to_string(parsedCount) + " events...");
-    const auto patAnoms = pattern.detectAnomalies();
-    logger.info("PatternAnalyzer produced " + std::to_string(patAnoms.size()) + " anomalies");
-    for (const auto &d : patAnoms)
+            analysedUpTo = follower.consumedOffset();
+            if (checkpointing && follower.rotations() > 0)
+            {
+                logger.warn("Checkpoint not written: the input was rotated while following");
+                checkpointing = false;
+            }
+        }
+    }
+
+    // -------------------------
+    // Checkpoint: the state after the last analysed line, taken before the
+    // summary detectors run (they only read it).
+    // -------------------------
+    if (checkpointing)
     {
-        core::Anomaly a(core::AnomalyType::SequenceViolation, core::AnomalySeverity::Medium,
-                        haveTimeRange ? minTs : core::Report::Clock::now(),
-                        haveTimeRange ? maxTs : core::Report::Clock::now(),
-                        1.0, d, std::nullopt, {});
-        report.addAnomaly(std::move(a));
-        ++emittedCount;
+        const auto identity = Checkpoint::identify(inputFile);
+        const auto fingerprint = Checkpoint::fingerprintFile(inputFile, analysedUpTo);
+        if (!identity || identity->device != inputIdentity->device || identity->inode != inputIdentity->inode ||
+            !fingerprint)
+        {
+            logger.warn("Checkpoint not written: the input was replaced during the run");
+        }
+        else
+        {
+            Checkpoint ckpt;
+            ckpt.inputPath = inputFile;
+            ckpt.file = *identity;
+            ckpt.offset = analysedUpTo;
+            ckpt.fingerprint = *fingerprint;
+            ckpt.lastTimestamp = maxTs;
+            ckpt.layout = detectors.layout();
+            ckpt.state = saveRunState();
+            if (ckpt.save(*opts.checkpointFile))
+                logger.info("Checkpoint saved: " + *opts.checkpointFile + " (byte " + std::to_string(analysedUpTo) + ")");
+        }
     }
 
-    logger.debug("Running TimeWindowAnalyzer detectAnomalies()...");
-    const auto twAnoms = timeWindow.detectAnomalies();
-    logger.info("TimeWindowAnalyzer produced " + std::to_string(twAnoms.size()) + " anomalies");
-    for (const auto &tw : twAnoms)
+    // -------------------------
+    // Summary detectors (produce anomalies after seeing the whole file)
+    // -------------------------
     {
-        // Map by description (simple but effective)
-        core::AnomalyType type = core::AnomalyType::FrequencySpike;
-        if (tw.description.find("Silence") != std::string::npos)
-            type = core::AnomalyType::Silence;
-        core::AnomalySeverity sev = (tw.score >= 0.9)   ? core::AnomalySeverity::High
-                                    : (tw.score >= 0.6) ? core::AnomalySeverity::Medium
-                                                        : core::AnomalySeverity::Low;
-        core::Anomaly a(type, sev, tw.stats.windowStart, tw.stats.windowEnd, tw.score,
-                        tw.description, std::nullopt, {});
-        report.addAnomaly(std::move(a));
-        ++emittedCount;
+        const auto now = core::Report::Clock::now();
+        const LogTool::Anomaly::IDetector::SummaryContext summary{haveTimeRange ? minTs : now,
+                                                                  haveTimeRange ? maxTs : now};
+        for (auto &a : detectors.summarize(summary))
+        {
+            report.addAnomaly(std::move(a));
+            ++emittedCount;
+        }
     }
 
     const auto wallEnd = std::chrono::steady_clock::now();
@@ -428,50 +1132,16 @@ int main(int argc, char *argv[])
     logger.info("Parsed entries: " + std::to_string(parsedCount));
     logger.info("Finished in " + std::to_string(ms) + " ms");
 
+    // Final exports (rendered on the writer thread while the console report prints)
+    for (auto &sink : exportSinks)
+        sink->onFinish(report, ts);
+
     // Console report
     {
         LogTool::Report::ConsoleReporter console(LogTool::Report::ConsoleReporter::Verbosity::VERBOSE);
         console.generateReport(report);
     }
 
-    // JSON export
-    if (opts.json)
-    {
-        LogTool::Report::JsonReporter json(LogTool::Report::JsonReporter::PrettyPrint::PRETTY);
-        json.generateReport(report);
-
-        const std::string jsonPath = opts.outputDir + "/analysis-report.json";
-        std::ofstream out(jsonPath);
-        if (!out.is_open())
-        {
-            logger.error("Cannot write JSON: " + jsonPath);
-        }
-        else
-        {
-            json.writeJson(out);
-            logger.info("JSON saved: " + jsonPath);
-        }
-    }
-
-    // CSV export
-    if (opts.csv)
-    {
-        LogTool::Report::CsvReporter csv(LogTool::Report::CsvReporter::ExportMode::ANOMALIES_ONLY);
-        csv.generateReport(report);
-
-        const std::string csvPath = opts.outputDir + "/analysis-report.csv";
-        std::ofstream out(csvPath);
-        if (!out.is_open())
-        {
-            logger.error("Cannot write CSV: " + csvPath);
-        }
-        else
-        {
-            csv.writeCsv(out, true);
-            logger.info("CSV saved: " + csvPath);
-        }
-    }
-
     // Graph/time-series export
 
     if (opts.graphs)
@@ -497,97 +1167,13 @@ int main(int argc, char *argv[])
         { /* ignore */
         }
 
-        // 1) Time-series per minute CSV
-        const std::string tsPath = opts.outputDir + "/timeseries_per_minute.csv";
-        {
-            std::ofstream out(tsPath);
-            if (!out.is_open())
-            {
-                logger.error("Cannot write timeseries: " + tsPath);
-            }
-            else
-            {
-                out << "minute_iso,total,trace,debug,info,warn,error,critical,unknown,anomalies,malformed\n";
-                for (const auto &kv : ts)
-                {
-                    const std::time_t t = kv.first;
-                    const auto &s = kv.second;
-                    const auto tp = core::LogEntry::Clock::from_time_t(t);
-                    out << LogTool::Utils::toIso8601(tp) << ","
-                        << s.total << "," << s.trace << "," << s.debug << "," << s.info << ","
-                        << s.warn << "," << s.error << "," << s.critical << "," << s.unknown << ","
-                        << s.anomalies << "," << s.malformed << "\n";
-                }
-                logger.info("Time-series CSV saved: " + tsPath);
-            }
-        }
-
-        // 2) Full entries CSV (for message/service/IP frequency plots)
-        const std::string entriesPath = opts.outputDir + "/entries.csv";
-        {
-            std::ofstream out(entriesPath);
-            if (!out.is_open())
-            {
-                logger.error("Cannot write entries CSV: " + entriesPath);
-            }
-            else
-            {
-                out << "timestamp_iso,level,source,message\n";
-                file.clear();
-                file.seekg(0, std::ios::beg);
-
-                std::string ln;
-                while (std::getline(file, ln))
-                {
-                    if (ln.empty())
-                        continue;
-                    auto pr = parser.parseLineDetailed(ln);
-                    if (!pr.entry.has_value())
-                        continue;
-
-                    const auto &e = *pr.entry;
-
-                    auto levelToStr = [](core::LogLevel lv) -> const char *
-                    {
-                        switch (lv)
-                        {
-                        case core::LogLevel::Trace:
-                            return "TRACE";
-                        case core::LogLevel::Debug:
-                            return "DEBUG";
-                        case core::LogLevel::Info:
-                            return "INFO";
-                        case core::LogLevel::Warn:
-                            return "WARN";
-                        case core::LogLevel::Error:
-                            return "ERROR";
-                        case core::LogLevel::Critical:
-                            return "CRITICAL";
-                        default:
-                            return "UNKNOWN";
-                        }
-                    };
-
-                    const std::string tsIso = LogTool::Utils::toIso8601(e.timestamp());
-                    const std::string src = e.source().value_or("unknown");
-                    const std::string msg = e.message();
-
-                    // Use std::quoted for safe CSV writing (adds quotes and escapes quotes)
-                    out << std::quoted(tsIso) << ","
-                        << std::quoted(levelToStr(e.level())) << ","
-                        << std::quoted(src) << ","
-                        << std::quoted(msg)
-                        << "\n";
-                }
-                logger.info("Entries CSV saved: " + entriesPath);
-            }
-        }
+        // 1) + 2) Time-series and entries CSVs are written by their export sinks.
 
         // 3) Benchmark CSV (appends one row per run)
         const std::string benchPath = opts.outputDir + "/benchmark_runs.csv";
         try
         {
-            const std::uintmax_t fsz = std::filesystem::file_size(opts.inputFile);
+            const std::uintmax_t fsz = merged ? mergedInput.totalBytes() : std::filesystem::file_size(inputFile);
             const auto wallEnd = std::chrono::steady_clock::now();
             const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(wallEnd - wallStart).count();
 
@@ -1071,6 +1657,7 @@ if __name__ == "__main__":
         // 5) Best-effort auto-run plot script (optional).
         // If python isn't available, user can run manually:
         //   python plot_all_graphs.py  (inside the graphs folder)
+        writer.finish(); // the script reads the exported CSVs
         try
         {
 #if defined(_WIN32)
@@ -1089,6 +1676,8 @@ if __name__ == "__main__":
         }
     }
 
+    writer.finish();
+
     // Summary generator
     {
         LogTool::Report::ReportGenerator gen(LogTool::Report::ReportGenerator::OutputFormat::SUMMARY);
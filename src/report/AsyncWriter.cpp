@@ -0,0 +1,88 @@
+#include "report/AsyncWriter.hpp"
+
+#include <exception>
+
+namespace LogTool
+{
+    namespace Report
+    {
+        AsyncWriter::AsyncWriter(std::size_t queueDepth)
+            : m_jobs(queueDepth)
+        {
+            m_thread = std::thread([this]() { run(); });
+        }
+
+        AsyncWriter::~AsyncWriter()
+        {
+            finish();
+        }
+
+        void AsyncWriter::submit(Job job)
+        {
+            if (!m_jobs.push(std::move(job)))
+            {
+                Utils::getLogger().warn("AsyncWriter: job submitted after finish() was dropped");
+            }
+        }
+
+        void AsyncWriter::finish()
+        {
+            m_jobs.close();
+            if (m_thread.joinable())
+            {
+                m_thread.join();
+            }
+
+            std::vector<std::pair<Utils::LogLevel, std::string>> held;
+            {
+                std::lock_guard<std::mutex> lock(m_logMutex);
+                held.swap(m_held);
+            }
+            auto& logger = Utils::getLogger();
+            for (const auto& message : held)
+            {
+                logger.log(message.first, message.second);
+            }
+        }
+
+        void AsyncWriter::log(Utils::LogLevel level, std::string message)
+        {
+            std::lock_guard<std::mutex> lock(m_logMutex);
+            m_held.emplace_back(level, std::move(message));
+        }
+
+        void AsyncWriter::run()
+        {
+            Job job;
+            while (m_jobs.pop(job))
+            {
+                try
+                {
+                    job();
+                }
+                catch (const std::exception& ex)
+                {
+                    log(Utils::LogLevel::ERROR, std::string("Export failed: ") + ex.what());
+                }
+                job = nullptr;
+            }
+        }
+
+        BufferedFile::BufferedFile(const std::string& path, std::ios::openmode mode, std::size_t bufferBytes)
+            : m_buffer(new char[bufferBytes])
+        {
+            // The buffer has to be installed before open() to take effect.
+            m_out.rdbuf()->pubsetbuf(m_buffer.get(), static_cast<std::streamsize>(bufferBytes));
+            m_out.open(path, mode);
+        }
+
+        void BufferedFile::close()
+        {
+            if (m_out.is_open())
+            {
+                m_out.close();
+            }
+        }
+
+    } // namespace Report
+} // namespace LogTool
@@ -0,0 +1,227 @@
+#include "report/ExportSink.hpp"
+
+#include <filesystem>
+
+#include "core/SourceTable.hpp"
+#include "report/CsvReporter.hpp"
+#include "report/JsonReporter.hpp"
+#include "utils/Logger.hpp"
+#include "utils/TimeUtils.hpp"
+
+namespace LogTool
+{
+    namespace Report
+    {
+        namespace
+        {
+            const char* levelName(core::LogLevel level) noexcept
+            {
+                switch (level)
+                {
+                case core::LogLevel::Trace:
+                    return "TRACE";
+                case core::LogLevel::Debug:
+                    return "DEBUG";
+                case core::LogLevel::Info:
+                    return "INFO";
+                case core::LogLevel::Warn:
+                    return "WARN";
+                case core::LogLevel::Error:
+                    return "ERROR";
+                case core::LogLevel::Critical:
+                    return "CRITICAL";
+                default:
+                    return "UNKNOWN";
+                }
+            }
+
+            // Same output as 'os << std::quoted(text)': quotes and backslashes are backslash-escaped.
+            void appendQuoted(std::string& out, std::string_view text)
+            {
+                out.push_back('"');
+                for (const char c : text)
+                {
+                    if (c == '"' || c == '\\')
+                        out.push_back('\\');
+                    out.push_back(c);
+                }
+                out.push_back('"');
+            }
+        } // namespace
+
+        // ---------- EntriesCsvSink ----------
+
+        struct EntriesCsvSink::State
+        {
+            std::string                  path;
+            std::unique_ptr<BufferedFile> file;
+            std::string                  chunk; // rows of one batch
+
+            // toIso8601() works at one-second resolution: format each second once.
+            std::time_t lastSecond = 0;
+            std::string lastIso;
+            bool        haveIso = false;
+
+            // Quoted source name per SourceId ("unknown" for entries without one).
+            std::vector<std::string> quotedSources;
+
+            const std::string& quotedSource(core::SourceId id)
+            {
+                if (id >= quotedSources.size())
+                    quotedSources.resize(static_cast<std::size_t>(id) + 1);
+                std::string& cached = quotedSources[id];
+                if (cached.empty())
+                    appendQuoted(cached, core::SourceTable::global().nameOr(id, "unknown"));
+                return cached;
+            }
+        };
+
+        EntriesCsvSink::EntriesCsvSink(AsyncWriter& writer, std::string path, bool append)
+            : m_writer(writer), m_state(std::make_shared<State>())
+        {
+            m_state->path = std::move(path);
+            m_writer.submit([state = m_state, append, &writer = m_writer]()
+                            {
+                std::error_code ec;
+                const bool continuing = append && std::filesystem::file_size(state->path, ec) > 0 && !ec;
+                state->file = std::make_unique<BufferedFile>(
+                    state->path, continuing ? std::ios::out | std::ios::app : std::ios::out | std::ios::trunc);
+                if (!state->file->isOpen())
+                {
+                    writer.log(Utils::LogLevel::ERROR, "Cannot write entries CSV: " + state->path);
+                    state->file.reset();
+                    return;
+                }
+                if (!continuing)
+                    state->file->write("timestamp_iso,level,source,message\n"); });
+        }
+
+        void EntriesCsvSink::onBatch(const core::EntryBatch& batch)
+        {
+            if (batch.empty())
+                return;
+
+            // Entries share their text blocks, so this copy is cheap; formatting runs on the writer.
+            auto rows = std::make_shared<std::vector<core::LogEntry>>(batch.entries());
+            m_writer.submit([state = m_state, rows]()
+                            {
+                if (!state->file)
+                    return;
+                std::string& out = state->chunk;
+                out.clear();
+                for (const auto& e : *rows)
+                {
+                    const std::time_t second = core::LogEntry::Clock::to_time_t(e.timestamp());
+                    if (!state->haveIso || second != state->lastSecond)
+                    {
+                        state->lastIso.clear();
+                        appendQuoted(state->lastIso, Utils::toIso8601(e.timestamp()));
+                        state->lastSecond = second;
+                        state->haveIso = true;
+                    }
+                    out += state->lastIso;
+                    out.push_back(',');
+                    appendQuoted(out, levelName(e.level()));
+                    out.push_back(',');
+                    out += state->quotedSource(e.sourceId());
+                    out.push_back(',');
+                    appendQuoted(out, e.message());
+                    out.push_back('\n');
+                }
+                state->file->write(out); });
+        }
+
+        void EntriesCsvSink::onFinish(const core::Report&, const MinuteSeries&)
+        {
+            m_writer.submit([state = m_state, &writer = m_writer]()
+                            {
+                if (!state->file)
+                    return;
+                state->file->close();
+                state->file.reset();
+                writer.log(Utils::LogLevel::INFO, "Entries CSV saved: " + state->path); });
+        }
+
+        // ---------- TimeSeriesCsvSink ----------
+
+        TimeSeriesCsvSink::TimeSeriesCsvSink(AsyncWriter& writer, std::string path)
+            : m_writer(writer), m_path(std::move(path))
+        {
+        }
+
+        void TimeSeriesCsvSink::onFinish(const core::Report&, const MinuteSeries& series)
+        {
+            m_writer.submit([path = m_path, &series, &writer = m_writer]()
+                            {
+                BufferedFile file(path);
+                if (!file.isOpen())
+                {
+                    writer.log(Utils::LogLevel::ERROR, "Cannot write timeseries: " + path);
+                    return;
+                }
+                auto& out = file.stream();
+                out << "minute_iso,total,trace,debug,info,warn,error,critical,unknown,anomalies,malformed\n";
+                for (const auto& kv : series)
+                {
+                    const auto& s = kv.second;
+                    out << Utils::toIso8601(core::LogEntry::Clock::from_time_t(kv.first)) << ","
+                        << s.total << "," << s.trace << "," << s.debug << "," << s.info << ","
+                        << s.warn << "," << s.error << "," << s.critical << "," << s.unknown << ","
+                        << s.anomalies << "," << s.malformed << "\n";
+                }
+                file.close();
+                writer.log(Utils::LogLevel::INFO, "Time-series CSV saved: " + path); });
+        }
+
+        // ---------- JsonReportSink ----------
+
+        JsonReportSink::JsonReportSink(AsyncWriter& writer, std::string path)
+            : m_writer(writer), m_path(std::move(path))
+        {
+        }
+
+        void JsonReportSink::onFinish(const core::Report& report, const MinuteSeries&)
+        {
+            m_writer.submit([path = m_path, &report, &writer = m_writer]()
+                            {
+                JsonReporter json(JsonReporter::PrettyPrint::PRETTY);
+                json.generateReport(report);
+
+                BufferedFile file(path);
+                if (!file.isOpen())
+                {
+                    writer.log(Utils::LogLevel::ERROR, "Cannot write JSON: " + path);
+                    return;
+                }
+                json.writeJson(file.stream());
+                file.close();
+                writer.log(Utils::LogLevel::INFO, "JSON saved: " + path); });
+        }
+
+        // ---------- CsvReportSink ----------
+
+        CsvReportSink::CsvReportSink(AsyncWriter& writer, std::string path)
+            : m_writer(writer), m_path(std::move(path))
+        {
+        }
+
+        void CsvReportSink::onFinish(const core::Report& report, const MinuteSeries&)
+        {
+            m_writer.submit([path = m_path, &report, &writer = m_writer]()
+                            {
+                CsvReporter csv(CsvReporter::ExportMode::ANOMALIES_ONLY);
+                csv.generateReport(report);
+
+                BufferedFile file(path);
+                if (!file.isOpen())
+                {
+                    writer.log(Utils::LogLevel::ERROR, "Cannot write CSV: " + path);
+                    return;
+                }
+                csv.writeCsv(file.stream(), true);
+                file.close();
+                writer.log(Utils::LogLevel::INFO, "CSV saved: " + path); });
+        }
+
+    } // namespace Report
+} // namespace LogTool
@@ -21,9 +21,10 @@ namespace Report
     computeTopSources(const core::Report& report)
     {
         std::vector<std::pair<std::string, std::uint64_t>> top;
-        top.reserve(report.sourceStatistics().size());
+        const auto sources = report.sourceStatistics();
+        top.reserve(sources.size());
 
-        for (const auto& [src, st] : report.sourceStatistics())
+        for (const auto& [src, st] : sources)
             top.emplace_back(src, st.totalEvents);
 
         std::sort(top.begin(), top.end(),
@@ -0,0 +1,66 @@
+#include "utils/ThreadPool.hpp"
+
+namespace LogTool
+{
+    namespace Utils
+    {
+        ThreadPool::ThreadPool(std::size_t threadCount)
+        {
+            const std::size_t n = resolveThreadCount(threadCount);
+            m_workers.reserve(n);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                m_workers.emplace_back([this]() { workerLoop(); });
+            }
+        }
+
+        ThreadPool::~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopping = true;
+            }
+            m_cv.notify_all();
+
+            // RAII: drain the queue and join every worker.
+            for (auto &t : m_workers)
+            {
+                if (t.joinable())
+                {
+                    t.join();
+                }
+            }
+        }
+
+        std::size_t ThreadPool::resolveThreadCount(std::size_t requested) noexcept
+        {
+            if (requested > 0)
+            {
+                return requested;
+            }
+            const unsigned hw = std::thread::hardware_concurrency();
+            return hw > 0 ? static_cast<std::size_t>(hw) : 1;
+        }
+
+        void ThreadPool::workerLoop()
+        {
+            for (;;)
+            {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_cv.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+                    if (m_tasks.empty())
+                    {
+                        // Only reachable when stopping and fully drained.
+                        return;
+                    }
+                    task = std::move(m_tasks.front());
+                    m_tasks.pop_front();
+                }
+                task();
+            }
+        }
+
+    } // namespace Utils
+} // namespace LogTool
@@ -1,5 +1,7 @@
 #include "utils/TimeUtils.hpp"
 
+#include <algorithm>
+#include <climits>
 #include <iomanip>
 #include <sstream>
 
@@ -53,20 +55,241 @@ namespace LogTool
 
         namespace
         {
-            // Small internal helper to convert a numeric substring to int.
-            // Throws std::invalid_argument on non-digits.
-            int parseIntField(std::string_view sv)
+            inline bool isDigit(char c) noexcept
             {
-                int value = 0;
-                for (char c : sv)
+                return c >= '0' && c <= '9';
+            }
+
+            inline int digits2(const char *p) noexcept
+            {
+                return (p[0] - '0') * 10 + (p[1] - '0');
+            }
+
+            /// Fields of a timestamp as written (before range validation).
+            struct CivilFields
+            {
+                int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+                std::int64_t nanos = 0;
+                bool hasZone = false;      // 'Z' or explicit offset present
+                int offsetSeconds = 0;     // east of UTC
+                bool yearless = false;     // syslog: year not written
+            };
+
+            // "HH:MM:SS" at p (8 chars available).
+            bool scanClock(const char *p, CivilFields &f) noexcept
+            {
+                if (!isDigit(p[0]) || !isDigit(p[1]) || p[2] != ':' ||
+                    !isDigit(p[3]) || !isDigit(p[4]) || p[5] != ':' ||
+                    !isDigit(p[6]) || !isDigit(p[7]))
+                {
+                    return false;
+                }
+                f.hour   = digits2(p);
+                f.minute = digits2(p + 3);
+                f.second = digits2(p + 6);
+                return true;
+            }
+
+            // ".fff" / ",fff" starting at s[n]; returns the new position.
+            std::size_t scanFraction(std::string_view s, std::size_t n, CivilFields &f) noexcept
+            {
+                if (n + 1 >= s.size() || (s[n] != '.' && s[n] != ',') || !isDigit(s[n + 1]))
+                {
+                    return n;
+                }
+                ++n;
+                std::int64_t scale = 100000000; // first digit = 10^8 ns
+                while (n < s.size() && isDigit(s[n]))
+                {
+                    f.nanos += (s[n] - '0') * scale;   // digits beyond ns precision add 0
+                    scale /= 10;
+                    ++n;
+                }
+                return n;
+            }
+
+            // "Z", "+hh:mm", "+hhmm" or "+hh" starting at s[n]; returns the new position.
+            std::size_t scanZone(std::string_view s, std::size_t n, CivilFields &f) noexcept
+            {
+                if (n >= s.size())
+                {
+                    return n;
+                }
+                if (s[n] == 'Z')
+                {
+                    f.hasZone = true;
+                    return n + 1;
+                }
+                if ((s[n] != '+' && s[n] != '-') || n + 2 >= s.size() ||
+                    !isDigit(s[n + 1]) || !isDigit(s[n + 2]))
+                {
+                    return n;
+                }
+                const int sign = s[n] == '-' ? -1 : 1;
+                const int hh = digits2(&s[n + 1]);
+                int mm = 0;
+                std::size_t end = n + 3;
+                if (end + 2 < s.size() && s[end] == ':' && isDigit(s[end + 1]) && isDigit(s[end + 2]))
+                {
+                    mm = digits2(&s[end + 1]);
+                    end += 3;
+                }
+                else if (end + 1 < s.size() && isDigit(s[end]) && isDigit(s[end + 1]))
+                {
+                    mm = digits2(&s[end]);
+                    end += 2;
+                }
+                if (hh > 23 || mm > 59)
+                {
+                    return n;
+                }
+                f.hasZone = true;
+                f.offsetSeconds = sign * (hh * 3600 + mm * 60);
+                return end;
+            }
+
+            int monthFromName(const char *p) noexcept
+            {
+                static const char kNames[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+                for (int m = 0; m < 12; ++m)
                 {
-                    if (c < '0' || c > '9')
+                    if (p[0] == kNames[m * 3] && p[1] == kNames[m * 3 + 1] && p[2] == kNames[m * 3 + 2])
                     {
-                        throw std::invalid_argument("Non-digit in numeric field");
+                        return m + 1;
                     }
+                }
+                return 0;
+            }
+
+            // Shape scan shared by timestampLength() and parseLogTimestamp().
+            std::size_t scanTimestamp(std::string_view s, CivilFields &f) noexcept
+            {
+                // "YYYY-MM-DD[ T]HH:MM:SS[.fff][zone]"
+                if (s.size() >= 19 && isDigit(s[0]))
+                {
+                    const char *p = s.data();
+                    if (!isDigit(p[1]) || !isDigit(p[2]) || !isDigit(p[3]) || p[4] != '-' ||
+                        !isDigit(p[5]) || !isDigit(p[6]) || p[7] != '-' ||
+                        !isDigit(p[8]) || !isDigit(p[9]) || (p[10] != ' ' && p[10] != 'T') ||
+                        !scanClock(p + 11, f))
+                    {
+                        return 0;
+                    }
+                    f.year  = digits2(p) * 100 + digits2(p + 2);
+                    f.month = digits2(p + 5);
+                    f.day   = digits2(p + 8);
+                    return scanZone(s, scanFraction(s, 19, f), f);
+                }
+
+                // Syslog "Mon dd HH:MM:SS"
+                if (s.size() >= 15 && s[3] == ' ' && s[6] == ' ')
+                {
+                    const char *p = s.data();
+                    const int month = monthFromName(p);
+                    if (month == 0 || (p[4] != ' ' && !isDigit(p[4])) || !isDigit(p[5]) || !scanClock(p + 7, f))
+                    {
+                        return 0;
+                    }
+                    f.month = month;
+                    f.day = (p[4] == ' ' ? 0 : (p[4] - '0') * 10) + (p[5] - '0');
+                    f.yearless = true;
+                    return scanFraction(s, 15, f);
+                }
+
+                return 0;
+            }
+
+            bool isLeapYear(int y) noexcept
+            {
+                return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+            }
+
+            int daysInMonth(int y, int m) noexcept
+            {
+                static const int kDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+                return (m == 2 && isLeapYear(y)) ? 29 : kDays[m - 1];
+            }
+
+            std::time_t mktimeLocal(int y, int mo, int d, int h, int mi, int s) noexcept
+            {
+                std::tm tm_buf{};
+                tm_buf.tm_isdst = -1; // let the C library figure out DST
+                tm_buf.tm_year  = y - 1900;
+                tm_buf.tm_mon   = mo - 1;
+                tm_buf.tm_mday  = d;
+                tm_buf.tm_hour  = h;
+                tm_buf.tm_min   = mi;
+                tm_buf.tm_sec   = s;
+                return std::mktime(&tm_buf);
+            }
+
+            // Local midnight of the most recently seen date, per thread. A day whose
+            // length is not 86400 s (DST switch) is marked non-uniform and falls back
+            // to std::mktime for every line.
+            struct LocalDayCache
+            {
+                std::int64_t dayNumber = INT64_MIN;
+                std::time_t  midnight  = 0;
+                bool         uniform   = false;
+            };
+            thread_local LocalDayCache t_localDay;
+
+            std::optional<std::time_t> localEpoch(const CivilFields &f) noexcept
+            {
+                const std::int64_t day = daysFromCivil(f.year, static_cast<unsigned>(f.month),
+                                                       static_cast<unsigned>(f.day));
+                LocalDayCache &cache = t_localDay;
+                if (cache.dayNumber != day)
+                {
+                    const std::time_t m0 = mktimeLocal(f.year, f.month, f.day, 0, 0, 0);
+                    const std::time_t m1 = mktimeLocal(f.year, f.month, f.day + 1, 0, 0, 0);
+                    cache.dayNumber = day;
+                    cache.midnight  = m0;
+                    cache.uniform   = m0 != static_cast<std::time_t>(-1) && m1 - m0 == 86400;
+                }
+
+                if (cache.uniform)
+                {
+                    return cache.midnight + f.hour * 3600 + f.minute * 60 + f.second;
+                }
+
+                const std::time_t t = mktimeLocal(f.year, f.month, f.day, f.hour, f.minute, f.second);
+                if (t == static_cast<std::time_t>(-1))
+                {
+                    return std::nullopt;
+                }
+                return t;
+            }
+
+            int currentLocalYear() noexcept
+            {
+                std::time_t t = std::time(nullptr);
+                std::tm tm_buf{};
+            #if defined(_WIN32)
+                localtime_s(&tm_buf, &t);
+            #else
+                localtime_r(&t, &tm_buf);
+            #endif
+                return tm_buf.tm_year + 1900;
+            }
+
+            std::optional<TimePoint> parseEpochDigits(std::string_view sv) noexcept
+            {
+                if (sv.size() > 18) // would overflow int64 milliseconds
+                {
+                    return std::nullopt;
+                }
+                std::int64_t value = 0;
+                for (char c : sv)
+                {
                     value = value * 10 + (c - '0');
                 }
-                return value;
+                // 12+ digits can only be milliseconds for any date after 1973.
+                if (sv.size() >= 12)
+                {
+                    return TimePoint(std::chrono::duration_cast<Clock::duration>(milliseconds(value)));
+                }
+                return TimePoint(std::chrono::duration_cast<Clock::duration>(seconds(value)));
             }
         } // anonymous namespace
 
@@ -77,38 +300,63 @@ namespace LogTool
             {
                 return std::nullopt;
             }
+            return parseLogTimestamp(sv.substr(0, 19));
+        }
 
-            std::tm tm_buf{};
-            tm_buf.tm_isdst = -1; // let the C library figure out DST
+        std::size_t timestampLength(std::string_view sv) noexcept
+        {
+            CivilFields f;
+            return scanTimestamp(sv, f);
+        }
 
-            try
+        std::optional<TimePoint> parseLogTimestamp(std::string_view sv) noexcept
+        {
+            if (sv.empty())
             {
-                const int year  = parseIntField(sv.substr(0, 4));
-                const int month = parseIntField(sv.substr(5, 2));
-                const int day   = parseIntField(sv.substr(8, 2));
-                const int hour  = parseIntField(sv.substr(11, 2));
-                const int min   = parseIntField(sv.substr(14, 2));
-                const int sec   = parseIntField(sv.substr(17, 2));
+                return std::nullopt;
+            }
 
-                tm_buf.tm_year = year - 1900;
-                tm_buf.tm_mon  = month - 1;
-                tm_buf.tm_mday = day;
-                tm_buf.tm_hour = hour;
-                tm_buf.tm_min  = min;
-                tm_buf.tm_sec  = sec;
+            if (std::all_of(sv.begin(), sv.end(), isDigit))
+            {
+                return parseEpochDigits(sv);
             }
-            catch (...)
+
+            CivilFields f;
+            if (scanTimestamp(sv, f) != sv.size())
             {
-                // Any parse error results in failure.
                 return std::nullopt;
             }
 
-            std::time_t t = std::mktime(&tm_buf);
-            if (t == static_cast<std::time_t>(-1))
+            if (f.yearless)
+            {
+                static thread_local const int year = currentLocalYear();
+                f.year = year;
+            }
+
+            if (f.month < 1 || f.month > 12 || f.day < 1 || f.day > daysInMonth(f.year, f.month) ||
+                f.hour > 23 || f.minute > 59 || f.second > 60)
             {
                 return std::nullopt;
             }
-            return from_time_t(t);
+
+            std::int64_t secs = 0;
+            if (f.hasZone)
+            {
+                secs = daysFromCivil(f.year, static_cast<unsigned>(f.month), static_cast<unsigned>(f.day)) * 86400 +
+                       f.hour * 3600 + f.minute * 60 + f.second - f.offsetSeconds;
+            }
+            else
+            {
+                const auto t = localEpoch(f);
+                if (!t)
+                {
+                    return std::nullopt;
+                }
+                secs = static_cast<std::int64_t>(*t);
+            }
+
+            return TimePoint(std::chrono::duration_cast<Clock::duration>(
+                seconds(secs) + std::chrono::nanoseconds(f.nanos)));
         }
 
         std::optional<TimePoint> parseUnixSeconds(std::string_view sv)